@@ -16,10 +16,11 @@ public class AnimeWorldRunner : ModuleRules
 			"UMG",
 			"RHI",
 			"RenderCore",
-			"ShaderCore"
+			"ShaderCore",
+			"Niagara"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] { "EngineSettings" });
 
 		// Optimize for size in shipping builds
 		OptimizeCode = CodeOptimization.InShippingBuildsOnly;
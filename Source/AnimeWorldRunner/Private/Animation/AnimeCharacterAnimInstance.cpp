@@ -1,4 +1,5 @@
 #include "Animation/AnimeCharacterAnimInstance.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "AnimeRunnerCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -73,6 +74,8 @@ void UAnimeCharacterAnimInstance::NativeInitializeAnimation()
 
 void UAnimeCharacterAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_AnimUpdate, AWRCharacterChannel, "UAnimeCharacterAnimInstance::NativeUpdateAnimation");
+    
     Super::NativeUpdateAnimation(DeltaTime);
     
     if (!AnimeCharacter) return;
@@ -1,4 +1,5 @@
 #include "AnimeRunnerCharacter.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InventoryComponent.h"
 #include "Effects/AnimeEffectsManager.h"
@@ -55,7 +56,7 @@ AAnimeRunnerCharacter::AAnimeRunnerCharacter()
     RunEffectComponent->SetupAttachment(RootComponent);
     RunEffectComponent->bAutoActivate = false;
     
-    // Create audio components
+    // Deprecated audio components, still created so existing Blueprint references resolve
     FootstepAudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("FootstepAudio"));
     FootstepAudioComponent->SetupAttachment(RootComponent);
     FootstepAudioComponent->bAutoActivate = false;
@@ -93,6 +94,7 @@ AAnimeRunnerCharacter::AAnimeRunnerCharacter()
     AttackCooldown = 1.0f;
     SpellPower = 100.0f;
     ManaCost = 25.0f;
+    AbilityEffects = { EAnimeEffectType::Attack, EAnimeEffectType::SpellCast, EAnimeEffectType::PowerUp, EAnimeEffectType::Glide, EAnimeEffectType::Climb };
     
     // Initialize state
     CurrentState = ECharacterState::Idle;
@@ -109,6 +111,9 @@ AAnimeRunnerCharacter::AAnimeRunnerCharacter()
     RightInputValue = 0.0f;
     LookUpInputValue = 0.0f;
     TurnInputValue = 0.0f;
+    
+    FootstepStride = 160.0f;
+    FootstepDistance = 0.0f;
 }
 
 void AAnimeRunnerCharacter::BeginPlay()
@@ -135,10 +140,17 @@ void AAnimeRunnerCharacter::BeginPlay()
     
     // Set initial movement speed
     GetCharacterMovement()->MaxWalkSpeed = CurrentSpeed;
+    
+    if (EffectsManager)
+    {
+        EffectsManager->SetCharacterEffects(AbilityEffects);
+    }
 }
 
 void AAnimeRunnerCharacter::Tick(float DeltaTime)
 {
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_CharacterTick, AWRCharacterChannel, "AAnimeRunnerCharacter::Tick");
+    
     Super::Tick(DeltaTime);
     
     // Handle 3D movement and abilities
@@ -551,34 +563,20 @@ void AAnimeRunnerCharacter::HandleVisualEffects()
 {
     if (!EffectsManager) return;
     
-    // Handle running effects
-    if (CurrentState == ECharacterState::Running && GetVelocity().Size() > 100.0f)
-    {
-        EffectsManager->PlayEffectAttached(EAnimeEffectType::Running, GetRootComponent());
-    }
-    else
-    {
-        EffectsManager->StopEffect(EAnimeEffectType::Running);
-    }
+    // Continuous effects only start or stop when the state changes
+    EffectsManager->SetContinuousEffect(EAnimeEffectType::Running,
+        CurrentState == ECharacterState::Running && GetVelocity().Size() > 100.0f, GetRootComponent());
+    EffectsManager->SetContinuousEffect(EAnimeEffectType::Glide, bIsGliding, GetRootComponent());
+    EffectsManager->SetContinuousEffect(EAnimeEffectType::Climb, bIsClimbing, GetRootComponent());
     
-    // Handle gliding effects
-    if (bIsGliding)
+    if (GetCharacterMovement()->IsMovingOnGround() && FootstepStride > 0.0f)
     {
-        EffectsManager->PlayEffectAttached(EAnimeEffectType::Glide, GetRootComponent());
-    }
-    else
-    {
-        EffectsManager->StopEffect(EAnimeEffectType::Glide);
-    }
-    
-    // Handle climbing effects
-    if (bIsClimbing)
-    {
-        EffectsManager->PlayEffectAttached(EAnimeEffectType::Climb, GetRootComponent());
-    }
-    else
-    {
-        EffectsManager->StopEffect(EAnimeEffectType::Climb);
+        FootstepDistance += GetVelocity().Size2D() * GetWorld()->GetDeltaSeconds();
+        if (FootstepDistance >= FootstepStride)
+        {
+            FootstepDistance = FMath::Fmod(FootstepDistance, FootstepStride);
+            EffectsManager->PlayEffect(EAnimeEffectType::Footstep, GetActorLocation() - FVector(0.0f, 0.0f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+        }
     }
     
     // Handle landing effects
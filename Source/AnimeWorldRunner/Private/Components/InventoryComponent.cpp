@@ -1,4 +1,6 @@
 #include "Components/InventoryComponent.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 
@@ -20,6 +22,9 @@ void UInventoryComponent::BeginPlay()
 
 void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    AWR_HITCH_SCOPE(Inventory);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_Inventory, AWRGameplayChannel, "UInventoryComponent::TickComponent");
+    
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
     // Update power-up timer
@@ -69,6 +74,9 @@ void UInventoryComponent::AddPowerUp(EPowerUpType Type, int32 Duration)
 
 void UInventoryComponent::UsePowerUp()
 {
+    AWR_HITCH_SCOPE(Inventory);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_Inventory, AWRGameplayChannel, "UInventoryComponent::UsePowerUp");
+    
     if (ActivePowerUp != EPowerUpType::NONE)
     {
         // Implement power-up effects based on type
@@ -94,6 +102,9 @@ void UInventoryComponent::UsePowerUp()
 
 void UInventoryComponent::AddItem(const FInventoryItem& Item)
 {
+    AWR_HITCH_SCOPE(Inventory);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_Inventory, AWRGameplayChannel, "UInventoryComponent::AddItem");
+    
     // Check if item already exists
     for (FInventoryItem& ExistingItem : Items)
     {
@@ -110,6 +121,9 @@ void UInventoryComponent::AddItem(const FInventoryItem& Item)
 
 bool UInventoryComponent::RemoveItem(const FName& ItemID, int32 Quantity)
 {
+    AWR_HITCH_SCOPE(Inventory);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_Inventory, AWRGameplayChannel, "UInventoryComponent::RemoveItem");
+    
     for (int32 i = 0; i < Items.Num(); i++)
     {
         if (Items[i].ItemID == ItemID)
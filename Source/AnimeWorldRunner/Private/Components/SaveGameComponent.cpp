@@ -1,4 +1,6 @@
 #include "Components/SaveGameComponent.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/Engine.h"
 
@@ -30,6 +32,9 @@ void USaveGameComponent::BeginPlay()
 
 bool USaveGameComponent::SaveGame()
 {
+    AWR_HITCH_SCOPE(Save);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_SaveGame, AWRGameplayChannel, "USaveGameComponent::SaveGame");
+    
     if (!SaveData)
     {
         return false;
@@ -40,6 +45,9 @@ bool USaveGameComponent::SaveGame()
 
 bool USaveGameComponent::LoadGame()
 {
+    AWR_HITCH_SCOPE(Save);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_SaveGame, AWRGameplayChannel, "USaveGameComponent::LoadGame");
+    
     if (UGameplayStatics::DoesSaveGameExist(SaveSlotName, UserIndex))
     {
         SaveData = Cast<UAnimeWorldRunnerSaveGame>(UGameplayStatics::LoadGameFromSlot(SaveSlotName, UserIndex));
@@ -1,11 +1,45 @@
 #include "Effects/AnimeEffectsManager.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
+#include "Optimization/SubsystemMemoryTracker.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "Components/SceneComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Components/AudioComponent.h"
+#include "NiagaraSystem.h"
+#include "NiagaraComponent.h"
 #include "Camera/CameraShakeBase.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
 #include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/AssetManager.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "Containers/Ticker.h"
+
+namespace EffectsSettings
+{
+    static TAutoConsoleVariable<int32> CVarPoolComponents(
+        TEXT("AWR.Effects.PoolComponents"),
+        1,
+        TEXT("Returns stopped effect components to a per-type pool instead of destroying them."));
+    
+    static TAutoConsoleVariable<int32> CVarSignificance(
+        TEXT("AWR.Effects.Significance"),
+        1,
+        TEXT("Reduces or suppresses effects by distance, screen size and view direction; 0 plays everything at full fidelity."));
+    
+    static TAutoConsoleVariable<int32> CVarBatchBursts(
+        TEXT("AWR.Effects.BatchBursts"),
+        1,
+        TEXT("Sends effects with a burst system through one batched system update per frame instead of a component each."));
+    
+    static const FName BurstPositionsParameter(TEXT("BurstPositions"));
+    static const FName BurstColorsParameter(TEXT("BurstColors"));
+    static const FName BurstCountParameter(TEXT("BurstCount"));
+}
 
 UAnimeEffectsManager::UAnimeEffectsManager()
 {
@@ -16,6 +50,54 @@ UAnimeEffectsManager::UAnimeEffectsManager()
     GlobalVolumeMultiplier = 1.0f;
     bEnableScreenEffects = true;
     bEnableCameraShake = true;
+    MaxConcurrentEffects = 16;
+    EffectBudgetScale = 1.0f;
+    MaxPooledComponentsPerType = 8;
+    MaxBurstSpawnsPerFrame = 64;
+    NumAudioVoicesCreated = 0;
+    
+    FAnimeSoundCategorySettings MovementSounds;
+    MovementSounds.MaxVoices = 2;
+    MovementSounds.MinRetriggerTime = 0.08f;
+    MovementSounds.MaxAudibleDistance = 2500.0f;
+    SoundCategories.Add(EAnimeSoundCategory::Movement, MovementSounds);
+    
+    FAnimeSoundCategorySettings AbilitySounds;
+    AbilitySounds.MaxVoices = 3;
+    SoundCategories.Add(EAnimeSoundCategory::Ability, AbilitySounds);
+    
+    FAnimeSoundCategorySettings PickupSounds;
+    PickupSounds.MaxVoices = 3;
+    PickupSounds.MinRetriggerTime = 0.06f;
+    PickupSounds.MaxAudibleDistance = 3000.0f;
+    SoundCategories.Add(EAnimeSoundCategory::Pickup, PickupSounds);
+    
+    FAnimeSoundCategorySettings ImpactSounds;
+    ImpactSounds.MaxVoices = 4;
+    ImpactSounds.MinRetriggerTime = 0.03f;
+    SoundCategories.Add(EAnimeSoundCategory::Impact, ImpactSounds);
+    
+    FAnimeSoundCategorySettings AmbientSounds;
+    AmbientSounds.MaxVoices = 2;
+    AmbientSounds.MaxAudibleDistance = 6000.0f;
+    SoundCategories.Add(EAnimeSoundCategory::Ambient, AmbientSounds);
+    NumComponentsCreated = 0;
+    NumAttachedPlays = 0;
+    NumSpawnsSkipped = 0;
+    NumBurstSpawnsDropped = 0;
+    NumSoundsRateLimited = 0;
+    NumSoundsVirtualized = 0;
+    NumVoicesStolen = 0;
+    NextInstanceId = 0;
+    DashTrailEndTime = 0.0f;
+    
+    SignificanceFullDistance = 2000.0f;
+    SignificanceSuppressDistance = 5000.0f;
+    MinEffectScreenSize = 0.01f;
+    ReducedRequiredSignificance = EParticleSignificanceLevel::Medium;
+    SignificanceDistanceScale = 1.0f;
+    
+    CurrentTheme = EEnvironmentTheme::Forest;
     
     // Create persistent effect components
     AuraEffectComponent = CreateDefaultSubobject<UParticleSystemComponent>(TEXT("AuraEffect"));
@@ -31,6 +113,10 @@ void UAnimeEffectsManager::BeginPlay()
     
     // Initialize effect data
     InitializeEffectData();
+    PrewarmAudioVoices();
+    
+    // Pools are prewarmed as each effect finishes loading
+    UpdatePreloadSet();
     
     // Setup persistent effects
     if (AuraEffectComponent)
@@ -44,16 +130,34 @@ void UAnimeEffectsManager::BeginPlay()
         TrailEffectComponent->AttachToComponent(GetOwner()->GetRootComponent(), 
             FAttachmentTransformRules::KeepRelativeTransform);
     }
-    
-    // Setup cleanup timer
-    GetWorld()->GetTimerManager().SetTimer(EffectCleanupTimer, this, 
-        &UAnimeEffectsManager::CleanupExpiredEffects, 1.0f, true);
 }
 
 void UAnimeEffectsManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    AWR_HITCH_SCOPE(Effects);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_EffectsTick, AWREffectsChannel, "UAnimeEffectsManager::TickComponent");
+    
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
+    ProcessExpiredEffects();
+    UpdateEffectSignificance();
+    UpdateSoundVoices();
+    FlushBurstSpawns();
+    
+#if STATS
+    int32 ActiveAudioCount = 0;
+    for (const auto& ListPair : ActiveEffects)
+    {
+        for (const FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            ActiveAudioCount += Instance.AudioComponent ? 1 : 0;
+        }
+    }
+    
+    INC_DWORD_STAT_BY(STAT_AWR_ActiveParticleComponents, GetActiveParticleCount());
+    INC_DWORD_STAT_BY(STAT_AWR_ActiveAudioComponents, ActiveAudioCount);
+#endif
+    
     // Update dynamic effects here if needed
 }
 
@@ -66,29 +170,43 @@ void UAnimeEffectsManager::InitializeEffectData()
     DashEffect.Duration = 0.5f;
     DashEffect.Scale = FVector(1.5f, 1.5f, 1.0f);
     DashEffect.Color = FLinearColor(0.0f, 0.8f, 1.0f, 1.0f); // Cyan
+    DashEffect.bAlwaysLoaded = true;
     DashEffect.bAttachToActor = true;
+    DashEffect.Priority = 1;
+    DashEffect.SoundCategory = EAnimeSoundCategory::Ability;
     EffectDataMap.Add(EAnimeEffectType::Dash, DashEffect);
     
     FAnimeEffectData JumpEffect;
     JumpEffect.Duration = 0.3f;
     JumpEffect.Scale = FVector(1.0f, 1.0f, 1.0f);
     JumpEffect.Color = FLinearColor(1.0f, 1.0f, 0.0f, 1.0f); // Yellow
+    JumpEffect.bAlwaysLoaded = true;
     JumpEffect.bAttachToActor = false;
+    JumpEffect.PrewarmCount = 1;
+    JumpEffect.MaxInstances = 2;
+    JumpEffect.SoundCategory = EAnimeSoundCategory::Movement;
     EffectDataMap.Add(EAnimeEffectType::Jump, JumpEffect);
     
     FAnimeEffectData LandingEffect;
     LandingEffect.Duration = 0.4f;
     LandingEffect.Scale = FVector(1.2f, 1.2f, 0.5f);
     LandingEffect.Color = FLinearColor(0.8f, 0.6f, 0.4f, 1.0f); // Dust color
+    LandingEffect.bAlwaysLoaded = true;
     LandingEffect.bAttachToActor = false;
+    LandingEffect.PrewarmCount = 1;
+    LandingEffect.MaxInstances = 2;
+    LandingEffect.SoundCategory = EAnimeSoundCategory::Movement;
     EffectDataMap.Add(EAnimeEffectType::Landing, LandingEffect);
     
     FAnimeEffectData RunningEffect;
     RunningEffect.Duration = -1.0f; // Continuous
     RunningEffect.Scale = FVector(0.8f, 0.8f, 0.8f);
     RunningEffect.Color = FLinearColor(0.9f, 0.9f, 0.9f, 0.5f);
+    RunningEffect.bAlwaysLoaded = true;
     RunningEffect.bAttachToActor = true;
     RunningEffect.AttachSocketName = FName("foot_l"); // Left foot socket
+    RunningEffect.PrewarmCount = 1;
+    RunningEffect.SoundCategory = EAnimeSoundCategory::Movement;
     EffectDataMap.Add(EAnimeEffectType::Running, RunningEffect);
     
     FAnimeEffectData AttackEffect;
@@ -97,6 +215,8 @@ void UAnimeEffectsManager::InitializeEffectData()
     AttackEffect.Color = FLinearColor(1.0f, 0.3f, 0.0f, 1.0f); // Orange-red
     AttackEffect.bAttachToActor = true;
     AttackEffect.AttachSocketName = FName("hand_r"); // Right hand socket
+    AttackEffect.Priority = 2;
+    AttackEffect.SoundCategory = EAnimeSoundCategory::Ability;
     EffectDataMap.Add(EAnimeEffectType::Attack, AttackEffect);
     
     FAnimeEffectData SpellCastEffect;
@@ -105,6 +225,8 @@ void UAnimeEffectsManager::InitializeEffectData()
     SpellCastEffect.Color = FLinearColor(0.5f, 0.0f, 1.0f, 1.0f); // Purple
     SpellCastEffect.bAttachToActor = true;
     SpellCastEffect.AttachSocketName = FName("hand_l"); // Left hand socket
+    SpellCastEffect.Priority = 2;
+    SpellCastEffect.SoundCategory = EAnimeSoundCategory::Ability;
     EffectDataMap.Add(EAnimeEffectType::SpellCast, SpellCastEffect);
     
     FAnimeEffectData PowerUpEffect;
@@ -112,13 +234,20 @@ void UAnimeEffectsManager::InitializeEffectData()
     PowerUpEffect.Scale = FVector(2.0f, 2.0f, 2.0f);
     PowerUpEffect.Color = FLinearColor(1.0f, 1.0f, 0.0f, 1.0f); // Gold
     PowerUpEffect.bAttachToActor = true;
+    PowerUpEffect.Priority = 3;
+    PowerUpEffect.SoundCategory = EAnimeSoundCategory::Ability;
     EffectDataMap.Add(EAnimeEffectType::PowerUp, PowerUpEffect);
     
     FAnimeEffectData CollectEffect;
     CollectEffect.Duration = 0.8f;
     CollectEffect.Scale = FVector(1.0f, 1.0f, 1.0f);
     CollectEffect.Color = FLinearColor(0.0f, 1.0f, 0.0f, 1.0f); // Green
+    CollectEffect.bAlwaysLoaded = true;
     CollectEffect.bAttachToActor = false;
+    CollectEffect.PrewarmCount = 4; // Coin lines play several in quick succession
+    CollectEffect.MaxInstances = 12;
+    CollectEffect.StealPolicy = EEffectStealPolicy::Oldest;
+    CollectEffect.SoundCategory = EAnimeSoundCategory::Pickup;
     EffectDataMap.Add(EAnimeEffectType::Collect, CollectEffect);
     
     FAnimeEffectData GlideEffect;
@@ -126,6 +255,7 @@ void UAnimeEffectsManager::InitializeEffectData()
     GlideEffect.Scale = FVector(1.8f, 1.8f, 1.0f);
     GlideEffect.Color = FLinearColor(0.7f, 0.9f, 1.0f, 0.8f); // Light blue
     GlideEffect.bAttachToActor = true;
+    GlideEffect.SoundCategory = EAnimeSoundCategory::Ambient;
     EffectDataMap.Add(EAnimeEffectType::Glide, GlideEffect);
     
     FAnimeEffectData ClimbEffect;
@@ -133,57 +263,124 @@ void UAnimeEffectsManager::InitializeEffectData()
     ClimbEffect.Scale = FVector(0.6f, 0.6f, 0.6f);
     ClimbEffect.Color = FLinearColor(0.8f, 0.8f, 0.6f, 0.7f); // Dusty yellow
     ClimbEffect.bAttachToActor = true;
+    ClimbEffect.SoundCategory = EAnimeSoundCategory::Ambient;
     EffectDataMap.Add(EAnimeEffectType::Climb, ClimbEffect);
+    
+    // Sound only; the character plays it every stride
+    FAnimeEffectData FootstepEffect;
+    FootstepEffect.Duration = 0.3f;
+    FootstepEffect.SoundCategory = EAnimeSoundCategory::Movement;
+    FootstepEffect.bAlwaysLoaded = true;
+    FootstepEffect.bAttachToActor = false;
+    FootstepEffect.MaxInstances = 2;
+    EffectDataMap.Add(EAnimeEffectType::Footstep, FootstepEffect);
+    
+    // Hazard effects only appear in some themes; keep any sets assigned in Blueprint
+    if (ThemeEffects.Num() == 0)
+    {
+        FAnimeEffectTypeSet MountainEffects;
+        MountainEffects.EffectTypes = { EAnimeEffectType::Hit, EAnimeEffectType::Explosion };
+        ThemeEffects.Add(EEnvironmentTheme::Mountain, MountainEffects);
+        
+        FAnimeEffectTypeSet RuinsEffects;
+        RuinsEffects.EffectTypes = { EAnimeEffectType::Hit, EAnimeEffectType::Shield };
+        ThemeEffects.Add(EEnvironmentTheme::Ruins, RuinsEffects);
+        
+        FAnimeEffectTypeSet VillageEffects;
+        VillageEffects.EffectTypes = { EAnimeEffectType::Heal };
+        ThemeEffects.Add(EEnvironmentTheme::Village, VillageEffects);
+    }
 }
 
 void UAnimeEffectsManager::PlayEffect(EAnimeEffectType EffectType, FVector Location, FRotator Rotation)
 {
+    PlayEffectTinted(EffectType, Location, Rotation, nullptr);
+}
+
+void UAnimeEffectsManager::PlayEffectTinted(EAnimeEffectType EffectType, const FVector& Location, const FRotator& Rotation, const FLinearColor* ColorOverride)
+{
+    AWR_HITCH_SCOPE(Effects);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_PlayEffect, AWREffectsChannel, "UAnimeEffectsManager::PlayEffect");
+    AWR_LLM_SCOPE(Effects);
+    
     if (EffectType == EAnimeEffectType::None) return;
     
     FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
     if (!EffectData) return;
     
-    // Stop existing effect of same type
-    StopEffect(EffectType);
+    // Never block on a load; play what is resident and stream in the rest for next time
+    if (!IsEffectLoaded(EffectType))
+    {
+        RequestEffectLoad(EffectType);
+    }
+    
+    const FLinearColor& Color = ColorOverride ? *ColorOverride : EffectData->Color;
+    
+    // Burst effects only need an instance for their sound
+    const bool bBurstQueued = QueueBurstSpawn(EffectType, *EffectData, Location, Color);
+    if (bBurstQueued && !EffectData->SoundEffect.Get()) return;
+    
+    // Makes room under the instance cap and the global budget, or skips the effect; a queued burst
+    // only needs the instance for its sound and takes no particle budget from other effects
+    bool bParticleBudget = false;
+    FActiveEffectInstance* Instance = AddEffectInstance(EffectType, *EffectData, Location, !bBurstQueued, bParticleBudget);
+    if (!Instance) return;
+    
+    const uint32 InstanceId = Instance->InstanceId;
+    
+    // One-shot effects that would start suppressed (behind the camera, too far or too small) never spawn particles
+    FVector ViewLocation;
+    FVector ViewDirection;
+    float TanHalfFOV;
+    if (bParticleBudget && EffectData->Duration > 0.0f && EffectsSettings::CVarSignificance.GetValueOnGameThread()
+        && GetViewPoint(ViewLocation, ViewDirection, TanHalfFOV))
+    {
+        const float Radius = 100.0f * EffectData->Scale.GetMax() * GlobalEffectScale * EffectBudgetScale;
+        Instance->Significance = EvaluateSignificance(Location, Radius, ViewLocation, ViewDirection, TanHalfFOV);
+        if (Instance->Significance == EEffectSignificance::Suppressed)
+        {
+            bParticleBudget = false;
+            NumSpawnsSkipped++;
+        }
+    }
     
     // Play particle effect
-    if (EffectData->ParticleEffect)
+    if (bParticleBudget)
     {
-        UParticleSystemComponent* ParticleComp = CreateParticleComponent(EffectData->ParticleEffect);
+        UParticleSystemComponent* ParticleComp = AcquireParticleComponent(EffectType, EffectData->ParticleEffect.Get());
         if (ParticleComp)
         {
             ParticleComp->SetWorldLocationAndRotation(Location, Rotation);
-            ParticleComp->SetWorldScale3D(EffectData->Scale * GlobalEffectScale);
+            ParticleComp->SetWorldScale3D(EffectData->Scale * GlobalEffectScale * EffectBudgetScale);
             
             // Set color parameter if supported
-            ParticleComp->SetColorParameter(FName("Color"), EffectData->Color);
+            ParticleComp->SetColorParameter(FName("Color"), Color);
             
-            ParticleComp->Activate();
-            ActiveParticleEffects.Add(EffectType, ParticleComp);
+            ParticleComp->SetRequiredSignificance(
+                Instance->Significance == EEffectSignificance::Reduced ? ReducedRequiredSignificance : EParticleSignificanceLevel::Low);
             
-            // Auto-destroy after duration (if not continuous)
+            // Reset so a pooled component starts the effect from the beginning
+            ParticleComp->Activate(true);
+            Instance->ParticleComponent = ParticleComp;
+            
+            // Release after duration (if not continuous)
             if (EffectData->Duration > 0.0f)
             {
-                FTimerHandle DestroyTimer;
-                GetWorld()->GetTimerManager().SetTimer(DestroyTimer, [this, EffectType]()
-                {
-                    StopEffect(EffectType);
-                }, EffectData->Duration, false);
+                Instance->ParticleEndTime = Instance->StartTime + EffectData->Duration;
+                ScheduleExpiry(Instance->ParticleEndTime, EffectType, InstanceId);
             }
         }
     }
     
     // Play sound effect
-    if (EffectData->SoundEffect)
+    if (USoundCue* SoundCue = EffectData->SoundEffect.Get())
     {
-        UAudioComponent* AudioComp = CreateAudioComponent(EffectData->SoundEffect);
-        if (AudioComp)
-        {
-            AudioComp->SetWorldLocation(Location);
-            AudioComp->SetVolumeMultiplier(GlobalVolumeMultiplier);
-            AudioComp->Play();
-            ActiveAudioEffects.Add(EffectType, AudioComp);
-        }
+        StartSoundVoice(*Instance, EffectType, SoundCue, Location);
+    }
+    
+    if (!Instance->ParticleComponent && !Instance->AudioComponent && !Instance->bSoundVirtual)
+    {
+        StopEffectInstanceById(EffectType, InstanceId);
     }
 }
 
@@ -192,93 +389,182 @@ void UAnimeEffectsManager::PlayEffectAtLocation(EAnimeEffectType EffectType, FVe
     PlayEffect(EffectType, Location, Rotation);
 }
 
+void UAnimeEffectsManager::PlayBurstEffect(EAnimeEffectType EffectType, FVector Location, FLinearColor Color)
+{
+    PlayEffectTinted(EffectType, Location, FRotator::ZeroRotator, &Color);
+}
+
+bool UAnimeEffectsManager::QueueBurstSpawn(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData, const FVector& Location, const FLinearColor& Color)
+{
+    if (!EffectsSettings::CVarBatchBursts.GetValueOnGameThread()) return false;
+    
+    FAnimeBurstBatch* Batch = BurstBatches.Find(EffectType);
+    if (!Batch || !IsValid(Batch->Component)) return false;
+    
+    FVector ViewLocation;
+    FVector ViewDirection;
+    float TanHalfFOV;
+    if (EffectsSettings::CVarSignificance.GetValueOnGameThread() && GetViewPoint(ViewLocation, ViewDirection, TanHalfFOV))
+    {
+        const float Radius = 100.0f * EffectData.Scale.GetMax() * GlobalEffectScale * EffectBudgetScale;
+        if (EvaluateSignificance(Location, Radius, ViewLocation, ViewDirection, TanHalfFOV) == EEffectSignificance::Suppressed)
+        {
+            NumSpawnsSkipped++;
+            return true;
+        }
+    }
+    
+    if (Batch->Positions.Num() >= MaxBurstSpawnsPerFrame)
+    {
+        NumBurstSpawnsDropped++;
+        return true;
+    }
+    
+    Batch->Positions.Add(Location);
+    Batch->Colors.Add(Color);
+    return true;
+}
+
+int32 UAnimeEffectsManager::GetNumQueuedBurstSpawns(EAnimeEffectType EffectType) const
+{
+    const FAnimeBurstBatch* Batch = BurstBatches.Find(EffectType);
+    return Batch ? Batch->Positions.Num() : 0;
+}
+
+void UAnimeEffectsManager::FlushBurstSpawns()
+{
+    for (auto& BatchPair : BurstBatches)
+    {
+        FAnimeBurstBatch& Batch = BatchPair.Value;
+        const int32 NumSpawns = Batch.Positions.Num();
+        if (!IsValid(Batch.Component) || (NumSpawns == 0 && !Batch.bNeedsClear)) continue;
+        
+        // One parameter upload per system per frame however many pickups queued; an empty upload stops the spawning again
+        UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayPosition(Batch.Component, EffectsSettings::BurstPositionsParameter, Batch.Positions);
+        UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayColor(Batch.Component, EffectsSettings::BurstColorsParameter, Batch.Colors);
+        Batch.Component->SetVariableInt(EffectsSettings::BurstCountParameter, NumSpawns);
+        
+        INC_DWORD_STAT_BY(STAT_AWR_BurstSpawns, NumSpawns);
+        
+        Batch.Positions.Reset();
+        Batch.Colors.Reset();
+        Batch.bNeedsClear = NumSpawns > 0;
+    }
+}
+
 void UAnimeEffectsManager::PlayEffectAttached(EAnimeEffectType EffectType, USceneComponent* AttachComponent, FName SocketName)
 {
+    AWR_HITCH_SCOPE(Effects);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_PlayEffect, AWREffectsChannel, "UAnimeEffectsManager::PlayEffectAttached");
+    AWR_LLM_SCOPE(Effects);
+    
     if (EffectType == EAnimeEffectType::None || !AttachComponent) return;
     
     FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
     if (!EffectData) return;
     
-    // Stop existing effect of same type
-    StopEffect(EffectType);
+    // Continuous effects switched on before their template loaded are started by OnEffectLoaded
+    if (!EffectData->ParticleEffect.Get())
+    {
+        RequestEffectLoad(EffectType);
+        return;
+    }
+    
+    // With the default single instance this replaces the previous play of the same type
+    bool bParticleBudget = false;
+    FActiveEffectInstance* Instance = AddEffectInstance(EffectType, *EffectData, AttachComponent->GetComponentLocation(), true, bParticleBudget);
+    if (!Instance) return;
+    
+    const uint32 InstanceId = Instance->InstanceId;
     
     // Play particle effect
-    if (EffectData->ParticleEffect)
+    UParticleSystemComponent* ParticleComp = bParticleBudget ? AcquireParticleComponent(EffectType, EffectData->ParticleEffect.Get()) : nullptr;
+    if (!ParticleComp)
     {
-        UParticleSystemComponent* ParticleComp = CreateParticleComponent(EffectData->ParticleEffect);
-        if (ParticleComp)
-        {
-            FName AttachSocket = (SocketName != NAME_None) ? SocketName : EffectData->AttachSocketName;
-            ParticleComp->AttachToComponent(AttachComponent, 
-                FAttachmentTransformRules::KeepRelativeTransform, AttachSocket);
-            
-            ParticleComp->SetRelativeScale3D(EffectData->Scale * GlobalEffectScale);
-            ParticleComp->SetColorParameter(FName("Color"), EffectData->Color);
-            ParticleComp->Activate();
-            
-            ActiveParticleEffects.Add(EffectType, ParticleComp);
-            
-            // Auto-destroy after duration (if not continuous)
-            if (EffectData->Duration > 0.0f)
-            {
-                FTimerHandle DestroyTimer;
-                GetWorld()->GetTimerManager().SetTimer(DestroyTimer, [this, EffectType]()
-                {
-                    StopEffect(EffectType);
-                }, EffectData->Duration, false);
-            }
-        }
+        StopEffectInstanceById(EffectType, InstanceId);
+        return;
+    }
+    
+    FName AttachSocket = (SocketName != NAME_None) ? SocketName : EffectData->AttachSocketName;
+    ParticleComp->AttachToComponent(AttachComponent, 
+        FAttachmentTransformRules::KeepRelativeTransform, AttachSocket);
+    
+    ParticleComp->SetRelativeScale3D(EffectData->Scale * GlobalEffectScale * EffectBudgetScale);
+    ParticleComp->SetColorParameter(FName("Color"), EffectData->Color);
+    ParticleComp->Activate(true);
+    NumAttachedPlays++;
+    
+    Instance->ParticleComponent = ParticleComp;
+    
+    // Release after duration (if not continuous)
+    if (EffectData->Duration > 0.0f)
+    {
+        Instance->ParticleEndTime = Instance->StartTime + EffectData->Duration;
+        ScheduleExpiry(Instance->ParticleEndTime, EffectType, InstanceId);
     }
 }
 
 void UAnimeEffectsManager::StopEffect(EAnimeEffectType EffectType)
 {
-    // Stop particle effect
-    if (UParticleSystemComponent** ParticleComp = ActiveParticleEffects.Find(EffectType))
+    ActiveContinuousEffects.Remove(EffectType);
+    PendingContinuousEffects.Remove(EffectType);
+    
+    FActiveEffectInstanceList StoppedList;
+    if (ActiveEffects.RemoveAndCopyValue(EffectType, StoppedList))
     {
-        if (*ParticleComp && IsValid(*ParticleComp))
+        for (const FActiveEffectInstance& Instance : StoppedList.Instances)
         {
-            (*ParticleComp)->Deactivate();
-            (*ParticleComp)->DestroyComponent();
+            ReleaseParticleComponent(EffectType, Instance.ParticleComponent);
+            ReleaseAudioVoice(Instance.AudioComponent);
         }
-        ActiveParticleEffects.Remove(EffectType);
     }
+}
+
+void UAnimeEffectsManager::StopAllEffects()
+{
+    ActiveContinuousEffects.Empty();
+    PendingContinuousEffects.Empty();
     
-    // Stop audio effect
-    if (UAudioComponent** AudioComp = ActiveAudioEffects.Find(EffectType))
+    TMap<EAnimeEffectType, FActiveEffectInstanceList> StoppedEffects = MoveTemp(ActiveEffects);
+    ActiveEffects.Reset();
+    
+    for (const auto& ListPair : StoppedEffects)
     {
-        if (*AudioComp && IsValid(*AudioComp))
+        for (const FActiveEffectInstance& Instance : ListPair.Value.Instances)
         {
-            (*AudioComp)->Stop();
-            (*AudioComp)->DestroyComponent();
+            ReleaseParticleComponent(ListPair.Key, Instance.ParticleComponent);
+            ReleaseAudioVoice(Instance.AudioComponent);
         }
-        ActiveAudioEffects.Remove(EffectType);
     }
 }
 
-void UAnimeEffectsManager::StopAllEffects()
+void UAnimeEffectsManager::SetContinuousEffect(EAnimeEffectType EffectType, bool bActive, USceneComponent* AttachComponent)
 {
-    // Stop all particle effects
-    for (auto& EffectPair : ActiveParticleEffects)
+    if (!bActive)
     {
-        if (EffectPair.Value && IsValid(EffectPair.Value))
-        {
-            EffectPair.Value->Deactivate();
-            EffectPair.Value->DestroyComponent();
-        }
+        PendingContinuousEffects.Remove(EffectType);
     }
-    ActiveParticleEffects.Empty();
     
-    // Stop all audio effects
-    for (auto& EffectPair : ActiveAudioEffects)
+    if (bActive == ActiveContinuousEffects.Contains(EffectType)) return;
+    
+    if (bActive)
     {
-        if (EffectPair.Value && IsValid(EffectPair.Value))
+        // Nothing is marked when no instance started (template loading, no budget), so the next call tries again
+        PlayEffectAttached(EffectType, AttachComponent ? AttachComponent : GetOwner()->GetRootComponent());
+        if (GetActiveInstanceCount(EffectType) > 0)
+        {
+            ActiveContinuousEffects.Add(EffectType);
+            PendingContinuousEffects.Remove(EffectType);
+        }
+        else if (!IsEffectLoaded(EffectType))
         {
-            EffectPair.Value->Stop();
-            EffectPair.Value->DestroyComponent();
+            PendingContinuousEffects.Add(EffectType);
         }
     }
-    ActiveAudioEffects.Empty();
+    else
+    {
+        StopEffect(EffectType);
+    }
 }
 
 void UAnimeEffectsManager::PlayDashTrail(FVector StartLocation, FVector EndLocation)
@@ -293,15 +579,9 @@ void UAnimeEffectsManager::PlayDashTrail(FVector StartLocation, FVector EndLocat
         
         TrailEffectComponent->Activate();
         
-        // Deactivate after short duration
-        FTimerHandle TrailTimer;
-        GetWorld()->GetTimerManager().SetTimer(TrailTimer, [this]()
-        {
-            if (TrailEffectComponent)
-            {
-                TrailEffectComponent->Deactivate();
-            }
-        }, 1.0f, false);
+        // Deactivate after short duration; a newer dash pushes the end time back
+        DashTrailEndTime = GetWorld()->GetTimeSeconds() + 1.0f;
+        ScheduleExpiry(DashTrailEndTime, EAnimeEffectType::Dash, DashTrailInstanceId);
     }
 }
 
@@ -384,38 +664,334 @@ void UAnimeEffectsManager::PlayCameraShake(float Intensity, float Duration)
     }
 }
 
-void UAnimeEffectsManager::CleanupExpiredEffects()
+void UAnimeEffectsManager::ScheduleExpiry(float ExpiryTime, EAnimeEffectType EffectType, uint32 InstanceId)
+{
+    FEffectExpiry Expiry;
+    Expiry.ExpiryTime = ExpiryTime;
+    Expiry.EffectType = EffectType;
+    Expiry.InstanceId = InstanceId;
+    ExpiryHeap.HeapPush(Expiry);
+}
+
+void UAnimeEffectsManager::ProcessExpiredEffects()
+{
+    const float Now = GetWorld()->GetTimeSeconds();
+    
+    while (ExpiryHeap.Num() > 0 && ExpiryHeap.HeapTop().ExpiryTime <= Now)
+    {
+        FEffectExpiry Expiry;
+        ExpiryHeap.HeapPop(Expiry, false);
+        ExpireEffectInstance(Expiry.EffectType, Expiry.InstanceId, Now);
+    }
+}
+
+void UAnimeEffectsManager::ExpireEffectInstance(EAnimeEffectType EffectType, uint32 InstanceId, float Now)
+{
+    if (InstanceId == DashTrailInstanceId)
+    {
+        if (TrailEffectComponent && Now >= DashTrailEndTime)
+        {
+            TrailEffectComponent->Deactivate();
+        }
+        return;
+    }
+    
+    // Instances are looked up by id, so entries for stopped or stolen instances do nothing
+    FActiveEffectInstanceList* List = ActiveEffects.Find(EffectType);
+    if (!List) return;
+    
+    const int32 InstanceIndex = List->Instances.IndexOfByPredicate([InstanceId](const FActiveEffectInstance& Instance)
+    {
+        return Instance.InstanceId == InstanceId;
+    });
+    if (InstanceIndex == INDEX_NONE) return;
+    
+    FActiveEffectInstance& Instance = List->Instances[InstanceIndex];
+    if (Instance.ParticleComponent && Instance.ParticleEndTime > 0.0f && Instance.ParticleEndTime <= Now)
+    {
+        ReleaseParticleComponent(EffectType, Instance.ParticleComponent);
+        Instance.ParticleComponent = nullptr;
+    }
+    
+    if (Instance.AudioComponent && Instance.AudioEndTime > 0.0f && Instance.AudioEndTime <= Now)
+    {
+        ReleaseAudioVoice(Instance.AudioComponent);
+        Instance.AudioComponent = nullptr;
+    }
+    
+    if (!Instance.ParticleComponent && !Instance.AudioComponent && !Instance.bSoundVirtual)
+    {
+        List->Instances.RemoveAtSwap(InstanceIndex, 1, false);
+        if (List->Instances.Num() == 0)
+        {
+            ActiveContinuousEffects.Remove(EffectType);
+        }
+    }
+}
+
+bool UAnimeEffectsManager::HasEffectBudget(EAnimeEffectType EffectType) const
 {
-    // Remove any invalid components
-    TArray<EAnimeEffectType> EffectsToRemove;
+    // Continuous effects are never skipped, they are what the player reads movement from
+    const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+    if (EffectData && EffectData->Duration <= 0.0f)
+    {
+        return true;
+    }
     
-    for (auto& EffectPair : ActiveParticleEffects)
+    return GetActiveParticleCount() < MaxConcurrentEffects;
+}
+
+int32 UAnimeEffectsManager::GetActiveParticleCount() const
+{
+    int32 ParticleCount = 0;
+    for (const auto& ListPair : ActiveEffects)
+    {
+        for (const FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            ParticleCount += Instance.ParticleComponent ? 1 : 0;
+        }
+    }
+    return ParticleCount;
+}
+
+int32 UAnimeEffectsManager::GetActiveEffectCount() const
+{
+    int32 InstanceCount = 0;
+    for (const auto& ListPair : ActiveEffects)
+    {
+        InstanceCount += ListPair.Value.Instances.Num();
+    }
+    return InstanceCount;
+}
+
+int32 UAnimeEffectsManager::GetActiveInstanceCount(EAnimeEffectType EffectType) const
+{
+    const FActiveEffectInstanceList* List = ActiveEffects.Find(EffectType);
+    return List ? List->Instances.Num() : 0;
+}
+
+FActiveEffectInstance* UAnimeEffectsManager::AddEffectInstance(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData, const FVector& Location, bool bNeedsParticle, bool& bOutParticleBudget)
+{
+    // Voice cap of this effect type
+    const int32 MaxInstances = FMath::Max(EffectData.MaxInstances, 1);
+    while (GetActiveInstanceCount(EffectType) >= MaxInstances)
     {
-        if (!IsValid(EffectPair.Value) || !EffectPair.Value->IsActive())
+        if (!StealEffectInstance(EffectData.StealPolicy, MAX_int32, &EffectType, false))
         {
-            EffectsToRemove.Add(EffectPair.Key);
+            return nullptr;
         }
     }
     
-    for (EAnimeEffectType EffectType : EffectsToRemove)
+    // Global particle budget; only effects of equal or lower priority give way
+    bOutParticleBudget = bNeedsParticle && EffectData.ParticleEffect.Get() != nullptr;
+    if (bOutParticleBudget && !HasEffectBudget(EffectType))
     {
-        ActiveParticleEffects.Remove(EffectType);
+        bOutParticleBudget = StealEffectInstance(EffectData.StealPolicy, EffectData.Priority, nullptr, true);
     }
     
-    EffectsToRemove.Empty();
+    FActiveEffectInstance& Instance = ActiveEffects.FindOrAdd(EffectType).Instances.AddDefaulted_GetRef();
+    Instance.InstanceId = ++NextInstanceId;
+    Instance.StartTime = GetWorld()->GetTimeSeconds();
+    Instance.Priority = EffectData.Priority;
+    
+    return &Instance;
+}
+
+bool UAnimeEffectsManager::StealEffectInstance(EEffectStealPolicy Policy, int32 MaxPriority, const EAnimeEffectType* OnlyType, bool bNeedsParticle)
+{
+    if (Policy == EEffectStealPolicy::DontSteal) return false;
+    
+    const FVector ViewLocation = (Policy == EEffectStealPolicy::Farthest) ? GetViewLocation() : FVector::ZeroVector;
+    
+    EAnimeEffectType VictimType = EAnimeEffectType::None;
+    int32 VictimIndex = INDEX_NONE;
+    double VictimScore = 0.0;
     
-    for (auto& EffectPair : ActiveAudioEffects)
+    for (const auto& ListPair : ActiveEffects)
     {
-        if (!IsValid(EffectPair.Value) || !EffectPair.Value->IsPlaying())
+        if (OnlyType && ListPair.Key != *OnlyType) continue;
+        
+        // Other effects never take the place of a continuous one
+        const FAnimeEffectData* EffectData = EffectDataMap.Find(ListPair.Key);
+        if (!OnlyType && EffectData && EffectData->Duration <= 0.0f) continue;
+        
+        const TArray<FActiveEffectInstance>& Instances = ListPair.Value.Instances;
+        for (int32 i = 0; i < Instances.Num(); i++)
         {
-            EffectsToRemove.Add(EffectPair.Key);
+            const FActiveEffectInstance& Instance = Instances[i];
+            if (Instance.Priority > MaxPriority || (bNeedsParticle && !Instance.ParticleComponent)) continue;
+            
+            // Higher score gives way first
+            double Score = -Instance.StartTime;
+            if (Policy == EEffectStealPolicy::Farthest)
+            {
+                const USceneComponent* Component = Instance.ParticleComponent ? (USceneComponent*)Instance.ParticleComponent : (USceneComponent*)Instance.AudioComponent;
+                Score = IsValid(Component) ? FVector::DistSquared(Component->GetComponentLocation(), ViewLocation) : MAX_dbl;
+            }
+            else if (Policy == EEffectStealPolicy::LowestPriority)
+            {
+                Score = -Instance.Priority * 1.0e6 - Instance.StartTime;
+            }
+            
+            if (VictimIndex == INDEX_NONE || Score > VictimScore)
+            {
+                VictimType = ListPair.Key;
+                VictimIndex = i;
+                VictimScore = Score;
+            }
         }
     }
     
-    for (EAnimeEffectType EffectType : EffectsToRemove)
+    if (VictimIndex == INDEX_NONE) return false;
+    
+    StopEffectInstance(VictimType, VictimIndex);
+    return true;
+}
+
+void UAnimeEffectsManager::StopEffectInstance(EAnimeEffectType EffectType, int32 InstanceIndex)
+{
+    FActiveEffectInstanceList* List = ActiveEffects.Find(EffectType);
+    if (!List || !List->Instances.IsValidIndex(InstanceIndex)) return;
+    
+    const FActiveEffectInstance Instance = List->Instances[InstanceIndex];
+    List->Instances.RemoveAtSwap(InstanceIndex, 1, false);
+    
+    // A stolen continuous effect is off until SetContinuousEffect starts it again
+    if (List->Instances.Num() == 0)
+    {
+        ActiveContinuousEffects.Remove(EffectType);
+    }
+    
+    ReleaseParticleComponent(EffectType, Instance.ParticleComponent);
+    ReleaseAudioVoice(Instance.AudioComponent);
+}
+
+void UAnimeEffectsManager::StopEffectInstanceById(EAnimeEffectType EffectType, uint32 InstanceId)
+{
+    if (FActiveEffectInstanceList* List = ActiveEffects.Find(EffectType))
+    {
+        const int32 InstanceIndex = List->Instances.IndexOfByPredicate([InstanceId](const FActiveEffectInstance& Instance)
+        {
+            return Instance.InstanceId == InstanceId;
+        });
+        StopEffectInstance(EffectType, InstanceIndex);
+    }
+}
+
+FVector UAnimeEffectsManager::GetViewLocation() const
+{
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (PC && PC->PlayerCameraManager)
+    {
+        return PC->PlayerCameraManager->GetCameraLocation();
+    }
+    
+    return GetOwner()->GetActorLocation();
+}
+
+bool UAnimeEffectsManager::GetViewPoint(FVector& OutLocation, FVector& OutDirection, float& OutTanHalfFOV) const
+{
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (!PC || !PC->PlayerCameraManager)
+    {
+        return false;
+    }
+    
+    OutLocation = PC->PlayerCameraManager->GetCameraLocation();
+    OutDirection = PC->PlayerCameraManager->GetCameraRotation().Vector();
+    OutTanHalfFOV = FMath::Tan(FMath::DegreesToRadians(PC->PlayerCameraManager->GetFOVAngle() * 0.5f));
+    return true;
+}
+
+EEffectSignificance UAnimeEffectsManager::EvaluateSignificance(const FVector& Location, float Radius, const FVector& ViewLocation, const FVector& ViewDirection, float TanHalfFOV) const
+{
+    const FVector ToEffect = Location - ViewLocation;
+    
+    // Entirely behind the camera
+    if ((ToEffect | ViewDirection) < -Radius)
+    {
+        return EEffectSignificance::Suppressed;
+    }
+    
+    const float Distance = ToEffect.Size();
+    if (Distance > SignificanceSuppressDistance * SignificanceDistanceScale)
+    {
+        return EEffectSignificance::Suppressed;
+    }
+    
+    const float ScreenSize = Radius / FMath::Max(Distance * TanHalfFOV, 1.0f);
+    if (ScreenSize < MinEffectScreenSize)
+    {
+        return EEffectSignificance::Suppressed;
+    }
+    
+    if (Distance > SignificanceFullDistance * SignificanceDistanceScale)
+    {
+        return EEffectSignificance::Reduced;
+    }
+    
+    return EEffectSignificance::Full;
+}
+
+void UAnimeEffectsManager::UpdateEffectSignificance()
+{
+    const bool bEnabled = EffectsSettings::CVarSignificance.GetValueOnGameThread() != 0;
+    
+    FVector ViewLocation;
+    FVector ViewDirection;
+    float TanHalfFOV = 1.0f;
+    const bool bHasView = GetViewPoint(ViewLocation, ViewDirection, TanHalfFOV);
+    
+    int32 TierCounts[3] = { 0, 0, 0 };
+    
+    for (auto& ListPair : ActiveEffects)
     {
-        ActiveAudioEffects.Remove(EffectType);
+        for (FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            UParticleSystemComponent* ParticleComp = Instance.ParticleComponent;
+            if (!IsValid(ParticleComp)) continue;
+            
+            EEffectSignificance Significance = EEffectSignificance::Full;
+            if (bEnabled && bHasView)
+            {
+                const float Radius = ParticleComp->Bounds.SphereRadius > 0.0f ? ParticleComp->Bounds.SphereRadius : 100.0f * ParticleComp->GetComponentScale().GetMax();
+                Significance = EvaluateSignificance(ParticleComp->GetComponentLocation(), Radius, ViewLocation, ViewDirection, TanHalfFOV);
+            }
+            
+            ApplySignificance(Instance, Significance);
+            TierCounts[(int32)Significance]++;
+        }
     }
+    
+    INC_DWORD_STAT_BY(STAT_AWR_EffectsFull, TierCounts[(int32)EEffectSignificance::Full]);
+    INC_DWORD_STAT_BY(STAT_AWR_EffectsReduced, TierCounts[(int32)EEffectSignificance::Reduced]);
+    INC_DWORD_STAT_BY(STAT_AWR_EffectsSuppressed, TierCounts[(int32)EEffectSignificance::Suppressed]);
+}
+
+void UAnimeEffectsManager::ApplySignificance(FActiveEffectInstance& Instance, EEffectSignificance Significance) const
+{
+    if (Instance.Significance == Significance) return;
+    
+    // Suppressed effects keep running so they can come back, they just stop spawning and drawing.
+    // Reduced effects drop the emitters their template marks below the required significance.
+    UParticleSystemComponent* ParticleComp = Instance.ParticleComponent;
+    ParticleComp->bSuppressSpawning = (Significance == EEffectSignificance::Suppressed);
+    ParticleComp->SetVisibility(Significance != EEffectSignificance::Suppressed);
+    ParticleComp->SetRequiredSignificance(
+        Significance == EEffectSignificance::Reduced ? ReducedRequiredSignificance : EParticleSignificanceLevel::Low);
+    
+    Instance.Significance = Significance;
+}
+
+void UAnimeEffectsManager::SetEffectBudget(int32 MaxConcurrent, float EffectScale)
+{
+    MaxConcurrentEffects = FMath::Max(MaxConcurrent, 1);
+    EffectBudgetScale = FMath::Clamp(EffectScale, 0.1f, 1.0f);
+}
+
+void UAnimeEffectsManager::SetSignificanceScale(float DistanceScale)
+{
+    SignificanceDistanceScale = FMath::Clamp(DistanceScale, 0.25f, 2.0f);
 }
 
 UParticleSystemComponent* UAnimeEffectsManager::CreateParticleComponent(UParticleSystem* ParticleSystem)
@@ -427,19 +1003,836 @@ UParticleSystemComponent* UAnimeEffectsManager::CreateParticleComponent(UParticl
     ParticleComp->bAutoActivate = false;
     ParticleComp->AttachToComponent(GetOwner()->GetRootComponent(), 
         FAttachmentTransformRules::KeepWorldTransform);
+    ParticleComp->RegisterComponent();
+    
+    NumComponentsCreated++;
+    INC_DWORD_STAT(STAT_AWR_EffectComponentsCreated);
     
     return ParticleComp;
 }
 
+UNiagaraComponent* UAnimeEffectsManager::CreateBurstComponent(UNiagaraSystem* BurstSystem)
+{
+    if (!BurstSystem) return nullptr;
+    
+    // Spawn positions are in world space, so the component stays at the origin instead of following the owner
+    UNiagaraComponent* BurstComp = NewObject<UNiagaraComponent>(GetOwner());
+    BurstComp->SetAsset(BurstSystem);
+    BurstComp->SetAutoActivate(false);
+    BurstComp->SetUsingAbsoluteLocation(true);
+    BurstComp->SetUsingAbsoluteRotation(true);
+    BurstComp->SetWorldTransform(FTransform::Identity);
+    BurstComp->RegisterComponent();
+    BurstComp->Activate(true);
+    
+    NumComponentsCreated++;
+    INC_DWORD_STAT(STAT_AWR_EffectComponentsCreated);
+    
+    return BurstComp;
+}
+
 UAudioComponent* UAnimeEffectsManager::CreateAudioComponent(USoundCue* SoundCue)
 {
-    if (!SoundCue) return nullptr;
+    if (!GetOwner() || !GetOwner()->GetRootComponent()) return nullptr;
     
     UAudioComponent* AudioComp = NewObject<UAudioComponent>(GetOwner());
     AudioComp->SetSound(SoundCue);
     AudioComp->bAutoActivate = false;
     AudioComp->AttachToComponent(GetOwner()->GetRootComponent(), 
         FAttachmentTransformRules::KeepWorldTransform);
+    AudioComp->RegisterComponent();
+    
+    NumComponentsCreated++;
+    NumAudioVoicesCreated++;
+    INC_DWORD_STAT(STAT_AWR_EffectComponentsCreated);
     
     return AudioComp;
 }
+
+UParticleSystemComponent* UAnimeEffectsManager::AcquireParticleComponent(EAnimeEffectType EffectType, UParticleSystem* ParticleSystem)
+{
+    if (FAnimeEffectComponentPool* Pool = ComponentPools.Find(EffectType))
+    {
+        while (Pool->FreeParticleComponents.Num() > 0)
+        {
+            UParticleSystemComponent* ParticleComp = Pool->FreeParticleComponents.Pop(false);
+            DEC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+            
+            if (IsValid(ParticleComp))
+            {
+                // Effect data can change at runtime (PlayElementalBurst), so the template may be stale
+                if (ParticleComp->Template != ParticleSystem)
+                {
+                    ParticleComp->SetTemplate(ParticleSystem);
+                }
+                return ParticleComp;
+            }
+        }
+    }
+    
+    return CreateParticleComponent(ParticleSystem);
+}
+
+UAudioComponent* UAnimeEffectsManager::AcquireAudioVoice(USoundCue* SoundCue)
+{
+    while (FreeAudioVoices.Num() > 0)
+    {
+        UAudioComponent* AudioComp = FreeAudioVoices.Pop(false);
+        DEC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+        
+        if (IsValid(AudioComp))
+        {
+            AudioComp->SetSound(SoundCue);
+            return AudioComp;
+        }
+    }
+    
+    return CreateAudioComponent(SoundCue);
+}
+
+void UAnimeEffectsManager::ReleaseParticleComponent(EAnimeEffectType EffectType, UParticleSystemComponent* ParticleComp)
+{
+    if (!IsValid(ParticleComp)) return;
+    
+    // Types that left the preload set are not pooled again, or a new pool would keep their template loaded
+    FAnimeEffectComponentPool* Pool = EffectLoadHandles.Contains(EffectType) ? &ComponentPools.FindOrAdd(EffectType) : nullptr;
+    if (!Pool || !EffectsSettings::CVarPoolComponents.GetValueOnGameThread() || Pool->FreeParticleComponents.Num() >= MaxPooledComponentsPerType)
+    {
+        ParticleComp->Deactivate();
+        ParticleComp->DestroyComponent();
+        return;
+    }
+    
+    ParticleComp->DeactivateImmediate();
+    
+    // Undo significance so the next play starts at full fidelity
+    ParticleComp->bSuppressSpawning = false;
+    ParticleComp->SetVisibility(true);
+    ParticleComp->SetRequiredSignificance(EParticleSignificanceLevel::Low);
+    
+    // Attached effects leave their socket so the next play can go anywhere
+    if (ParticleComp->GetAttachParent() != GetOwner()->GetRootComponent())
+    {
+        ParticleComp->AttachToComponent(GetOwner()->GetRootComponent(), 
+            FAttachmentTransformRules::KeepWorldTransform);
+    }
+    
+    Pool->FreeParticleComponents.Add(ParticleComp);
+    INC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+}
+
+void UAnimeEffectsManager::ReleaseAudioVoice(UAudioComponent* AudioComp)
+{
+    if (!IsValid(AudioComp)) return;
+    
+    AudioComp->Stop();
+    
+    // Every category at its voice limit is the most the pool ever needs
+    int32 MaxVoices = 0;
+    for (int32 i = 0; i < (int32)EAnimeSoundCategory::Count; i++)
+    {
+        MaxVoices += GetSoundCategorySettings((EAnimeSoundCategory)i).MaxVoices;
+    }
+    
+    if (!EffectsSettings::CVarPoolComponents.GetValueOnGameThread() || FreeAudioVoices.Num() >= MaxVoices)
+    {
+        AudioComp->DestroyComponent();
+        return;
+    }
+    
+    // Drop the sound so a pooled voice does not keep an unloaded effect's asset alive
+    AudioComp->SetSound(nullptr);
+    FreeAudioVoices.Add(AudioComp);
+    INC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+}
+
+void UAnimeEffectsManager::PrewarmAudioVoices()
+{
+    if (!GetOwner() || !GetOwner()->GetRootComponent()) return;
+    
+    // Enough for the categories that are busy in normal play
+    const int32 PrewarmCount = GetSoundCategorySettings(EAnimeSoundCategory::Movement).MaxVoices
+        + GetSoundCategorySettings(EAnimeSoundCategory::Pickup).MaxVoices;
+    
+    while (FreeAudioVoices.Num() < PrewarmCount)
+    {
+        FreeAudioVoices.Add(CreateAudioComponent(nullptr));
+        INC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+    }
+}
+
+const FAnimeSoundCategorySettings& UAnimeEffectsManager::GetSoundCategorySettings(EAnimeSoundCategory Category) const
+{
+    static const FAnimeSoundCategorySettings DefaultSettings;
+    
+    const FAnimeSoundCategorySettings* Settings = SoundCategories.Find(Category);
+    return Settings ? *Settings : DefaultSettings;
+}
+
+EAnimeSoundCategory UAnimeEffectsManager::GetSoundCategory(EAnimeEffectType EffectType) const
+{
+    const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+    return EffectData ? EffectData->SoundCategory : EAnimeSoundCategory::Default;
+}
+
+int32 UAnimeEffectsManager::GetActiveVoiceCount(EAnimeSoundCategory Category) const
+{
+    int32 VoiceCount = 0;
+    
+    for (const auto& ListPair : ActiveEffects)
+    {
+        if (GetSoundCategory(ListPair.Key) != Category) continue;
+        
+        for (const FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            VoiceCount += Instance.AudioComponent ? 1 : 0;
+        }
+    }
+    
+    return VoiceCount;
+}
+
+bool UAnimeEffectsManager::IsSoundAudible(EAnimeSoundCategory Category, const FVector& Location, const FVector& ListenerLocation) const
+{
+    const float MaxDistance = GetSoundCategorySettings(Category).MaxAudibleDistance;
+    return MaxDistance <= 0.0f || FVector::DistSquared(Location, ListenerLocation) <= FMath::Square(MaxDistance);
+}
+
+bool UAnimeEffectsManager::ReserveSoundVoice(EAnimeSoundCategory Category)
+{
+    const int32 MaxVoices = FMath::Max(GetSoundCategorySettings(Category).MaxVoices, 1);
+    if (GetActiveVoiceCount(Category) < MaxVoices) return true;
+    
+    // The oldest voice of the category gives way; its particles keep playing
+    FActiveEffectInstance* Oldest = nullptr;
+    for (auto& ListPair : ActiveEffects)
+    {
+        if (GetSoundCategory(ListPair.Key) != Category) continue;
+        
+        for (FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            if (Instance.AudioComponent && (!Oldest || Instance.StartTime < Oldest->StartTime))
+            {
+                Oldest = &Instance;
+            }
+        }
+    }
+    
+    if (!Oldest) return false;
+    
+    // A stolen loop waits as a virtual voice; a one-shot left with nothing playing is removed at its expiry
+    ReleaseAudioVoice(Oldest->AudioComponent);
+    Oldest->AudioComponent = nullptr;
+    Oldest->bSoundVirtual = Oldest->AudioEndTime <= 0.0f;
+    NumVoicesStolen++;
+    return true;
+}
+
+bool UAnimeEffectsManager::StartSoundVoice(FActiveEffectInstance& Instance, EAnimeEffectType EffectType, USoundCue* SoundCue, const FVector& Location)
+{
+    const EAnimeSoundCategory Category = GetSoundCategory(EffectType);
+    const float SoundDuration = SoundCue->GetDuration();
+    const bool bLooping = SoundDuration >= INDEFINITELY_LOOPING_DURATION;
+    const float Now = GetWorld()->GetTimeSeconds();
+    
+    // Rapid retriggers of one-shots (a chain of coins) share the voice that is already playing
+    const float* LastSoundTime = LastSoundTimes.Find(SoundCue);
+    if (!bLooping && LastSoundTime && Now - *LastSoundTime < GetSoundCategorySettings(Category).MinRetriggerTime)
+    {
+        NumSoundsRateLimited++;
+        return false;
+    }
+    
+    // Far sounds take no voice; a looping one waits as a virtual voice until the listener comes back in range
+    if (!IsSoundAudible(Category, Location, GetViewLocation()) || !ReserveSoundVoice(Category))
+    {
+        NumSoundsVirtualized++;
+        Instance.bSoundVirtual = bLooping;
+        return false;
+    }
+    
+    UAudioComponent* AudioComp = AcquireAudioVoice(SoundCue);
+    if (!AudioComp) return false;
+    
+    AudioComp->SetWorldLocation(Location);
+    AudioComp->SetVolumeMultiplier(GlobalVolumeMultiplier);
+    AudioComp->Play();
+    Instance.AudioComponent = AudioComp;
+    Instance.bSoundVirtual = false;
+    LastSoundTimes.Add(SoundCue, Now);
+    
+    // Looping sounds report an indefinite duration and play until the effect is stopped
+    if (SoundDuration > 0.0f && !bLooping)
+    {
+        Instance.AudioEndTime = Now + SoundDuration;
+        ScheduleExpiry(Instance.AudioEndTime, EffectType, Instance.InstanceId);
+    }
+    
+    return true;
+}
+
+void UAnimeEffectsManager::UpdateSoundVoices()
+{
+    const FVector ListenerLocation = GetViewLocation();
+    int32 VirtualCount = 0;
+    
+    // Counted once per pass and kept up to date below, instead of a full walk per virtual voice
+    int32 VoiceCounts[(int32)EAnimeSoundCategory::Count];
+    for (int32 i = 0; i < (int32)EAnimeSoundCategory::Count; i++)
+    {
+        VoiceCounts[i] = GetActiveVoiceCount((EAnimeSoundCategory)i);
+    }
+    
+    for (auto& ListPair : ActiveEffects)
+    {
+        const EAnimeEffectType EffectType = ListPair.Key;
+        const EAnimeSoundCategory Category = GetSoundCategory(EffectType);
+        
+        for (FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            // Only looping sounds move between real and virtual; one-shots end on their own
+            if (Instance.AudioComponent && Instance.AudioEndTime <= 0.0f)
+            {
+                if (!IsSoundAudible(Category, Instance.AudioComponent->GetComponentLocation(), ListenerLocation))
+                {
+                    ReleaseAudioVoice(Instance.AudioComponent);
+                    Instance.AudioComponent = nullptr;
+                    Instance.bSoundVirtual = true;
+                    VoiceCounts[(int32)Category]--;
+                    NumSoundsVirtualized++;
+                }
+            }
+            else if (Instance.bSoundVirtual)
+            {
+                const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+                const USceneComponent* Anchor = Instance.ParticleComponent ? (USceneComponent*)Instance.ParticleComponent : GetOwner()->GetRootComponent();
+                USoundCue* SoundCue = EffectData ? EffectData->SoundEffect.Get() : nullptr;
+                
+                if (SoundCue && Anchor && IsSoundAudible(Category, Anchor->GetComponentLocation(), ListenerLocation)
+                    && VoiceCounts[(int32)Category] < FMath::Max(GetSoundCategorySettings(Category).MaxVoices, 1)
+                    && StartSoundVoice(Instance, EffectType, SoundCue, Anchor->GetComponentLocation()))
+                {
+                    VoiceCounts[(int32)Category]++;
+                }
+            }
+            
+            VirtualCount += Instance.bSoundVirtual ? 1 : 0;
+        }
+    }
+    
+    INC_DWORD_STAT_BY(STAT_AWR_VirtualSoundVoices, VirtualCount);
+}
+
+void UAnimeEffectsManager::PrewarmEffectPools()
+{
+    for (const auto& EffectPair : EffectDataMap)
+    {
+        PrewarmEffectPool(EffectPair.Key);
+    }
+}
+
+void UAnimeEffectsManager::PrewarmEffectPool(EAnimeEffectType EffectType)
+{
+    if (!GetOwner() || !GetOwner()->GetRootComponent()) return;
+    
+    const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+    if (!EffectData) return;
+    
+    UNiagaraSystem* BurstSystem = EffectData->BurstEffect.Get();
+    if (BurstSystem && !BurstBatches.Contains(EffectType))
+    {
+        FAnimeBurstBatch& Batch = BurstBatches.Add(EffectType);
+        Batch.Component = CreateBurstComponent(BurstSystem);
+        Batch.Positions.Reserve(MaxBurstSpawnsPerFrame);
+        Batch.Colors.Reserve(MaxBurstSpawnsPerFrame);
+    }
+    
+    const int32 PrewarmCount = FMath::Min(EffectData->PrewarmCount, MaxPooledComponentsPerType);
+    if (PrewarmCount <= 0) return;
+    
+    FAnimeEffectComponentPool& Pool = ComponentPools.FindOrAdd(EffectType);
+    
+    // Assets that are still streaming are skipped; their pool is filled when they arrive.
+    // Burst effects only fall back to particle components when batching is switched off.
+    UParticleSystem* ParticleSystem = BurstSystem ? nullptr : EffectData->ParticleEffect.Get();
+    while (ParticleSystem && Pool.FreeParticleComponents.Num() < PrewarmCount)
+    {
+        Pool.FreeParticleComponents.Add(CreateParticleComponent(ParticleSystem));
+        INC_DWORD_STAT(STAT_AWR_PooledEffectComponents);
+    }
+}
+
+void UAnimeEffectsManager::ClearEffectPool(EAnimeEffectType EffectType)
+{
+    FAnimeBurstBatch Batch;
+    if (BurstBatches.RemoveAndCopyValue(EffectType, Batch) && IsValid(Batch.Component))
+    {
+        Batch.Component->DestroyComponent();
+    }
+    
+    FAnimeEffectComponentPool Pool;
+    if (!ComponentPools.RemoveAndCopyValue(EffectType, Pool)) return;
+    
+    for (UParticleSystemComponent* ParticleComp : Pool.FreeParticleComponents)
+    {
+        if (IsValid(ParticleComp))
+        {
+            ParticleComp->DestroyComponent();
+        }
+    }
+    
+    DEC_DWORD_STAT_BY(STAT_AWR_PooledEffectComponents, Pool.FreeParticleComponents.Num());
+}
+
+void UAnimeEffectsManager::SetCharacterEffects(const TArray<EAnimeEffectType>& EffectTypes)
+{
+    CharacterEffectTypes = EffectTypes;
+    UpdatePreloadSet();
+}
+
+void UAnimeEffectsManager::SetEffectTheme(EEnvironmentTheme Theme)
+{
+    if (Theme == CurrentTheme) return;
+    
+    CurrentTheme = Theme;
+    UpdatePreloadSet();
+}
+
+void UAnimeEffectsManager::SetEffectData(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData)
+{
+    EffectDataMap.Add(EffectType, EffectData);
+    
+    // The old handle holds the previous assets; the preload set requests the new ones
+    TSharedPtr<FStreamableHandle> LoadHandle;
+    if (EffectLoadHandles.RemoveAndCopyValue(EffectType, LoadHandle) && LoadHandle.IsValid())
+    {
+        LoadHandle->ReleaseHandle();
+    }
+    UpdatePreloadSet();
+}
+
+bool UAnimeEffectsManager::IsEffectLoaded(EAnimeEffectType EffectType) const
+{
+    const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+    if (!EffectData) return false;
+    
+    return (EffectData->ParticleEffect.IsNull() || EffectData->ParticleEffect.IsValid())
+        && (EffectData->SoundEffect.IsNull() || EffectData->SoundEffect.IsValid())
+        && (EffectData->BurstEffect.IsNull() || EffectData->BurstEffect.IsValid());
+}
+
+void UAnimeEffectsManager::UpdatePreloadSet()
+{
+    TSet<EAnimeEffectType> PreloadSet;
+    for (const auto& EffectPair : EffectDataMap)
+    {
+        if (EffectPair.Value.bAlwaysLoaded)
+        {
+            PreloadSet.Add(EffectPair.Key);
+        }
+    }
+    
+    PreloadSet.Append(CharacterEffectTypes);
+    
+    if (const FAnimeEffectTypeSet* ThemeSet = ThemeEffects.Find(CurrentTheme))
+    {
+        PreloadSet.Append(ThemeSet->EffectTypes);
+    }
+    
+    // Let go of effects that left the set; components still playing keep their assets until they stop
+    for (auto It = EffectLoadHandles.CreateIterator(); It; ++It)
+    {
+        if (!PreloadSet.Contains(It.Key()))
+        {
+            if (It.Value().IsValid())
+            {
+                It.Value()->ReleaseHandle();
+            }
+            ClearEffectPool(It.Key());
+            It.RemoveCurrent();
+        }
+    }
+    
+    for (EAnimeEffectType EffectType : PreloadSet)
+    {
+        RequestEffectLoad(EffectType);
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Effect preload set: %d effect types for %s"), PreloadSet.Num(), *UEnum::GetValueAsString(CurrentTheme));
+}
+
+void UAnimeEffectsManager::RequestEffectLoad(EAnimeEffectType EffectType)
+{
+    if (EffectLoadHandles.Contains(EffectType)) return;
+    
+    const FAnimeEffectData* EffectData = EffectDataMap.Find(EffectType);
+    if (!EffectData) return;
+    
+    TArray<FSoftObjectPath> AssetPaths;
+    if (!EffectData->ParticleEffect.IsNull())
+    {
+        AssetPaths.Add(EffectData->ParticleEffect.ToSoftObjectPath());
+    }
+    if (!EffectData->SoundEffect.IsNull())
+    {
+        AssetPaths.Add(EffectData->SoundEffect.ToSoftObjectPath());
+    }
+    if (!EffectData->BurstEffect.IsNull())
+    {
+        AssetPaths.Add(EffectData->BurstEffect.ToSoftObjectPath());
+    }
+    
+    UAssetManager* AssetManager = UAssetManager::GetIfValid();
+    if (AssetPaths.Num() == 0 || !AssetManager) return;
+    
+    FStreamableManager& StreamableManager = AssetManager->GetStreamableManager();
+    EffectLoadHandles.Add(EffectType, StreamableManager.RequestAsyncLoad(AssetPaths,
+        FStreamableDelegate::CreateUObject(this, &UAnimeEffectsManager::OnEffectLoaded, EffectType)));
+}
+
+void UAnimeEffectsManager::OnEffectLoaded(EAnimeEffectType EffectType)
+{
+    PrewarmEffectPool(EffectType);
+    
+    // A continuous effect may have been switched on while it was still loading
+    if (PendingContinuousEffects.Remove(EffectType) > 0 && GetOwner())
+    {
+        SetContinuousEffect(EffectType, true);
+    }
+}
+
+int64 UAnimeEffectsManager::GetEffectMemoryBytes() const
+{
+    int64 EffectBytes = 0;
+    
+    for (const auto& ListPair : ActiveEffects)
+    {
+        for (const FActiveEffectInstance& Instance : ListPair.Value.Instances)
+        {
+            if (IsValid(Instance.ParticleComponent))
+            {
+                EffectBytes += Instance.ParticleComponent->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+            }
+            
+            if (IsValid(Instance.AudioComponent))
+            {
+                EffectBytes += Instance.AudioComponent->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+            }
+        }
+    }
+    
+    for (const auto& PoolPair : ComponentPools)
+    {
+        for (UParticleSystemComponent* ParticleComp : PoolPair.Value.FreeParticleComponents)
+        {
+            if (IsValid(ParticleComp))
+            {
+                EffectBytes += ParticleComp->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+            }
+        }
+    }
+    
+    for (UAudioComponent* AudioComp : FreeAudioVoices)
+    {
+        if (IsValid(AudioComp))
+        {
+            EffectBytes += AudioComp->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+        }
+    }
+    
+    for (const auto& BatchPair : BurstBatches)
+    {
+        if (IsValid(BatchPair.Value.Component))
+        {
+            EffectBytes += BatchPair.Value.Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+        }
+        EffectBytes += BatchPair.Value.Positions.GetAllocatedSize() + BatchPair.Value.Colors.GetAllocatedSize();
+    }
+    
+    if (AuraEffectComponent)
+    {
+        EffectBytes += AuraEffectComponent->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+    }
+    
+    if (TrailEffectComponent)
+    {
+        EffectBytes += TrailEffectComponent->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+    }
+    
+    return EffectBytes;
+}
+
+namespace EffectsCommands
+{
+    // Plays a burst of collect effects with pooling off and then on, and reports time and allocations of both runs
+    static void PoolBenchmark(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+        
+        for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+        {
+            UAnimeEffectsManager* EffectsManager = *It;
+            if (EffectsManager->GetWorld() != World || !EffectsManager->HasBegunPlay())
+            {
+                continue;
+            }
+            
+            IConsoleVariable* PoolVariable = EffectsSettings::CVarPoolComponents.AsVariable();
+            const int32 PoolSetting = PoolVariable->GetInt();
+            
+            double ElapsedMs[2] = { 0.0, 0.0 };
+            int32 Created[2] = { 0, 0 };
+            int32 MaxParticles = 0;
+            
+            // The unpooled run goes first, so the pooled run starts from an empty pool as it does after a level load
+            for (int32 Pass = 0; Pass < 2; Pass++)
+            {
+                PoolVariable->Set(Pass, ECVF_SetByConsole);
+                
+                const int32 CreatedBefore = EffectsManager->GetNumComponentsCreated();
+                const double StartTime = FPlatformTime::Seconds();
+                
+                for (int32 i = 0; i < Count; i++)
+                {
+                    EffectsManager->PlayEffect(EAnimeEffectType::Collect, FVector(i * 100.0f, 0.0f, 0.0f));
+                }
+                MaxParticles = FMath::Max(MaxParticles, EffectsManager->GetActiveParticleCount());
+                EffectsManager->StopEffect(EAnimeEffectType::Collect);
+                
+                ElapsedMs[Pass] = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+                Created[Pass] = EffectsManager->GetNumComponentsCreated() - CreatedBefore;
+            }
+            
+            PoolVariable->Set(PoolSetting, ECVF_SetByConsole);
+            
+            // Without a loaded particle template both runs only time the bookkeeping
+            if (MaxParticles == 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Effect pool benchmark: the collect effect played no particles (template missing or not loaded), nothing was measured"));
+                return;
+            }
+            
+            UE_LOG(LogTemp, Log, TEXT("Effect pool benchmark: %d collect effects; pooling off %.2f ms (%.3f ms each), %d components created; pooling on %.2f ms (%.3f ms each), %d components created"),
+                Count, ElapsedMs[0], ElapsedMs[0] / Count, Created[0], ElapsedMs[1], ElapsedMs[1] / Count, Created[1]);
+            return;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Effect pool benchmark: no effects manager in this world"));
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs PoolBenchmarkCommand(
+        TEXT("AWR.Effects.PoolBenchmark"),
+        TEXT("Plays N collect effects (default 1000) with pooling off and on, and logs the time taken and components created by each run."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&PoolBenchmark));
+    
+    // Plays a coin line of collect effects in front of the view; with a burst system it should create nothing
+    static void BurstBenchmark(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 30;
+        
+        for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+        {
+            UAnimeEffectsManager* EffectsManager = *It;
+            if (EffectsManager->GetWorld() != World || !EffectsManager->HasBegunPlay())
+            {
+                continue;
+            }
+            
+            // Without a burst system the run only measures the per-component path
+            if (!EffectsManager->HasBurstBatch(EAnimeEffectType::Collect))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Burst benchmark: the collect effect has no loaded BurstEffect, batching is not exercised"));
+            }
+            
+            const FVector Origin = EffectsManager->GetOwner() ? EffectsManager->GetOwner()->GetActorLocation() : FVector::ZeroVector;
+            const int32 CreatedBefore = EffectsManager->GetNumComponentsCreated();
+            const int32 DroppedBefore = EffectsManager->GetNumBurstSpawnsDropped();
+            const double StartTime = FPlatformTime::Seconds();
+            
+            for (int32 i = 0; i < Count; i++)
+            {
+                EffectsManager->PlayEffect(EAnimeEffectType::Collect, Origin + FVector(100.0f + i * 50.0f, 0.0f, 0.0f));
+            }
+            
+            const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            UE_LOG(LogTemp, Log, TEXT("Burst benchmark: %d collect effects queued in %.3f ms, %d components created, %d dropped, batching %s"),
+                Count, ElapsedMs, EffectsManager->GetNumComponentsCreated() - CreatedBefore,
+                EffectsManager->GetNumBurstSpawnsDropped() - DroppedBefore,
+                EffectsSettings::CVarBatchBursts.GetValueOnGameThread() ? TEXT("on") : TEXT("off"));
+            return;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Burst benchmark: no effects manager in this world"));
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs BurstBenchmarkCommand(
+        TEXT("AWR.Effects.BurstBenchmark"),
+        TEXT("Plays a line of N collect effects (default 30) and logs the time, components created and dropped spawns."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BurstBenchmark));
+    
+    // Scripted run: footsteps at running cadence plus a coin chain every second, logging voices and allocations each second
+    static void AudioSoak(const TArray<FString>& Args, UWorld* World)
+    {
+        const float Duration = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 10.0f;
+        
+        for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+        {
+            UAnimeEffectsManager* EffectsManager = *It;
+            if (EffectsManager->GetWorld() != World || !EffectsManager->HasBegunPlay() || !EffectsManager->GetOwner())
+            {
+                continue;
+            }
+            
+            struct FSoakState
+            {
+                float Elapsed = 0.0f;
+                float NextFootstep = 0.0f;
+                float NextCoinChain = 0.5f;
+                float NextReport = 1.0f;
+                int32 CreatedBefore = 0;
+                int32 RateLimitedBefore = 0;
+                int32 VirtualizedBefore = 0;
+                int32 StolenBefore = 0;
+                int32 NumFootsteps = 0;
+                int32 NumCoins = 0;
+                int32 PeakVoices[(int32)EAnimeSoundCategory::Count] = {};
+            };
+            
+            TSharedRef<FSoakState> State = MakeShared<FSoakState>();
+            State->CreatedBefore = EffectsManager->GetNumAudioVoicesCreated();
+            State->RateLimitedBefore = EffectsManager->GetNumSoundsRateLimited();
+            State->VirtualizedBefore = EffectsManager->GetNumSoundsVirtualized();
+            State->StolenBefore = EffectsManager->GetNumVoicesStolen();
+            
+            TWeakObjectPtr<UAnimeEffectsManager> WeakManager(EffectsManager);
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakManager, State, Duration](float DeltaTime)
+            {
+                UAnimeEffectsManager* Manager = WeakManager.Get();
+                if (!Manager || !Manager->GetOwner())
+                {
+                    return false;
+                }
+                
+                const FVector Origin = Manager->GetOwner()->GetActorLocation();
+                State->Elapsed += DeltaTime;
+                
+                if (State->Elapsed >= State->NextFootstep)
+                {
+                    Manager->PlayEffect(EAnimeEffectType::Footstep, Origin);
+                    State->NextFootstep += 0.3f;
+                    State->NumFootsteps++;
+                }
+                
+                // Twenty coins in the same frame, the worst case of a magnet pickup
+                if (State->Elapsed >= State->NextCoinChain)
+                {
+                    State->NextCoinChain += 1.0f;
+                    for (int32 i = 0; i < 20; i++)
+                    {
+                        Manager->PlayEffect(EAnimeEffectType::Collect, Origin + FVector(100.0f * i, 0.0f, 0.0f));
+                    }
+                    State->NumCoins += 20;
+                }
+                
+                for (int32 i = 0; i < (int32)EAnimeSoundCategory::Count; i++)
+                {
+                    State->PeakVoices[i] = FMath::Max(State->PeakVoices[i], Manager->GetActiveVoiceCount((EAnimeSoundCategory)i));
+                }
+                
+                if (State->Elapsed >= State->NextReport || State->Elapsed >= Duration)
+                {
+                    State->NextReport += 1.0f;
+                    UE_LOG(LogTemp, Log, TEXT("Audio soak %.0fs: voices movement %d, pickup %d, ability %d; %d voices created, %d rate limited, %d virtualized, %d stolen"),
+                        State->Elapsed,
+                        Manager->GetActiveVoiceCount(EAnimeSoundCategory::Movement),
+                        Manager->GetActiveVoiceCount(EAnimeSoundCategory::Pickup),
+                        Manager->GetActiveVoiceCount(EAnimeSoundCategory::Ability),
+                        Manager->GetNumAudioVoicesCreated() - State->CreatedBefore,
+                        Manager->GetNumSoundsRateLimited() - State->RateLimitedBefore,
+                        Manager->GetNumSoundsVirtualized() - State->VirtualizedBefore,
+                        Manager->GetNumVoicesStolen() - State->StolenBefore);
+                }
+                
+                if (State->Elapsed >= Duration)
+                {
+                    UE_LOG(LogTemp, Log, TEXT("Audio soak done after %.0fs: peak voices movement %d, pickup %d, ability %d; %d footsteps and %d coins requested, %d voices created"),
+                        State->Elapsed,
+                        State->PeakVoices[(int32)EAnimeSoundCategory::Movement],
+                        State->PeakVoices[(int32)EAnimeSoundCategory::Pickup],
+                        State->PeakVoices[(int32)EAnimeSoundCategory::Ability],
+                        State->NumFootsteps, State->NumCoins,
+                        Manager->GetNumAudioVoicesCreated() - State->CreatedBefore);
+                    return false;
+                }
+                
+                return true;
+            }));
+            return;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Audio soak: no effects manager in this world"));
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs AudioSoakCommand(
+        TEXT("AWR.Effects.AudioSoak"),
+        TEXT("Plays footsteps and coin chains for N seconds (default 10) and logs voice counts and allocations every second."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&AudioSoak));
+    
+    // Runs the per-tick continuous effect calls of ten seconds of running at 60 fps; exactly one activation is expected
+    static void ContinuousEffectCheck(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Frames = 600;
+        
+        for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+        {
+            UAnimeEffectsManager* EffectsManager = *It;
+            if (EffectsManager->GetWorld() != World || !EffectsManager->HasBegunPlay())
+            {
+                continue;
+            }
+            
+            const bool bWasActive = EffectsManager->IsContinuousEffectActive(EAnimeEffectType::Running);
+            EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, false);
+            
+            // Pooled components are reused, so activations are counted rather than allocations
+            const int32 PlaysBefore = EffectsManager->GetNumAttachedPlays();
+            for (int32 Frame = 0; Frame < Frames; Frame++)
+            {
+                EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, true);
+            }
+            const int32 Plays = EffectsManager->GetNumAttachedPlays() - PlaysBefore;
+            
+            EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, bWasActive);
+            
+            UE_LOG(LogTemp, Log, TEXT("Continuous effect check: %d frames of running activated %d components (%s)"),
+                Frames, Plays, Plays == 1 ? TEXT("passed") : TEXT("FAILED"));
+            return;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Continuous effect check: no effects manager in this world"));
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs ContinuousEffectCheckCommand(
+        TEXT("AWR.Effects.ContinuousCheck"),
+        TEXT("Counts the activations caused by ten seconds of per-tick SetContinuousEffect(Running) calls."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ContinuousEffectCheck));
+    
+    // Pair with `stat Particles` and AWR.Effects.Significance 0/1 to measure the particle cost saved
+    static void SignificanceReport(const TArray<FString>& Args, UWorld* World)
+    {
+        for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+        {
+            if (It->GetWorld() == World)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Effect significance: %d active effects, %d particle components, %d spawns skipped since start, significance %s"),
+                    It->GetActiveEffectCount(), It->GetActiveParticleCount(), It->GetNumSpawnsSkipped(),
+                    EffectsSettings::CVarSignificance.GetValueOnGameThread() ? TEXT("on") : TEXT("off"));
+            }
+        }
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs SignificanceReportCommand(
+        TEXT("AWR.Effects.SignificanceReport"),
+        TEXT("Logs active effects and the particle spawns skipped by significance culling."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SignificanceReport));
+}
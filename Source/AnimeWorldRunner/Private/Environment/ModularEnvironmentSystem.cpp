@@ -1,9 +1,15 @@
 #include "Environment/ModularEnvironmentSystem.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
+#include "Optimization/SubsystemMemoryTracker.h"
 #include "Materials/AnimeMaterialManager.h"
+#include "Effects/AnimeEffectsManager.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/StaticMesh.h"
+#include "UObject/UObjectIterator.h"
+#include "Algo/BinarySearch.h"
 
 AModularEnvironmentSystem::AModularEnvironmentSystem()
 {
@@ -24,6 +30,7 @@ AModularEnvironmentSystem::AModularEnvironmentSystem()
     bEnableLOD = true;
     bEnableOcclusion = true;
     MaxDrawCalls = 80; // Mobile optimization
+    InstanceBudgetScale = 1.0f;
     
     // Create material manager
     MaterialManager = CreateDefaultSubobject<UAnimeMaterialManager>(TEXT("MaterialManager"));
@@ -31,6 +38,8 @@ AModularEnvironmentSystem::AModularEnvironmentSystem()
     // Initialize timers
     LastPlayerLocation = FVector::ZeroVector;
     ChunkUpdateTimer = 0.0f;
+    PlayerTheme = EEnvironmentTheme::Forest;
+    bHasPlayerTheme = false;
 }
 
 void AModularEnvironmentSystem::BeginPlay()
@@ -49,6 +58,9 @@ void AModularEnvironmentSystem::BeginPlay()
 
 void AModularEnvironmentSystem::Tick(float DeltaTime)
 {
+    AWR_HITCH_SCOPE(Environment);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_EnvironmentTick, AWREnvironmentChannel, "AModularEnvironmentSystem::Tick");
+    
     Super::Tick(DeltaTime);
     
     ChunkUpdateTimer += DeltaTime;
@@ -64,6 +76,8 @@ void AModularEnvironmentSystem::Tick(float DeltaTime)
         
         ChunkUpdateTimer = 0.0f;
     }
+    
+    UpdateStats();
 }
 
 void AModularEnvironmentSystem::InitializeEnvironmentPieces()
@@ -131,10 +145,30 @@ void AModularEnvironmentSystem::InitializeThemeSets()
     VillagePieces.Add(EEnvironmentPieceType::Bridge);
     VillagePieces.Add(EEnvironmentPieceType::Decoration);
     ThemePieceSets.Add(EEnvironmentTheme::Village, VillagePieces);
+    
+    // Default color variation, unless set up in Blueprint
+    if (ThemeVariations.Num() == 0)
+    {
+        FEnvironmentThemeVariation ForestVariation;
+        ForestVariation.Tint = FLinearColor(0.85f, 1.0f, 0.8f);
+        ForestVariation.TintVariation = 0.15f;
+        ThemeVariations.Add(EEnvironmentTheme::Forest, ForestVariation);
+        
+        FEnvironmentThemeVariation MountainVariation;
+        MountainVariation.Tint = FLinearColor(0.9f, 0.92f, 1.0f);
+        ThemeVariations.Add(EEnvironmentTheme::Mountain, MountainVariation);
+        
+        FEnvironmentThemeVariation VillageVariation;
+        VillageVariation.Tint = FLinearColor(1.0f, 0.92f, 0.82f);
+        VillageVariation.Emission = 0.2f;
+        ThemeVariations.Add(EEnvironmentTheme::Village, VillageVariation);
+    }
 }
 
 void AModularEnvironmentSystem::CreateInstancedMeshes()
 {
+    AWR_LLM_SCOPE(Environment);
+    
     if (!bEnableInstancing) return;
     
     // Create instanced mesh components for each piece type
@@ -149,6 +183,7 @@ void AModularEnvironmentSystem::CreateInstancedMeshes()
             UInstancedStaticMeshComponent* InstancedComp = CreateDefaultSubobject<UInstancedStaticMeshComponent>(*ComponentName);
             
             InstancedComp->SetStaticMesh(PieceData.Mesh);
+            InstancedComp->SetNumCustomDataFloats(EnvironmentCustomData::Count);
             InstancedComp->SetCollisionEnabled(PieceData.bEnableCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
             InstancedComp->SetCastShadow(PieceData.bCastShadows);
             
@@ -175,6 +210,8 @@ void AModularEnvironmentSystem::CreateInstancedMeshes()
 
 void AModularEnvironmentSystem::GenerateEnvironmentChunk(FVector ChunkLocation, EEnvironmentTheme Theme, float DifficultyLevel)
 {
+    AWR_LLM_SCOPE(ChunkData);
+    
     // Check if chunk already exists
     if (LoadedChunks.Contains(ChunkLocation))
     {
@@ -201,11 +238,12 @@ void AModularEnvironmentSystem::GenerateEnvironmentChunk(FVector ChunkLocation,
     
     // Load the chunk
     LoadEnvironmentChunk(NewChunk);
-    LoadedChunks.Add(ChunkLocation, NewChunk);
 }
 
 TArray<FTransform> AModularEnvironmentSystem::GenerateProceduralLayout(FVector ChunkLocation, EEnvironmentTheme Theme, float DifficultyLevel)
 {
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_GenerateLayout, AWREnvironmentChannel, "AModularEnvironmentSystem::GenerateProceduralLayout");
+    
     TArray<FTransform> GeneratedTransforms;
     
     // Set random seed for consistent generation
@@ -251,7 +289,7 @@ TArray<FTransform> AModularEnvironmentSystem::GenerateProceduralLayout(FVector C
     if (Theme == EEnvironmentTheme::Forest)
     {
         // Add trees and foliage
-        int32 TreeCount = FMath::RoundToInt(FoliageDensity * 20);
+        int32 TreeCount = FMath::RoundToInt(FoliageDensity * 20 * InstanceBudgetScale);
         for (int32 i = 0; i < TreeCount; i++)
         {
             FVector TreeOffset = FVector(
@@ -271,7 +309,7 @@ TArray<FTransform> AModularEnvironmentSystem::GenerateProceduralLayout(FVector C
     else if (Theme == EEnvironmentTheme::Mountain)
     {
         // Add rocks and vertical elements
-        int32 RockCount = FMath::RandRange(5, 12);
+        int32 RockCount = FMath::RoundToInt(FMath::RandRange(5, 12) * InstanceBudgetScale);
         for (int32 i = 0; i < RockCount; i++)
         {
             FVector RockOffset = FVector(
@@ -298,13 +336,112 @@ TArray<FTransform> AModularEnvironmentSystem::GenerateProceduralLayout(FVector C
 
 void AModularEnvironmentSystem::LoadEnvironmentChunk(const FEnvironmentChunkData& ChunkData)
 {
-    // Spawn all pieces in the chunk
-    for (int32 i = 0; i < ChunkData.PieceTransforms.Num() && i < ChunkData.PieceTypes.Num(); i++)
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_LoadChunk, AWREnvironmentChannel, "AModularEnvironmentSystem::LoadEnvironmentChunk");
+    AWR_LLM_SCOPE(Environment);
+    
+    if (LoadedChunks.Contains(ChunkData.ChunkLocation))
+    {
+        return;
+    }
+    
+    FEnvironmentChunkData& LoadedChunk = LoadedChunks.Add(ChunkData.ChunkLocation, ChunkData);
+    LoadedChunk.bIsLoaded = true;
+    
+    const int32 NumPieces = FMath::Min(LoadedChunk.PieceTransforms.Num(), LoadedChunk.PieceTypes.Num());
+    LoadedChunk.InstanceIndices.Init(INDEX_NONE, NumPieces);
+    
+    // Group instanced pieces per component so each component gets one batched add
+    TMap<UInstancedStaticMeshComponent*, TArray<int32>> ComponentPieces;
+    for (int32 i = 0; i < NumPieces; i++)
     {
-        EEnvironmentPieceType PieceType = ChunkData.PieceTypes[i];
-        FTransform PieceTransform = ChunkData.PieceTransforms[i];
+        EEnvironmentPieceType PieceType = LoadedChunk.PieceTypes[i];
+        const FEnvironmentPieceData* PieceData = EnvironmentPieces.Find(PieceType);
+        if (!PieceData || !PieceData->Mesh)
+        {
+            continue;
+        }
         
-        SpawnEnvironmentPiece(PieceType, PieceTransform, bEnableInstancing);
+        if (bEnableInstancing && PieceData->bCanBeInstanced)
+        {
+            if (UInstancedStaticMeshComponent* InstancedComp = InstancedMeshComponents.FindRef(PieceType))
+            {
+                ComponentPieces.FindOrAdd(InstancedComp).Add(i);
+            }
+        }
+        else
+        {
+            SpawnEnvironmentPiece(PieceType, LoadedChunk.PieceTransforms[i], false);
+        }
+    }
+    
+    TArray<FTransform> Transforms;
+    for (const TPair<UInstancedStaticMeshComponent*, TArray<int32>>& Pieces : ComponentPieces)
+    {
+        Transforms.Reset();
+        for (int32 PieceIndex : Pieces.Value)
+        {
+            Transforms.Add(LoadedChunk.PieceTransforms[PieceIndex]);
+        }
+        
+        const TArray<int32> NewInstances = Pieces.Key->AddInstances(Transforms, true);
+        for (int32 i = 0; i < NewInstances.Num() && i < Pieces.Value.Num(); i++)
+        {
+            LoadedChunk.InstanceIndices[Pieces.Value[i]] = NewInstances[i];
+        }
+    }
+    
+    WriteChunkCustomData(LoadedChunk);
+}
+
+void AModularEnvironmentSystem::WriteChunkCustomData(const FEnvironmentChunkData& ChunkData)
+{
+    const FEnvironmentThemeVariation DefaultVariation;
+    const FEnvironmentThemeVariation* FoundVariation = ThemeVariations.Find(ChunkData.Theme);
+    const FEnvironmentThemeVariation& Variation = FoundVariation ? *FoundVariation : DefaultVariation;
+    
+    // Seeded by the chunk so a chunk looks the same every time it is loaded or rethemed
+    FRandomStream VariationStream(HashCombine(GetTypeHash(RandomSeed), GetTypeHash(ChunkData.ChunkLocation)));
+    
+    TSet<UInstancedStaticMeshComponent*> DirtyComponents;
+    float CustomData[EnvironmentCustomData::Count];
+    
+    for (int32 i = 0; i < ChunkData.InstanceIndices.Num(); i++)
+    {
+        const float Brightness = 1.0f + VariationStream.FRandRange(-Variation.TintVariation, Variation.TintVariation);
+        const float WindPhase = VariationStream.FRand();
+        
+        const int32 InstanceIndex = ChunkData.InstanceIndices[i];
+        UInstancedStaticMeshComponent* InstancedComp = InstanceIndex != INDEX_NONE ? InstancedMeshComponents.FindRef(ChunkData.PieceTypes[i]) : nullptr;
+        if (!InstancedComp)
+        {
+            continue;
+        }
+        
+        CustomData[EnvironmentCustomData::TintR] = Variation.Tint.R * Brightness;
+        CustomData[EnvironmentCustomData::TintG] = Variation.Tint.G * Brightness;
+        CustomData[EnvironmentCustomData::TintB] = Variation.Tint.B * Brightness;
+        CustomData[EnvironmentCustomData::WindPhase] = WindPhase;
+        CustomData[EnvironmentCustomData::Emission] = Variation.Emission;
+        
+        InstancedComp->SetCustomData(InstanceIndex, CustomData, false);
+        DirtyComponents.Add(InstancedComp);
+    }
+    
+    for (UInstancedStaticMeshComponent* InstancedComp : DirtyComponents)
+    {
+        InstancedComp->MarkRenderStateDirty();
+    }
+}
+
+void AModularEnvironmentSystem::ApplyThemeMaterials(EEnvironmentTheme Theme)
+{
+    // Instances keep sharing their component's material; only their custom data changes
+    for (const TPair<FVector, FEnvironmentChunkData>& ChunkPair : LoadedChunks)
+    {
+        if (ChunkPair.Value.Theme == Theme)
+        {
+            WriteChunkCustomData(ChunkPair.Value);
+        }
     }
 }
 
@@ -323,7 +460,13 @@ AActor* AModularEnvironmentSystem::SpawnEnvironmentPiece(EEnvironmentPieceType P
         {
             if (*InstancedComp)
             {
-                (*InstancedComp)->AddInstance(SpawnTransform);
+                const int32 InstanceIndex = (*InstancedComp)->AddInstance(SpawnTransform);
+                
+                // Untinted until a chunk writes its theme's variation. Pieces placed here belong to no chunk, so the
+                // wind phase comes from a stream seeded like a chunk's, by the piece location, and repeats on reload.
+                FRandomStream VariationStream(HashCombine(GetTypeHash(RandomSeed), GetTypeHash(SpawnTransform.GetLocation())));
+                const float CustomData[EnvironmentCustomData::Count] = { 1.0f, 1.0f, 1.0f, VariationStream.FRand(), 0.0f };
+                (*InstancedComp)->SetCustomData(InstanceIndex, CustomData, true);
             }
         }
         return nullptr; // No individual actor created for instanced meshes
@@ -362,6 +505,14 @@ void AModularEnvironmentSystem::UpdateEnvironmentAroundPlayer(FVector PlayerLoca
     // Calculate which chunks should be loaded
     FVector PlayerChunkLocation = GetChunkLocationFromWorldLocation(PlayerLocation);
     
+    const EEnvironmentTheme CurrentPlayerTheme = GetThemeForLocation(PlayerChunkLocation);
+    if (!bHasPlayerTheme || CurrentPlayerTheme != PlayerTheme)
+    {
+        PlayerTheme = CurrentPlayerTheme;
+        bHasPlayerTheme = true;
+        NotifyThemeChanged(PlayerTheme);
+    }
+    
     // Load chunks in a grid around the player
     int32 ChunkRadius = FMath::CeilToInt(LoadRadius / ChunkSize.X);
     
@@ -374,12 +525,7 @@ void AModularEnvironmentSystem::UpdateEnvironmentAroundPlayer(FVector PlayerLoca
             
             if (ShouldLoadChunk(ChunkLocation, PlayerLocation))
             {
-                // Determine theme based on location (this could be more sophisticated)
-                EEnvironmentTheme Theme = EEnvironmentTheme::Forest;
-                if (FMath::Abs(ChunkLocation.X) > 4000.0f)
-                {
-                    Theme = EEnvironmentTheme::Mountain;
-                }
+                EEnvironmentTheme Theme = GetThemeForLocation(ChunkLocation);
                 
                 float DifficultyLevel = FMath::Clamp(FVector::Dist2D(ChunkLocation, FVector::ZeroVector) / 2000.0f, 1.0f, 3.0f);
                 
@@ -392,6 +538,29 @@ void AModularEnvironmentSystem::UpdateEnvironmentAroundPlayer(FVector PlayerLoca
     CleanupDistantChunks(PlayerLocation);
 }
 
+EEnvironmentTheme AModularEnvironmentSystem::GetThemeForLocation(FVector WorldLocation) const
+{
+    // Determine theme based on location (this could be more sophisticated)
+    if (FMath::Abs(WorldLocation.X) > 4000.0f)
+    {
+        return EEnvironmentTheme::Mountain;
+    }
+    
+    return EEnvironmentTheme::Forest;
+}
+
+void AModularEnvironmentSystem::NotifyThemeChanged(EEnvironmentTheme Theme)
+{
+    UWorld* World = GetWorld();
+    for (TObjectIterator<UAnimeEffectsManager> It; World && It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            It->SetEffectTheme(Theme);
+        }
+    }
+}
+
 FVector AModularEnvironmentSystem::GetChunkLocationFromWorldLocation(FVector WorldLocation)
 {
     FVector ChunkLocation;
@@ -431,12 +600,51 @@ void AModularEnvironmentSystem::CleanupDistantChunks(FVector PlayerLocation)
 
 void AModularEnvironmentSystem::UnloadEnvironmentChunk(FVector ChunkLocation)
 {
-    if (FEnvironmentChunkData* ChunkData = LoadedChunks.Find(ChunkLocation))
+    const FEnvironmentChunkData* ChunkData = LoadedChunks.Find(ChunkLocation);
+    if (!ChunkData)
     {
-        // For instanced meshes, we would need to track which instances belong to which chunk
-        // This is a simplified version - in practice, you'd want to track instance indices
-        
-        LoadedChunks.Remove(ChunkLocation);
+        return;
+    }
+    
+    // Ascending instance indices of this chunk per component
+    TMap<UInstancedStaticMeshComponent*, TArray<int32>> RemovedInstances;
+    for (int32 i = 0; i < ChunkData->InstanceIndices.Num(); i++)
+    {
+        const int32 InstanceIndex = ChunkData->InstanceIndices[i];
+        UInstancedStaticMeshComponent* InstancedComp = InstanceIndex != INDEX_NONE ? InstancedMeshComponents.FindRef(ChunkData->PieceTypes[i]) : nullptr;
+        if (InstancedComp)
+        {
+            RemovedInstances.FindOrAdd(InstancedComp).Add(InstanceIndex);
+        }
+    }
+    
+    for (TPair<UInstancedStaticMeshComponent*, TArray<int32>>& Removed : RemovedInstances)
+    {
+        Removed.Value.Sort();
+        // Removes from the highest index down, so each removal leaves the lower indices in place
+        Removed.Key->RemoveInstances(Removed.Value);
+    }
+    
+    LoadedChunks.Remove(ChunkLocation);
+    
+    if (RemovedInstances.Num() == 0)
+    {
+        return;
+    }
+    
+    // Our components don't remove by swap, so every later instance moved down by the removed instances below it
+    for (TPair<FVector, FEnvironmentChunkData>& ChunkPair : LoadedChunks)
+    {
+        FEnvironmentChunkData& OtherChunk = ChunkPair.Value;
+        for (int32 i = 0; i < OtherChunk.InstanceIndices.Num(); i++)
+        {
+            int32& InstanceIndex = OtherChunk.InstanceIndices[i];
+            const TArray<int32>* Removed = InstanceIndex != INDEX_NONE ? RemovedInstances.Find(InstancedMeshComponents.FindRef(OtherChunk.PieceTypes[i])) : nullptr;
+            if (Removed)
+            {
+                InstanceIndex -= Algo::LowerBound(*Removed, InstanceIndex);
+            }
+        }
     }
 }
 
@@ -478,3 +686,57 @@ void AModularEnvironmentSystem::SetLODDistances(float LOD1Distance, float LOD2Di
         }
     }
 }
+
+void AModularEnvironmentSystem::SetPerformanceBudget(float InstanceScale, int32 DrawCallBudget)
+{
+    InstanceBudgetScale = FMath::Clamp(InstanceScale, 0.1f, 1.0f);
+    MaxDrawCalls = DrawCallBudget;
+    
+    // Chunks that are already loaded keep their instances; new chunks use the new budget
+    UE_LOG(LogTemp, Log, TEXT("Environment budget: instance scale %.2f, max draw calls %d"), InstanceBudgetScale, MaxDrawCalls);
+}
+
+void AModularEnvironmentSystem::UpdateStats() const
+{
+#if STATS
+    INC_DWORD_STAT_BY(STAT_AWR_ISMInstances, GetInstanceCount());
+    SET_MEMORY_STAT(STAT_AWR_ISMInstanceMemory, GetInstanceMemoryBytes());
+    SET_MEMORY_STAT(STAT_AWR_ChunkLayoutMemory, GetChunkDataMemoryBytes());
+#endif
+}
+
+int32 AModularEnvironmentSystem::GetInstanceCount() const
+{
+    int32 InstanceCount = 0;
+    for (const auto& ComponentPair : InstancedMeshComponents)
+    {
+        if (const UInstancedStaticMeshComponent* InstancedComp = ComponentPair.Value)
+        {
+            InstanceCount += InstancedComp->GetInstanceCount();
+        }
+    }
+    return InstanceCount;
+}
+
+int64 AModularEnvironmentSystem::GetInstanceMemoryBytes() const
+{
+    int64 InstanceBytes = 0;
+    for (const auto& ComponentPair : InstancedMeshComponents)
+    {
+        if (const UInstancedStaticMeshComponent* InstancedComp = ComponentPair.Value)
+        {
+            InstanceBytes += InstancedComp->PerInstanceSMData.GetAllocatedSize() + InstancedComp->PerInstanceSMCustomData.GetAllocatedSize();
+        }
+    }
+    return InstanceBytes;
+}
+
+int64 AModularEnvironmentSystem::GetChunkDataMemoryBytes() const
+{
+    int64 ChunkBytes = LoadedChunks.GetAllocatedSize();
+    for (const auto& ChunkPair : LoadedChunks)
+    {
+        ChunkBytes += ChunkPair.Value.PieceTransforms.GetAllocatedSize() + ChunkPair.Value.PieceTypes.GetAllocatedSize() + ChunkPair.Value.InstanceIndices.GetAllocatedSize();
+    }
+    return ChunkBytes;
+}
@@ -1,4 +1,6 @@
 #include "GameModes/AWRGameModeBase.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "AnimeRunnerCharacter.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
@@ -37,6 +39,9 @@ void AAWRGameModeBase::BeginPlay()
 
 void AAWRGameModeBase::Tick(float DeltaTime)
 {
+    AWR_HITCH_SCOPE(GameMode);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_GameModeTick, AWRGameplayChannel, "AAWRGameModeBase::Tick");
+    
     Super::Tick(DeltaTime);
     
     if (CurrentGameState == EGameState::PLAYING)
@@ -1,9 +1,200 @@
 #include "Materials/AnimeMaterialManager.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
+#include "Optimization/SubsystemMemoryTracker.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Materials/MaterialInterface.h"
 #include "Components/MeshComponent.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Materials/Material.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace MaterialSettings
+{
+    static TAutoConsoleVariable<int32> CVarUseParameterCollection(
+        TEXT("AWR.Materials.UseParameterCollection"),
+        1,
+        TEXT("Writes global material parameters once to the parameter collection instead of to every dynamic material."));
+    
+    static TAutoConsoleVariable<int32> CVarRegistryPrunePerFrame(
+        TEXT("AWR.Materials.RegistryPrunePerFrame"),
+        16,
+        TEXT("Number of material registry slots checked for collected materials each frame."));
+    
+    static const FName GlobalTimeParameter(TEXT("GlobalTime"));
+    static const FName GlobalLightDirectionParameter(TEXT("GlobalLightDirection"));
+    static const FName TimeOfDayParameter(TEXT("TimeOfDay"));
+    static const FName TileScaleParameter(TEXT("TileScale"));
+    static const FName WaveSpeedParameter(TEXT("WaveSpeed"));
+    static const FName WaveScaleParameter(TEXT("WaveScale"));
+    static const FName RefractionParameter(TEXT("Refraction"));
+    static const FName BaseColorTextureParameter(TEXT("BaseColorTexture"));
+    static const FName NormalTextureParameter(TEXT("NormalTexture"));
+    static const FName PackedTextureParameter(TEXT("PackedTexture"));
+    
+    // Settings parameters, in the order every dynamic material initializes them
+    enum EScalarSetting : int32
+    {
+        ShadowThresholdSetting,
+        ShadowSmoothnessSetting,
+        RimIntensitySetting,
+        RimPowerSetting,
+        OutlineThicknessSetting,
+        EnableOutlineSetting,
+        EmissionIntensitySetting,
+        WindStrengthSetting,
+        AnimationSpeedSetting,
+        NumScalarSettings
+    };
+    
+    enum EVectorSetting : int32
+    {
+        MainColorSetting,
+        ShadowColorSetting,
+        RimColorSetting,
+        OutlineColorSetting,
+        EmissionColorSetting,
+        NumVectorSettings
+    };
+    
+    static_assert(NumScalarSettings == FAnimeMaterialParameterLayout::NumScalars, "Layout holds one index per scalar setting");
+    static_assert(NumVectorSettings == FAnimeMaterialParameterLayout::NumVectors, "Layout holds one index per vector setting");
+    
+    static const FName ScalarSettingNames[NumScalarSettings] =
+    {
+        TEXT("ShadowThreshold"),
+        TEXT("ShadowSmoothness"),
+        TEXT("RimIntensity"),
+        TEXT("RimPower"),
+        TEXT("OutlineThickness"),
+        TEXT("EnableOutline"),
+        TEXT("EmissionIntensity"),
+        TEXT("WindStrength"),
+        TEXT("AnimationSpeed")
+    };
+    
+    static const FName VectorSettingNames[NumVectorSettings] =
+    {
+        TEXT("MainColor"),
+        TEXT("ShadowColor"),
+        TEXT("RimColor"),
+        TEXT("OutlineColor"),
+        TEXT("EmissionColor")
+    };
+    
+    static void GatherSettings(const FAnimeMaterialSettings& Settings, float (&OutScalars)[NumScalarSettings], FLinearColor (&OutVectors)[NumVectorSettings])
+    {
+        OutScalars[ShadowThresholdSetting] = Settings.ShadowThreshold;
+        OutScalars[ShadowSmoothnessSetting] = Settings.ShadowSmoothness;
+        OutScalars[RimIntensitySetting] = Settings.RimIntensity;
+        OutScalars[RimPowerSetting] = Settings.RimPower;
+        OutScalars[OutlineThicknessSetting] = Settings.OutlineThickness;
+        OutScalars[EnableOutlineSetting] = Settings.bEnableOutline ? 1.0f : 0.0f;
+        OutScalars[EmissionIntensitySetting] = Settings.EmissionIntensity;
+        OutScalars[WindStrengthSetting] = Settings.WindStrength;
+        OutScalars[AnimationSpeedSetting] = Settings.AnimationSpeed;
+        
+        OutVectors[MainColorSetting] = Settings.MainColor;
+        OutVectors[ShadowColorSetting] = Settings.ShadowColor;
+        OutVectors[RimColorSetting] = Settings.RimColor;
+        OutVectors[OutlineColorSetting] = Settings.OutlineColor;
+        OutVectors[EmissionColorSetting] = Settings.EmissionColor;
+    }
+    
+    static float GetQualityMultiplier(int32 QualityLevel)
+    {
+        switch (QualityLevel)
+        {
+            case 0: // Low
+                return 0.5f;
+            case 1: // Medium
+                return 0.75f;
+            case 3: // Ultra
+                return 1.25f;
+            default: // High
+                return 1.0f;
+        }
+    }
+    
+    static uint32 HashColor(const FLinearColor& Color)
+    {
+        return HashCombine(HashCombine(GetTypeHash(Color.R), GetTypeHash(Color.G)), HashCombine(GetTypeHash(Color.B), GetTypeHash(Color.A)));
+    }
+    
+    // Values only; the cache key compares the assets through object keys
+    static uint32 HashSettings(const FAnimeMaterialSettings& Settings)
+    {
+        uint32 Hash = HashColor(Settings.MainColor);
+        Hash = HashCombine(Hash, HashColor(Settings.ShadowColor));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.ShadowThreshold));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.ShadowSmoothness));
+        Hash = HashCombine(Hash, HashColor(Settings.RimColor));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.RimIntensity));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.RimPower));
+        Hash = HashCombine(Hash, HashColor(Settings.OutlineColor));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.OutlineThickness));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.bEnableOutline));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.EmissionIntensity));
+        Hash = HashCombine(Hash, HashColor(Settings.EmissionColor));
+        Hash = HashCombine(Hash, GetTypeHash(Settings.WindStrength));
+        return HashCombine(Hash, GetTypeHash(Settings.AnimationSpeed));
+    }
+    
+    static bool SettingsEqual(const FAnimeMaterialSettings& A, const FAnimeMaterialSettings& B)
+    {
+        return A.MainColor == B.MainColor
+            && A.ShadowColor == B.ShadowColor
+            && A.ShadowThreshold == B.ShadowThreshold
+            && A.ShadowSmoothness == B.ShadowSmoothness
+            && A.RimColor == B.RimColor
+            && A.RimIntensity == B.RimIntensity
+            && A.RimPower == B.RimPower
+            && A.OutlineColor == B.OutlineColor
+            && A.OutlineThickness == B.OutlineThickness
+            && A.bEnableOutline == B.bEnableOutline
+            && A.EmissionIntensity == B.EmissionIntensity
+            && A.EmissionColor == B.EmissionColor
+            && A.WindStrength == B.WindStrength
+            && A.AnimationSpeed == B.AnimationSpeed;
+    }
+}
+
+FAnimeMaterialCacheKey::FAnimeMaterialCacheKey(EAnimeMaterialType InMaterialType, const FAnimeMaterialSettings& InSettings, TArrayView<const TPair<FName, float>> InExtraScalars)
+    : MaterialType(InMaterialType)
+    , BaseMaterial(InSettings.BaseMaterial)
+    , BaseColorTexture(InSettings.BaseColorTexture)
+    , NormalTexture(InSettings.NormalTexture)
+    , PackedTexture(InSettings.PackedTexture)
+    , Settings(InSettings)
+    , ExtraScalars(InExtraScalars.GetData(), InExtraScalars.Num())
+{
+    Settings.BaseMaterial = nullptr;
+    Settings.BaseColorTexture = nullptr;
+    Settings.NormalTexture = nullptr;
+    Settings.PackedTexture = nullptr;
+    
+    Hash = HashCombine(GetTypeHash(MaterialType), MaterialSettings::HashSettings(Settings));
+    Hash = HashCombine(Hash, HashCombine(GetTypeHash(BaseMaterial), GetTypeHash(BaseColorTexture)));
+    Hash = HashCombine(Hash, HashCombine(GetTypeHash(NormalTexture), GetTypeHash(PackedTexture)));
+    for (const TPair<FName, float>& Scalar : ExtraScalars)
+    {
+        Hash = HashCombine(Hash, HashCombine(GetTypeHash(Scalar.Key), GetTypeHash(Scalar.Value)));
+    }
+}
+
+bool FAnimeMaterialCacheKey::operator==(const FAnimeMaterialCacheKey& Other) const
+{
+    return Hash == Other.Hash
+        && MaterialType == Other.MaterialType
+        && BaseMaterial == Other.BaseMaterial
+        && BaseColorTexture == Other.BaseColorTexture
+        && NormalTexture == Other.NormalTexture
+        && PackedTexture == Other.PackedTexture
+        && ExtraScalars == Other.ExtraScalars
+        && MaterialSettings::SettingsEqual(Settings, Other.Settings);
+}
 
 UAnimeMaterialManager::UAnimeMaterialManager()
 {
@@ -14,6 +205,15 @@ UAnimeMaterialManager::UAnimeMaterialManager()
     GlobalTimeOfDay = 0.5f; // Noon
     bMobileOptimization = true;
     CurrentQualityLevel = 2; // Medium quality by default
+    GlobalUpdateRate = 0.0f; // Every frame
+    GlobalUpdateTimer = 0.0f;
+    GlobalParameterCollection = nullptr;
+    GlobalParameterInstance = nullptr;
+    bGlobalLightingDirty = true;
+    bUsingParameterCollection = false;
+    NumCacheHits = 0;
+    NumCacheMisses = 0;
+    NumPrunedMaterials = 0;
 }
 
 void UAnimeMaterialManager::BeginPlay()
@@ -21,13 +221,52 @@ void UAnimeMaterialManager::BeginPlay()
     Super::BeginPlay();
     
     InitializeMaterialTemplates();
+    
+    if (GlobalParameterCollection && GetWorld())
+    {
+        GlobalParameterInstance = GetWorld()->GetParameterCollectionInstance(GlobalParameterCollection);
+    }
 }
 
 void UAnimeMaterialManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    AWR_HITCH_SCOPE(Materials);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_MaterialsTick, AWRMaterialsChannel, "UAnimeMaterialManager::TickComponent");
+    
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
-    UpdateGlobalParameters();
+    const int32 NumPruned = PruneMaterials(MaterialSettings::CVarRegistryPrunePerFrame.GetValueOnGameThread());
+    
+    INC_DWORD_STAT_BY(STAT_AWR_ActiveMIDs, MaterialRegistry.Num());
+    INC_DWORD_STAT_BY(STAT_AWR_PrunedMIDs, NumPruned);
+    INC_DWORD_STAT_BY(STAT_AWR_MaterialTweens, MaterialTweens.Num());
+    SET_MEMORY_STAT(STAT_AWR_MaterialRegistryMemory, GetRegistryMemoryBytes());
+    
+    MaterialTweens.Tick(DeltaTime);
+    
+    if (GlobalUpdateRate <= 0.0f)
+    {
+        UpdateGlobalParameters();
+        return;
+    }
+    
+    GlobalUpdateTimer += DeltaTime;
+    if (GlobalUpdateTimer >= 1.0f / GlobalUpdateRate)
+    {
+        UpdateGlobalParameters();
+        GlobalUpdateTimer = 0.0f;
+    }
+}
+
+void UAnimeMaterialManager::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+    UAnimeMaterialManager* This = CastChecked<UAnimeMaterialManager>(InThis);
+    for (TPair<TObjectKey<UMaterialInstanceDynamic>, FSharedMaterialRef>& SharedPair : This->SharedMaterialRefs)
+    {
+        Collector.AddReferencedObject(SharedPair.Value.Material, This);
+    }
+    
+    Super::AddReferencedObjects(InThis, Collector);
 }
 
 void UAnimeMaterialManager::InitializeMaterialTemplates()
@@ -39,8 +278,36 @@ void UAnimeMaterialManager::InitializeMaterialTemplates()
     MaterialTemplates.Empty();
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateAnimeMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings)
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateAnimeMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings, bool bUniqueInstance)
+{
+    return AcquireMaterial(MaterialType, Settings, {}, bUniqueInstance);
+}
+
+UMaterialInstanceDynamic* UAnimeMaterialManager::AcquireMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings, TArrayView<const TPair<FName, float>> ExtraScalars, bool bUniqueInstance)
 {
+    AWR_HITCH_SCOPE(Materials);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_CreateMaterial, AWRMaterialsChannel, "UAnimeMaterialManager::CreateAnimeMaterial");
+    AWR_LLM_SCOPE(Materials);
+    
+    FAnimeMaterialCacheKey Key;
+    if (!bUniqueInstance)
+    {
+        Key = FAnimeMaterialCacheKey(MaterialType, Settings, ExtraScalars);
+        if (TWeakObjectPtr<UMaterialInstanceDynamic>* SharedMaterial = SharedMaterials.Find(Key))
+        {
+            if (UMaterialInstanceDynamic* Material = SharedMaterial->Get())
+            {
+                SharedMaterialRefs.FindChecked(Material).RefCount++;
+                NumCacheHits++;
+                return Material;
+            }
+            
+            // Collected before the registry got to it
+            SharedMaterials.Remove(Key);
+        }
+        NumCacheMisses++;
+    }
+    
     UMaterialInterface* BaseMaterial = nullptr;
     
     // Get base material template
@@ -59,13 +326,27 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateAnimeMaterial(EAnimeMater
         return nullptr;
     }
     
-    // Create dynamic material instance
-    UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+    // Create dynamic material instance on the permutation for the current quality tier
+    UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(GetQualityParent(BaseMaterial), this);
     
     if (DynamicMaterial)
     {
+        MaterialStates.Add(DynamicMaterial).BaseMaterial = BaseMaterial;
         UpdateMaterialParameters(DynamicMaterial, Settings);
-        ActiveMaterials.Add(DynamicMaterial);
+        for (const TPair<FName, float>& Scalar : ExtraScalars)
+        {
+            DynamicMaterial->SetScalarParameterValue(Scalar.Key, Scalar.Value);
+        }
+        MaterialRegistry.Add(DynamicMaterial);
+        
+        if (!bUniqueInstance)
+        {
+            SharedMaterials.Add(Key, DynamicMaterial);
+            FSharedMaterialRef& SharedRef = SharedMaterialRefs.Add(DynamicMaterial);
+            SharedRef.Key = MoveTemp(Key);
+            SharedRef.Material = DynamicMaterial;
+            SharedRef.RefCount = 1;
+        }
     }
     
     return DynamicMaterial;
@@ -73,60 +354,172 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateAnimeMaterial(EAnimeMater
 
 void UAnimeMaterialManager::ApplyMaterialToMesh(UMeshComponent* MeshComponent, UMaterialInstanceDynamic* Material, int32 MaterialIndex)
 {
+    Material = GetCurrentMaterial(Material);
     if (MeshComponent && Material)
     {
         MeshComponent->SetMaterial(MaterialIndex, Material);
+        
+        // Remember the slot so a quality tier change can rebind it
+        if (FAnimeMaterialTierState* State = MaterialStates.Find(Material))
+        {
+            State->MeshSlots.AddUnique(TPair<TWeakObjectPtr<UMeshComponent>, int32>(MeshComponent, MaterialIndex));
+        }
     }
 }
 
 void UAnimeMaterialManager::UpdateMaterialParameters(UMaterialInstanceDynamic* Material, const FAnimeMaterialSettings& Settings)
 {
+    Material = GetCurrentMaterial(Material);
     if (!Material) return;
     
+    // A shared instance belongs to every holder and to its cache key; editing it in place would change them all
+    if (IsSharedMaterial(Material))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not updating shared material %s: its settings are part of the cache key; create it as a unique instance to edit it"),
+            *Material->GetName());
+        return;
+    }
+    
     // Set base textures
     if (Settings.BaseColorTexture)
     {
-        Material->SetTextureParameterValue(FName("BaseColorTexture"), Settings.BaseColorTexture);
+        Material->SetTextureParameterValue(MaterialSettings::BaseColorTextureParameter, Settings.BaseColorTexture);
     }
     
     if (Settings.NormalTexture)
     {
-        Material->SetTextureParameterValue(FName("NormalTexture"), Settings.NormalTexture);
+        Material->SetTextureParameterValue(MaterialSettings::NormalTextureParameter, Settings.NormalTexture);
     }
     
     if (Settings.PackedTexture)
     {
-        Material->SetTextureParameterValue(FName("PackedTexture"), Settings.PackedTexture);
+        Material->SetTextureParameterValue(MaterialSettings::PackedTextureParameter, Settings.PackedTexture);
     }
     
-    // Set cel-shading parameters
-    Material->SetVectorParameterValue(FName("MainColor"), Settings.MainColor);
-    Material->SetVectorParameterValue(FName("ShadowColor"), Settings.ShadowColor);
-    Material->SetScalarParameterValue(FName("ShadowThreshold"), Settings.ShadowThreshold);
-    Material->SetScalarParameterValue(FName("ShadowSmoothness"), Settings.ShadowSmoothness);
+    float Scalars[MaterialSettings::NumScalarSettings];
+    FLinearColor Vectors[MaterialSettings::NumVectorSettings];
+    MaterialSettings::GatherSettings(Settings, Scalars, Vectors);
     
-    // Set rim lighting parameters
-    Material->SetVectorParameterValue(FName("RimColor"), Settings.RimColor);
-    Material->SetScalarParameterValue(FName("RimIntensity"), Settings.RimIntensity);
-    Material->SetScalarParameterValue(FName("RimPower"), Settings.RimPower);
+    // Keep the unscaled values so quality changes rescale from them instead of from the last write
+    if (FAnimeMaterialTierState* State = MaterialStates.Find(Material))
+    {
+        State->OutlineThickness = Scalars[MaterialSettings::OutlineThicknessSetting];
+        State->RimIntensity = Scalars[MaterialSettings::RimIntensitySetting];
+        State->ShadowSmoothness = Scalars[MaterialSettings::ShadowSmoothnessSetting];
+        ScaleForQuality(Scalars);
+    }
     
-    // Set outline parameters
-    Material->SetVectorParameterValue(FName("OutlineColor"), Settings.OutlineColor);
-    Material->SetScalarParameterValue(FName("OutlineThickness"), Settings.OutlineThickness);
-    Material->SetScalarParameterValue(FName("EnableOutline"), Settings.bEnableOutline ? 1.0f : 0.0f);
+    // Cel-shading, rim, outline and effect parameters go through their resolved indices
+    WriteSettingsParameters(Material, Scalars, Vectors);
     
-    // Set special effects
-    Material->SetScalarParameterValue(FName("EmissionIntensity"), Settings.EmissionIntensity);
-    Material->SetVectorParameterValue(FName("EmissionColor"), Settings.EmissionColor);
-    Material->SetScalarParameterValue(FName("WindStrength"), Settings.WindStrength);
-    Material->SetScalarParameterValue(FName("AnimationSpeed"), Settings.AnimationSpeed);
+    // Global parameters come from the parameter collection when there is one
+    if (!GlobalParameterInstance || !MaterialSettings::CVarUseParameterCollection.GetValueOnGameThread())
+    {
+        Material->SetVectorParameterValue(MaterialSettings::GlobalLightDirectionParameter, FLinearColor(GlobalLightDirection.X, GlobalLightDirection.Y, GlobalLightDirection.Z, 0.0f));
+        Material->SetScalarParameterValue(MaterialSettings::TimeOfDayParameter, GlobalTimeOfDay);
+    }
+}
+
+void UAnimeMaterialManager::WriteSettingsParameters(UMaterialInstanceDynamic* Material, const float* Scalars, const FLinearColor* Vectors)
+{
+    const FAnimeMaterialParameterLayout* Layout = FindParameterLayout(Material);
+    if (!Layout)
+    {
+        InitializeSettingsParameters(Material, Scalars, Vectors);
+        return;
+    }
     
-    // Set global parameters
-    Material->SetVectorParameterValue(FName("GlobalLightDirection"), FLinearColor(GlobalLightDirection.X, GlobalLightDirection.Y, GlobalLightDirection.Z, 0.0f));
-    Material->SetScalarParameterValue(FName("TimeOfDay"), GlobalTimeOfDay);
+    for (int32 i = 0; i < MaterialSettings::NumScalarSettings; i++)
+    {
+        Material->SetScalarParameterByIndex(Layout->ScalarIndices[i], Scalars[i]);
+    }
+    for (int32 i = 0; i < MaterialSettings::NumVectorSettings; i++)
+    {
+        Material->SetVectorParameterByIndex(Layout->VectorIndices[i], Vectors[i]);
+    }
+}
+
+void UAnimeMaterialManager::InitializeSettingsParameters(UMaterialInstanceDynamic* Material, const float* Scalars, const FLinearColor* Vectors)
+{
+    FAnimeMaterialParameterLayout Layout;
+    for (int32 i = 0; i < MaterialSettings::NumScalarSettings; i++)
+    {
+        Material->InitializeScalarParameterAndGetIndex(MaterialSettings::ScalarSettingNames[i], Scalars[i], Layout.ScalarIndices[i]);
+    }
+    for (int32 i = 0; i < MaterialSettings::NumVectorSettings; i++)
+    {
+        Material->InitializeVectorParameterAndGetIndex(MaterialSettings::VectorSettingNames[i], Vectors[i], Layout.VectorIndices[i]);
+    }
+    
+    // Later instances of the same base material initialize in this order and share the layout
+    UMaterialInterface* ParentMaterial = Material->Parent;
+    if (ParentMaterial && !ParameterLayouts.Contains(ParentMaterial))
+    {
+        ParameterLayouts.Add(ParentMaterial, Layout);
+    }
+}
+
+const FAnimeMaterialParameterLayout* UAnimeMaterialManager::FindParameterLayout(const UMaterialInstanceDynamic* Material) const
+{
+    const UMaterialInterface* ParentMaterial = Material->Parent;
+    const FAnimeMaterialParameterLayout* Layout = ParentMaterial ? ParameterLayouts.Find(ParentMaterial) : nullptr;
+    if (!Layout)
+    {
+        return nullptr;
+    }
+    
+    // A material whose settings were never initialized, or were initialized out of order or only in part,
+    // is not laid out like its siblings; every entry is checked, a name compare each
+    for (int32 Setting = 0; Setting < MaterialSettings::NumScalarSettings; Setting++)
+    {
+        const int32 Index = Layout->ScalarIndices[Setting];
+        if (!Material->ScalarParameterValues.IsValidIndex(Index) || Material->ScalarParameterValues[Index].ParameterInfo.Name != MaterialSettings::ScalarSettingNames[Setting])
+        {
+            return nullptr;
+        }
+    }
+    for (int32 Setting = 0; Setting < MaterialSettings::NumVectorSettings; Setting++)
+    {
+        const int32 Index = Layout->VectorIndices[Setting];
+        if (!Material->VectorParameterValues.IsValidIndex(Index) || Material->VectorParameterValues[Index].ParameterInfo.Name != MaterialSettings::VectorSettingNames[Setting])
+        {
+            return nullptr;
+        }
+    }
+    return Layout;
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateCharacterMaterial(FLinearColor MainColor, FLinearColor ShadowColor)
+void UAnimeMaterialManager::ReleaseMaterial(UMaterialInstanceDynamic* Material)
+{
+    Material = GetCurrentMaterial(Material);
+    if (!Material) return;
+    
+    if (FSharedMaterialRef* SharedRef = SharedMaterialRefs.Find(Material))
+    {
+        if (--SharedRef->RefCount > 0) return;
+        
+        SharedMaterials.Remove(SharedRef->Key);
+        SharedMaterialRefs.Remove(Material);
+    }
+    
+    MaterialTweens.Stop(Material);
+    MaterialStates.Remove(Material);
+    ForgetRedirectsTo(Material);
+    
+    MaterialRegistry.Remove(MaterialRegistry.Find(Material));
+}
+
+int32 UAnimeMaterialManager::GetMaterialUserCount() const
+{
+    int32 UserCount = MaterialRegistry.Num();
+    for (const auto& SharedPair : SharedMaterialRefs)
+    {
+        UserCount += SharedPair.Value.RefCount - 1;
+    }
+    return UserCount;
+}
+
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateCharacterMaterial(FLinearColor MainColor, FLinearColor ShadowColor, bool bUniqueInstance)
 {
     FAnimeMaterialSettings Settings;
     Settings.MainColor = MainColor;
@@ -139,10 +532,10 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateCharacterMaterial(FLinear
     Settings.bEnableOutline = true;
     Settings.OutlineThickness = 0.008f;
     
-    return CreateAnimeMaterial(EAnimeMaterialType::Character, Settings);
+    return CreateAnimeMaterial(EAnimeMaterialType::Character, Settings, bUniqueInstance);
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateHairMaterial(FLinearColor HairColor, float Shininess)
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateHairMaterial(FLinearColor HairColor, float Shininess, bool bUniqueInstance)
 {
     FAnimeMaterialSettings Settings;
     Settings.MainColor = HairColor;
@@ -155,10 +548,10 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateHairMaterial(FLinearColor
     Settings.bEnableOutline = true;
     Settings.OutlineThickness = 0.006f;
     
-    return CreateAnimeMaterial(EAnimeMaterialType::Hair, Settings);
+    return CreateAnimeMaterial(EAnimeMaterialType::Hair, Settings, bUniqueInstance);
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateClothingMaterial(FLinearColor ClothColor, UTexture2D* Pattern)
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateClothingMaterial(FLinearColor ClothColor, UTexture2D* Pattern, bool bUniqueInstance)
 {
     FAnimeMaterialSettings Settings;
     Settings.MainColor = ClothColor;
@@ -172,10 +565,10 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateClothingMaterial(FLinearC
     Settings.OutlineThickness = 0.01f;
     Settings.BaseColorTexture = Pattern;
     
-    return CreateAnimeMaterial(EAnimeMaterialType::Clothing, Settings);
+    return CreateAnimeMaterial(EAnimeMaterialType::Clothing, Settings, bUniqueInstance);
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateEnvironmentMaterial(UTexture2D* BaseTexture, float TileScale)
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateEnvironmentMaterial(UTexture2D* BaseTexture, float TileScale, bool bUniqueInstance)
 {
     FAnimeMaterialSettings Settings;
     Settings.MainColor = FLinearColor::White;
@@ -188,17 +581,13 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateEnvironmentMaterial(UText
     Settings.bEnableOutline = false;
     Settings.BaseColorTexture = BaseTexture;
     
-    UMaterialInstanceDynamic* Material = CreateAnimeMaterial(EAnimeMaterialType::Environment, Settings);
-    
-    if (Material)
-    {
-        Material->SetScalarParameterValue(FName("TileScale"), TileScale);
-    }
+    // Part of the cache key, so chunks with the same texture and tiling share one material
+    const TPair<FName, float> ExtraScalars[] = { { MaterialSettings::TileScaleParameter, TileScale } };
     
-    return Material;
+    return AcquireMaterial(EAnimeMaterialType::Environment, Settings, ExtraScalars, bUniqueInstance);
 }
 
-UMaterialInstanceDynamic* UAnimeMaterialManager::CreateWaterMaterial(FLinearColor WaterColor, float WaveSpeed)
+UMaterialInstanceDynamic* UAnimeMaterialManager::CreateWaterMaterial(FLinearColor WaterColor, float WaveSpeed, bool bUniqueInstance)
 {
     FAnimeMaterialSettings Settings;
     Settings.MainColor = WaterColor;
@@ -213,148 +602,560 @@ UMaterialInstanceDynamic* UAnimeMaterialManager::CreateWaterMaterial(FLinearColo
     Settings.EmissionIntensity = 0.2f;
     Settings.EmissionColor = WaterColor;
     
-    UMaterialInstanceDynamic* Material = CreateAnimeMaterial(EAnimeMaterialType::Water, Settings);
-    
-    if (Material)
+    const TPair<FName, float> ExtraScalars[] =
     {
-        Material->SetScalarParameterValue(FName("WaveSpeed"), WaveSpeed);
-        Material->SetScalarParameterValue(FName("WaveScale"), 1.0f);
-        Material->SetScalarParameterValue(FName("Refraction"), 0.1f);
-    }
+        { MaterialSettings::WaveSpeedParameter, WaveSpeed },
+        { MaterialSettings::WaveScaleParameter, 1.0f },
+        { MaterialSettings::RefractionParameter, 0.1f }
+    };
     
-    return Material;
+    return AcquireMaterial(EAnimeMaterialType::Water, Settings, ExtraScalars, bUniqueInstance);
 }
 
-void UAnimeMaterialManager::StartMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration)
+void UAnimeMaterialManager::StartMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration, EMaterialTweenEasing Easing)
 {
+    Material = GetCurrentMaterial(Material);
     if (!Material || Duration <= 0.0f) return;
     
-    // Set initial value
-    Material->SetScalarParameterValue(ParameterName, StartValue);
+    if (IsSharedMaterial(Material))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not animating %s on shared material %s: it would change every mesh using it; create it as a unique instance"),
+            *ParameterName.ToString(), *Material->GetName());
+        return;
+    }
     
-    // Create timer for animation
-    FTimerHandle AnimationTimer;
-    float ElapsedTime = 0.0f;
+    MaterialTweens.Start(Material, ParameterName, StartValue, EndValue, Duration, Easing);
+}
+
+void UAnimeMaterialManager::StopMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName)
+{
+    MaterialTweens.Stop(GetCurrentMaterial(Material), ParameterName);
+}
+
+void UAnimeMaterialManager::SetGlobalLightDirection(FVector LightDirection)
+{
+    const FVector NewDirection = LightDirection.GetSafeNormal();
+    if (!NewDirection.Equals(GlobalLightDirection))
+    {
+        GlobalLightDirection = NewDirection;
+        bGlobalLightingDirty = true;
+    }
+}
+
+void UAnimeMaterialManager::SetGlobalTimeOfDay(float TimeOfDay)
+{
+    const float NewTimeOfDay = FMath::Clamp(TimeOfDay, 0.0f, 1.0f);
+    if (NewTimeOfDay != GlobalTimeOfDay)
+    {
+        GlobalTimeOfDay = NewTimeOfDay;
+        bGlobalLightingDirty = true;
+    }
+}
+
+void UAnimeMaterialManager::OptimizeForMobile(bool bEnableOptimization)
+{
+    bMobileOptimization = bEnableOptimization;
     
-    GetWorld()->GetTimerManager().SetTimer(AnimationTimer, [this, Material, ParameterName, StartValue, EndValue, Duration, ElapsedTime]() mutable
+    // Thinner outlines, softer rim and smoother shadows, computed from each material's own settings
+    MaterialRegistry.ForEach([this](UMaterialInstanceDynamic* Material)
     {
-        ElapsedTime += 0.016f; // ~60 FPS
-        float Alpha = FMath::Clamp(ElapsedTime / Duration, 0.0f, 1.0f);
-        float CurrentValue = FMath::Lerp(StartValue, EndValue, Alpha);
-        
-        if (Material)
+        if (const FAnimeMaterialTierState* State = MaterialStates.Find(Material))
         {
-            Material->SetScalarParameterValue(ParameterName, CurrentValue);
+            ApplyQualityScalars(Material, *State);
         }
-        
-        if (Alpha >= 1.0f)
+    });
+}
+
+void UAnimeMaterialManager::SetQualityLevel(int32 QualityLevel)
+{
+    CurrentQualityLevel = FMath::Clamp(QualityLevel, 0, 3);
+    
+    // Cheaper shader permutations first, then the scalars on whatever parent each material ended up with
+    SwapQualityPermutations();
+    
+    MaterialRegistry.ForEach([this](UMaterialInstanceDynamic* Material)
+    {
+        if (const FAnimeMaterialTierState* State = MaterialStates.Find(Material))
         {
-            GetWorld()->GetTimerManager().ClearTimer(MaterialAnimationTimers[Material]);
-            MaterialAnimationTimers.Remove(Material);
+            ApplyQualityScalars(Material, *State);
         }
-    }, 0.016f, true);
-    
-    MaterialAnimationTimers.Add(Material, AnimationTimer);
+    });
 }
 
-void UAnimeMaterialManager::SetGlobalLightDirection(FVector LightDirection)
+void UAnimeMaterialManager::SetQualityPermutations(UMaterialInterface* BaseMaterial, const FAnimeMaterialQualityPermutations& Permutations)
 {
-    GlobalLightDirection = LightDirection.GetSafeNormal();
+    if (BaseMaterial)
+    {
+        QualityPermutations.Add(BaseMaterial, Permutations);
+    }
 }
 
-void UAnimeMaterialManager::SetGlobalTimeOfDay(float TimeOfDay)
+UMaterialInterface* UAnimeMaterialManager::GetQualityParent(UMaterialInterface* BaseMaterial) const
 {
-    GlobalTimeOfDay = FMath::Clamp(TimeOfDay, 0.0f, 1.0f);
+    const FAnimeMaterialQualityPermutations* Permutations = BaseMaterial ? QualityPermutations.Find(BaseMaterial) : nullptr;
+    if (Permutations)
+    {
+        // Low falls back to the Medium permutation when it has none of its own
+        if (CurrentQualityLevel == 0 && Permutations->Low)
+        {
+            return Permutations->Low;
+        }
+        if (CurrentQualityLevel <= 1 && Permutations->Medium)
+        {
+            return Permutations->Medium;
+        }
+    }
+    return BaseMaterial;
 }
 
-void UAnimeMaterialManager::OptimizeForMobile(bool bEnableOptimization)
+void UAnimeMaterialManager::ScaleForQuality(float (&Scalars)[FAnimeMaterialParameterLayout::NumScalars]) const
 {
-    bMobileOptimization = bEnableOptimization;
+    const float QualityMultiplier = MaterialSettings::GetQualityMultiplier(CurrentQualityLevel);
+    
+    Scalars[MaterialSettings::OutlineThicknessSetting] *= QualityMultiplier * (bMobileOptimization ? 0.7f : 1.0f);
+    Scalars[MaterialSettings::RimIntensitySetting] *= QualityMultiplier * (bMobileOptimization ? 0.8f : 1.0f);
     
     if (bMobileOptimization)
     {
-        // Apply mobile optimizations to all active materials
-        for (UMaterialInstanceDynamic* Material : ActiveMaterials)
+        Scalars[MaterialSettings::ShadowSmoothnessSetting] = 0.2f;
+    }
+}
+
+void UAnimeMaterialManager::ApplyQualityScalars(UMaterialInstanceDynamic* Material, const FAnimeMaterialTierState& State)
+{
+    const FAnimeMaterialParameterLayout* Layout = FindParameterLayout(Material);
+    
+    float Scalars[MaterialSettings::NumScalarSettings] = {};
+    Scalars[MaterialSettings::OutlineThicknessSetting] = State.OutlineThickness;
+    Scalars[MaterialSettings::RimIntensitySetting] = State.RimIntensity;
+    Scalars[MaterialSettings::ShadowSmoothnessSetting] = State.ShadowSmoothness;
+    ScaleForQuality(Scalars);
+    
+    const MaterialSettings::EScalarSetting QualitySettings[] =
+    {
+        MaterialSettings::OutlineThicknessSetting,
+        MaterialSettings::RimIntensitySetting,
+        MaterialSettings::ShadowSmoothnessSetting
+    };
+    for (MaterialSettings::EScalarSetting Setting : QualitySettings)
+    {
+        // Instances that do not match their base material's layout are still written, by name
+        if (!Layout || !Material->SetScalarParameterByIndex(Layout->ScalarIndices[Setting], Scalars[Setting]))
         {
-            if (Material)
-            {
-                // Reduce outline thickness for mobile
-                float CurrentOutlineThickness;
-                if (Material->GetScalarParameterValue(FName("OutlineThickness"), CurrentOutlineThickness))
-                {
-                    Material->SetScalarParameterValue(FName("OutlineThickness"), CurrentOutlineThickness * 0.7f);
-                }
-                
-                // Reduce rim lighting intensity
-                float CurrentRimIntensity;
-                if (Material->GetScalarParameterValue(FName("RimIntensity"), CurrentRimIntensity))
-                {
-                    Material->SetScalarParameterValue(FName("RimIntensity"), CurrentRimIntensity * 0.8f);
-                }
-                
-                // Increase shadow smoothness for better performance
-                Material->SetScalarParameterValue(FName("ShadowSmoothness"), 0.2f);
-            }
+            Material->SetScalarParameterValue(MaterialSettings::ScalarSettingNames[Setting], Scalars[Setting]);
         }
     }
 }
 
-void UAnimeMaterialManager::SetQualityLevel(int32 QualityLevel)
+void UAnimeMaterialManager::SwapQualityPermutations()
 {
-    CurrentQualityLevel = FMath::Clamp(QualityLevel, 0, 3);
+    AWR_HITCH_SCOPE(Materials);
+    AWR_LLM_SCOPE(Materials);
     
-    float QualityMultiplier = 1.0f;
+    TMap<UMaterialInstanceDynamic*, UMaterialInstanceDynamic*> Replacements;
     
-    switch (CurrentQualityLevel)
+    // Collected up front since replacing materials rewrites the registry slots
+    TArray<UMaterialInstanceDynamic*> Materials;
+    Materials.Reserve(MaterialRegistry.Num());
+    MaterialRegistry.ForEach([&Materials](UMaterialInstanceDynamic* Material) { Materials.Add(Material); });
+    
+    for (UMaterialInstanceDynamic* OldMaterial : Materials)
     {
-        case 0: // Low
-            QualityMultiplier = 0.5f;
-            break;
-        case 1: // Medium
-            QualityMultiplier = 0.75f;
-            break;
-        case 2: // High
-            QualityMultiplier = 1.0f;
-            break;
-        case 3: // Ultra
-            QualityMultiplier = 1.25f;
-            break;
+        FAnimeMaterialTierState* State = MaterialStates.Find(OldMaterial);
+        UMaterialInterface* TierParent = State ? GetQualityParent(State->BaseMaterial.Get()) : nullptr;
+        if (!TierParent || OldMaterial->Parent == TierParent)
+        {
+            continue;
+        }
+        
+        // Dynamic instances cannot change parent, so rebuild on the tier parent with the same overrides
+        UMaterialInstanceDynamic* NewMaterial = UMaterialInstanceDynamic::Create(TierParent, this);
+        if (!NewMaterial)
+        {
+            continue;
+        }
+        NewMaterial->CopyParameterOverrides(OldMaterial);
+        
+        // The copied parameter arrays keep their order, so the old layout fits the new parent
+        if (const FAnimeMaterialParameterLayout* OldLayout = FindParameterLayout(OldMaterial))
+        {
+            if (!ParameterLayouts.Contains(TierParent))
+            {
+                const FAnimeMaterialParameterLayout Layout = *OldLayout;
+                ParameterLayouts.Add(TierParent, Layout);
+            }
+        }
+        
+        for (const TPair<TWeakObjectPtr<UMeshComponent>, int32>& Slot : State->MeshSlots)
+        {
+            UMeshComponent* MeshComponent = Slot.Key.Get();
+            if (MeshComponent && MeshComponent->GetMaterial(Slot.Value) == OldMaterial)
+            {
+                MeshComponent->SetMaterial(Slot.Value, NewMaterial);
+            }
+        }
+        
+        FAnimeMaterialTierState MovedState = MoveTemp(*State);
+        MaterialStates.Remove(OldMaterial);
+        MaterialStates.Add(NewMaterial, MoveTemp(MovedState));
+        
+        FSharedMaterialRef SharedRef;
+        if (SharedMaterialRefs.RemoveAndCopyValue(OldMaterial, SharedRef))
+        {
+            SharedMaterials.Add(SharedRef.Key, NewMaterial);
+            SharedRef.Material = NewMaterial;
+            SharedMaterialRefs.Add(NewMaterial, MoveTemp(SharedRef));
+        }
+        
+        MaterialTweens.Replace(OldMaterial, NewMaterial);
+        MaterialRegistry.Replace(MaterialRegistry.Find(OldMaterial), NewMaterial);
+        Replacements.Add(OldMaterial, NewMaterial);
     }
     
-    // Apply quality settings to all active materials
-    for (UMaterialInstanceDynamic* Material : ActiveMaterials)
+    if (Replacements.Num() == 0)
     {
-        if (Material)
+        return;
+    }
+    
+    // Instances replaced by an earlier tier change lead straight to the newest one. Redirects of old
+    // instances that were collected are dropped on the way: nobody can hand those in anymore, and
+    // without this every tier change would add one entry per material for good.
+    for (const TPair<UMaterialInstanceDynamic*, UMaterialInstanceDynamic*>& Replacement : Replacements)
+    {
+        TArray<TObjectKey<UMaterialInstanceDynamic>, TInlineAllocator<1>> Sources;
+        ReplacedMaterialSources.RemoveAndCopyValue(Replacement.Key, Sources);
+        for (int32 Index = Sources.Num() - 1; Index >= 0; Index--)
         {
-            // Adjust outline thickness based on quality
-            float BaseOutlineThickness;
-            if (Material->GetScalarParameterValue(FName("OutlineThickness"), BaseOutlineThickness))
+            if (Sources[Index].ResolveObjectPtr())
             {
-                Material->SetScalarParameterValue(FName("OutlineThickness"), BaseOutlineThickness * QualityMultiplier);
+                ReplacedMaterials.Add(Sources[Index], Replacement.Value);
             }
-            
-            // Adjust rim lighting based on quality
-            float BaseRimIntensity;
-            if (Material->GetScalarParameterValue(FName("RimIntensity"), BaseRimIntensity))
+            else
             {
-                Material->SetScalarParameterValue(FName("RimIntensity"), BaseRimIntensity * QualityMultiplier);
+                ReplacedMaterials.Remove(Sources[Index]);
+                Sources.RemoveAtSwap(Index);
             }
         }
+        
+        Sources.Add(Replacement.Key);
+        ReplacedMaterials.Add(Replacement.Key, Replacement.Value);
+        ReplacedMaterialSources.Add(Replacement.Value, MoveTemp(Sources));
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Material quality %d: rebuilt %d materials on their tier parents"), CurrentQualityLevel, Replacements.Num());
+    
+    for (const TPair<UMaterialInstanceDynamic*, UMaterialInstanceDynamic*>& Replacement : Replacements)
+    {
+        OnMaterialReplaced.Broadcast(Replacement.Key, Replacement.Value);
     }
 }
 
+UMaterialInstanceDynamic* UAnimeMaterialManager::GetCurrentMaterial(UMaterialInstanceDynamic* Material) const
+{
+    if (Material && ReplacedMaterials.Num() > 0)
+    {
+        if (const TWeakObjectPtr<UMaterialInstanceDynamic>* Replacement = ReplacedMaterials.Find(Material))
+        {
+            if (UMaterialInstanceDynamic* CurrentMaterial = Replacement->Get())
+            {
+                return CurrentMaterial;
+            }
+        }
+    }
+    return Material;
+}
+
+void UAnimeMaterialManager::SetGlobalUpdateRate(float UpdatesPerSecond)
+{
+    GlobalUpdateRate = FMath::Max(UpdatesPerSecond, 0.0f);
+}
+
 void UAnimeMaterialManager::UpdateGlobalParameters()
 {
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_UpdateGlobalParameters, AWRMaterialsChannel, "UAnimeMaterialManager::UpdateGlobalParameters");
+    
     // Update time-based parameters for all active materials
     float CurrentTime = GetWorld()->GetTimeSeconds();
+    const FLinearColor LightDirection(GlobalLightDirection.X, GlobalLightDirection.Y, GlobalLightDirection.Z, 0.0f);
+    
+    // Toggling AWR.Materials.UseParameterCollection rewrites the lighting once on the path now in use
+    const bool bUseCollection = GlobalParameterInstance && MaterialSettings::CVarUseParameterCollection.GetValueOnGameThread();
+    if (bUseCollection != bUsingParameterCollection)
+    {
+        bUsingParameterCollection = bUseCollection;
+        bGlobalLightingDirty = true;
+    }
+    
+    // One write per parameter for every material reading the collection
+    if (bUseCollection)
+    {
+        GlobalParameterInstance->SetScalarParameterValue(MaterialSettings::GlobalTimeParameter, CurrentTime);
+        
+        if (bGlobalLightingDirty)
+        {
+            GlobalParameterInstance->SetVectorParameterValue(MaterialSettings::GlobalLightDirectionParameter, LightDirection);
+            GlobalParameterInstance->SetScalarParameterValue(MaterialSettings::TimeOfDayParameter, GlobalTimeOfDay);
+            bGlobalLightingDirty = false;
+        }
+        return;
+    }
+    
+    // Materials without the collection still need every parameter on every instance
+    MaterialRegistry.ForEach([this, CurrentTime, &LightDirection](UMaterialInstanceDynamic* Material)
+    {
+        Material->SetScalarParameterValue(MaterialSettings::GlobalTimeParameter, CurrentTime);
+        
+        if (bGlobalLightingDirty)
+        {
+            Material->SetVectorParameterValue(MaterialSettings::GlobalLightDirectionParameter, LightDirection);
+            Material->SetScalarParameterValue(MaterialSettings::TimeOfDayParameter, GlobalTimeOfDay);
+        }
+    });
+    bGlobalLightingDirty = false;
+}
+
+int64 UAnimeMaterialManager::GetMaterialMemoryBytes() const
+{
+    int64 MaterialBytes = MaterialRegistry.GetAllocatedSize() + MaterialTweens.GetAllocatedSize();
+    MaterialRegistry.ForEach([&MaterialBytes](UMaterialInstanceDynamic* Material)
+    {
+        MaterialBytes += Material->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+    });
+    return MaterialBytes;
+}
+
+int64 UAnimeMaterialManager::GetRegistryMemoryBytes() const
+{
+    return MaterialRegistry.GetAllocatedSize()
+        + MaterialStates.GetAllocatedSize()
+        + SharedMaterials.GetAllocatedSize()
+        + SharedMaterialRefs.GetAllocatedSize()
+        + ReplacedMaterials.GetAllocatedSize()
+        + ReplacedMaterialSources.GetAllocatedSize();
+}
+
+int32 UAnimeMaterialManager::PruneMaterials(int32 MaxSlots)
+{
+    TArray<TObjectKey<UMaterialInstanceDynamic>> PrunedMaterials;
+    const int32 NumPruned = MaterialRegistry.Prune(MaxSlots, PrunedMaterials);
+    for (const TObjectKey<UMaterialInstanceDynamic>& PrunedMaterial : PrunedMaterials)
+    {
+        ForgetMaterial(PrunedMaterial);
+    }
+    
+    // Removing keeps the map allocations; free them once every material is gone so a spike does not hold memory for good
+    if (MaterialRegistry.Num() == 0 && GetRegistryMemoryBytes() > 0)
+    {
+        MaterialStates.Empty();
+        SharedMaterials.Empty();
+        SharedMaterialRefs.Empty();
+        ReplacedMaterials.Empty();
+        ReplacedMaterialSources.Empty();
+    }
+    
+    NumPrunedMaterials += NumPruned;
+    return NumPruned;
+}
+
+void UAnimeMaterialManager::ForgetMaterial(const TObjectKey<UMaterialInstanceDynamic>& MaterialKey)
+{
+    MaterialStates.Remove(MaterialKey);
+    ReplacedMaterials.Remove(MaterialKey);
+    ForgetRedirectsTo(MaterialKey);
     
-    for (UMaterialInstanceDynamic* Material : ActiveMaterials)
+    FSharedMaterialRef SharedRef;
+    if (SharedMaterialRefs.RemoveAndCopyValue(MaterialKey, SharedRef))
+    {
+        // The key may already point at a newer instance with the same settings
+        const TWeakObjectPtr<UMaterialInstanceDynamic>* SharedMaterial = SharedMaterials.Find(SharedRef.Key);
+        if (SharedMaterial && !SharedMaterial->IsValid())
+        {
+            SharedMaterials.Remove(SharedRef.Key);
+        }
+    }
+}
+
+void UAnimeMaterialManager::ForgetRedirectsTo(const TObjectKey<UMaterialInstanceDynamic>& MaterialKey)
+{
+    TArray<TObjectKey<UMaterialInstanceDynamic>, TInlineAllocator<1>> Sources;
+    if (ReplacedMaterialSources.RemoveAndCopyValue(MaterialKey, Sources))
+    {
+        for (const TObjectKey<UMaterialInstanceDynamic>& Source : Sources)
+        {
+            ReplacedMaterials.Remove(Source);
+        }
+    }
+}
+
+namespace MaterialCommands
+{
+    // Times the global parameter update with N extra dynamic materials, per material and through the collection
+    static void GlobalsBenchmark(const TArray<FString>& Args, UWorld* World)
     {
-        if (Material)
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+        const int32 Iterations = 100;
+        
+        for (TObjectIterator<UAnimeMaterialManager> It; World && It; ++It)
         {
-            Material->SetScalarParameterValue(FName("GlobalTime"), CurrentTime);
-            Material->SetVectorParameterValue(FName("GlobalLightDirection"), FLinearColor(GlobalLightDirection.X, GlobalLightDirection.Y, GlobalLightDirection.Z, 0.0f));
-            Material->SetScalarParameterValue(FName("TimeOfDay"), GlobalTimeOfDay);
+            UAnimeMaterialManager* MaterialManager = *It;
+            if (MaterialManager->GetWorld() != World || !MaterialManager->HasBegunPlay())
+            {
+                continue;
+            }
+            
+            FAnimeMaterialSettings Settings;
+            Settings.BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+            
+            TArray<UMaterialInstanceDynamic*> BenchmarkMaterials;
+            for (int32 i = 0; i < Count; i++)
+            {
+                BenchmarkMaterials.Add(MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings, true));
+            }
+            
+            IConsoleVariable* UseCollection = MaterialSettings::CVarUseParameterCollection.AsVariable();
+            const int32 PreviousValue = UseCollection->GetInt();
+            
+            double Milliseconds[2] = { 0.0, 0.0 };
+            for (int32 Mode = 0; Mode < 2; Mode++)
+            {
+                UseCollection->Set(Mode, ECVF_SetByConsole);
+                
+                // Moving the sun every frame is the worst case for both paths
+                const double StartTime = FPlatformTime::Seconds();
+                for (int32 i = 0; i < Iterations; i++)
+                {
+                    MaterialManager->SetGlobalTimeOfDay(i / (float)Iterations);
+                    MaterialManager->UpdateGlobalParameters();
+                }
+                Milliseconds[Mode] = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+            }
+            
+            UseCollection->Set(PreviousValue, ECVF_SetByConsole);
+            
+            UE_LOG(LogTemp, Log, TEXT("Global material parameters with %d materials: %.3f ms per update writing every material, %.3f ms through the collection%s"),
+                MaterialManager->GetActiveMaterialCount(), Milliseconds[0], Milliseconds[1],
+                MaterialManager->HasParameterCollection() ? TEXT("") : TEXT(" (no collection assigned, both paths write every material)"));
+            
+            for (UMaterialInstanceDynamic* Material : BenchmarkMaterials)
+            {
+                MaterialManager->ReleaseMaterial(Material);
+            }
+            return;
         }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Global material benchmark: no material manager in this world"));
     }
+    
+    // The settings write as it was before parameter layouts: one name lookup per parameter
+    static void WriteSettingsByName(UMaterialInstanceDynamic* Material, const float* Scalars, const FLinearColor* Vectors)
+    {
+        for (int32 i = 0; i < MaterialSettings::NumScalarSettings; i++)
+        {
+            Material->SetScalarParameterValue(MaterialSettings::ScalarSettingNames[i], Scalars[i]);
+        }
+        for (int32 i = 0; i < MaterialSettings::NumVectorSettings; i++)
+        {
+            Material->SetVectorParameterValue(MaterialSettings::VectorSettingNames[i], Vectors[i]);
+        }
+    }
+    
+    // Times applying FAnimeMaterialSettings to N unique materials by parameter name and through the resolved layout
+    static void SettingsBenchmark(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+        const int32 Iterations = 20;
+        
+        for (TObjectIterator<UAnimeMaterialManager> It; World && It; ++It)
+        {
+            UAnimeMaterialManager* MaterialManager = *It;
+            if (MaterialManager->GetWorld() != World || !MaterialManager->HasBegunPlay())
+            {
+                continue;
+            }
+            
+            FAnimeMaterialSettings Settings;
+            Settings.BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+            
+            TArray<UMaterialInstanceDynamic*> BenchmarkMaterials;
+            for (int32 i = 0; i < Count; i++)
+            {
+                if (UMaterialInstanceDynamic* Material = MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings, true))
+                {
+                    BenchmarkMaterials.Add(Material);
+                }
+            }
+            
+            // Both runs write the same 14 values to every material; only the parameter lookup differs
+            float Scalars[MaterialSettings::NumScalarSettings];
+            FLinearColor Vectors[MaterialSettings::NumVectorSettings];
+            
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 i = 0; i < Iterations; i++)
+            {
+                Settings.RimIntensity = 1.0f + i * 0.01f;
+                MaterialSettings::GatherSettings(Settings, Scalars, Vectors);
+                for (UMaterialInstanceDynamic* Material : BenchmarkMaterials)
+                {
+                    WriteSettingsByName(Material, Scalars, Vectors);
+                }
+            }
+            const double ByNameMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+            
+            StartTime = FPlatformTime::Seconds();
+            for (int32 i = 0; i < Iterations; i++)
+            {
+                Settings.RimIntensity = 1.0f + i * 0.01f;
+                MaterialSettings::GatherSettings(Settings, Scalars, Vectors);
+                for (UMaterialInstanceDynamic* Material : BenchmarkMaterials)
+                {
+                    MaterialManager->WriteSettingsParameters(Material, Scalars, Vectors);
+                }
+            }
+            const double ByIndexMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+            
+            UE_LOG(LogTemp, Log, TEXT("Applying material settings to %d materials: %.3f ms by parameter name, %.3f ms through parameter indices (%d iterations each)"),
+                BenchmarkMaterials.Num(), ByNameMs, ByIndexMs, Iterations);
+            
+            for (UMaterialInstanceDynamic* Material : BenchmarkMaterials)
+            {
+                MaterialManager->ReleaseMaterial(Material);
+            }
+            return;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("Material settings benchmark: no material manager in this world"));
+    }
+    
+    // Cycles a unique material through every quality tier twice, setting each tier twice in a row; the
+    // material and its quality scalars must not change on the repeat and must match between the cycles
+    static void CacheReport(const TArray<FString>& Args, UWorld* World)
+    {
+        for (TObjectIterator<UAnimeMaterialManager> It; World && It; ++It)
+        {
+            if (It->GetWorld() != World)
+            {
+                continue;
+            }
+            
+            const int32 Lookups = It->GetNumCacheHits() + It->GetNumCacheMisses();
+            UE_LOG(LogTemp, Log, TEXT("Material cache %s: %d MIDs (%d shared) for %d users, %d hits of %d lookups (%.0f%%)"),
+                *It->GetOwner()->GetName(), It->GetActiveMaterialCount(), It->GetSharedMaterialCount(), It->GetMaterialUserCount(),
+                It->GetNumCacheHits(), Lookups, Lookups > 0 ? 100.0f * It->GetNumCacheHits() / Lookups : 0.0f);
+        }
+    }
+    
+    static FAutoConsoleCommandWithWorldAndArgs CacheReportCommand(
+        TEXT("AWR.Materials.CacheReport"),
+        TEXT("Logs dynamic material counts, users and cache hits per material manager."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&CacheReport));
+    
+    static FAutoConsoleCommandWithWorldAndArgs GlobalsBenchmarkCommand(
+        TEXT("AWR.Materials.GlobalsBenchmark"),
+        TEXT("Creates N dynamic materials (default 500) and logs the game thread time of the global parameter update with and without the parameter collection."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&GlobalsBenchmark));
+    
+    static FAutoConsoleCommandWithWorldAndArgs SettingsBenchmarkCommand(
+        TEXT("AWR.Materials.SettingsBenchmark"),
+        TEXT("Creates N dynamic materials (default 1000) and logs the time to apply material settings by parameter name and by parameter index."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SettingsBenchmark));
 }
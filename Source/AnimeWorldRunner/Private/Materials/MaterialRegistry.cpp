@@ -0,0 +1,142 @@
+#include "Materials/MaterialRegistry.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+FMaterialRegistry::FMaterialRegistry()
+{
+    PruneCursor = 0;
+    NextGeneration = 0;
+}
+
+FMaterialHandle FMaterialRegistry::Add(UMaterialInstanceDynamic* Material)
+{
+    FMaterialHandle Handle;
+    if (!Material)
+    {
+        return Handle;
+    }
+
+    if (const int32* ExistingIndex = SlotByMaterial.Find(Material))
+    {
+        Handle.Index = *ExistingIndex;
+        Handle.Generation = Slots[*ExistingIndex].Generation;
+        return Handle;
+    }
+
+    Handle.Index = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : Slots.AddDefaulted();
+
+    FSlot& Slot = Slots[Handle.Index];
+    Slot.Material = Material;
+    Slot.Key = Material;
+    Slot.Generation = ++NextGeneration;
+    Slot.bUsed = true;
+    Handle.Generation = Slot.Generation;
+
+    SlotByMaterial.Add(Material, Handle.Index);
+    return Handle;
+}
+
+bool FMaterialRegistry::Remove(FMaterialHandle Handle)
+{
+    if (!Slots.IsValidIndex(Handle.Index) || !Slots[Handle.Index].bUsed || Slots[Handle.Index].Generation != Handle.Generation)
+    {
+        return false;
+    }
+
+    FreeSlot(Handle.Index);
+    return true;
+}
+
+FMaterialHandle FMaterialRegistry::Replace(FMaterialHandle Handle, UMaterialInstanceDynamic* NewMaterial)
+{
+    if (!NewMaterial || !Remove(Handle))
+    {
+        return FMaterialHandle();
+    }
+    return Add(NewMaterial);
+}
+
+UMaterialInstanceDynamic* FMaterialRegistry::Get(FMaterialHandle Handle) const
+{
+    if (!Slots.IsValidIndex(Handle.Index))
+    {
+        return nullptr;
+    }
+
+    const FSlot& Slot = Slots[Handle.Index];
+    return Slot.bUsed && Slot.Generation == Handle.Generation ? Slot.Material.Get() : nullptr;
+}
+
+FMaterialHandle FMaterialRegistry::Find(const UMaterialInstanceDynamic* Material) const
+{
+    FMaterialHandle Handle;
+    if (const int32* Index = Material ? SlotByMaterial.Find(Material) : nullptr)
+    {
+        Handle.Index = *Index;
+        Handle.Generation = Slots[*Index].Generation;
+    }
+    return Handle;
+}
+
+int32 FMaterialRegistry::Prune(int32 MaxSlots, TArray<TObjectKey<UMaterialInstanceDynamic>>& OutPruned)
+{
+    const int32 NumToCheck = FMath::Min(MaxSlots, Slots.Num());
+    int32 NumPruned = 0;
+
+    for (int32 i = 0; i < NumToCheck; i++)
+    {
+        if (PruneCursor >= Slots.Num())
+        {
+            PruneCursor = 0;
+        }
+
+        const FSlot& Slot = Slots[PruneCursor];
+        if (Slot.bUsed && !Slot.Material.IsValid())
+        {
+            OutPruned.Add(Slot.Key);
+            FreeSlot(PruneCursor);
+            NumPruned++;
+        }
+        PruneCursor++;
+    }
+
+    // Drop free slots at the end so the array shrinks back after a spike; generations are
+    // unique across slots, so handles to dropped slots cannot match a slot added later
+    const int32 NumSlots = Slots.Num();
+    while (Slots.Num() > 0 && !Slots.Last().bUsed)
+    {
+        Slots.Pop(false);
+    }
+    if (Slots.Num() < NumSlots)
+    {
+        const int32 NumUsedSlots = Slots.Num();
+        FreeSlots.RemoveAllSwap([NumUsedSlots](int32 Index) { return Index >= NumUsedSlots; });
+    }
+
+    // Give the memory back once the last material is gone
+    if (SlotByMaterial.Num() == 0 && GetAllocatedSize() > 0)
+    {
+        Slots.Empty();
+        FreeSlots.Empty();
+        SlotByMaterial.Empty();
+        PruneCursor = 0;
+    }
+
+    return NumPruned;
+}
+
+int64 FMaterialRegistry::GetAllocatedSize() const
+{
+    return Slots.GetAllocatedSize() + FreeSlots.GetAllocatedSize() + SlotByMaterial.GetAllocatedSize();
+}
+
+void FMaterialRegistry::FreeSlot(int32 Index)
+{
+    FSlot& Slot = Slots[Index];
+    SlotByMaterial.Remove(Slot.Key);
+
+    Slot.Material.Reset();
+    Slot.Key = TObjectKey<UMaterialInstanceDynamic>();
+    Slot.bUsed = false;
+
+    FreeSlots.Add(Index);
+}
@@ -0,0 +1,253 @@
+#include "Materials/MaterialTweenSystem.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Algo/StableSort.h"
+
+namespace MaterialTweenOrder
+{
+    template <typename ValueType>
+    static void Apply(TArray<ValueType>& Values, const TArray<int32>& Order)
+    {
+        TArray<ValueType> Sorted;
+        Sorted.Reserve(Values.Num());
+        for (int32 Index : Order)
+        {
+            Sorted.Add(MoveTemp(Values[Index]));
+        }
+        Values = MoveTemp(Sorted);
+    }
+}
+
+void FMaterialTweenSystem::Start(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration, EMaterialTweenEasing Easing)
+{
+    if (!Material)
+    {
+        return;
+    }
+
+    const float InverseDuration = Duration > 0.0f ? 1.0f / Duration : 0.0f;
+
+    // Writes the start value and resolves the index every later write of this tween goes through
+    int32 ParameterIndex = INDEX_NONE;
+    Material->InitializeScalarParameterAndGetIndex(ParameterName, StartValue, ParameterIndex);
+
+    const int32 Existing = Find(Material, ParameterName);
+    if (Existing != INDEX_NONE)
+    {
+        ParameterIndices[Existing] = ParameterIndex;
+        StartValues[Existing] = StartValue;
+        EndValues[Existing] = EndValue;
+        ElapsedTimes[Existing] = 0.0f;
+        InverseDurations[Existing] = InverseDuration;
+        Easings[Existing] = Easing;
+        WrittenValues[Existing] = StartValue;
+        return;
+    }
+
+    // Appended; the next tick sorts once if this split another material's tweens apart
+    bNeedsSort |= Materials.Num() > 0 && Materials.Last().Get() != Material;
+
+    Materials.Add(Material);
+    ParameterNames.Add(ParameterName);
+    ParameterIndices.Add(ParameterIndex);
+    StartValues.Add(StartValue);
+    EndValues.Add(EndValue);
+    ElapsedTimes.Add(0.0f);
+    InverseDurations.Add(InverseDuration);
+    Easings.Add(Easing);
+    WrittenValues.Add(StartValue);
+}
+
+void FMaterialTweenSystem::Stop(const UMaterialInstanceDynamic* Material, FName ParameterName)
+{
+    for (int32 i = Materials.Num() - 1; i >= 0; i--)
+    {
+        if (Materials[i].Get() == Material && (ParameterName.IsNone() || ParameterNames[i] == ParameterName))
+        {
+            Materials.RemoveAt(i, 1, false);
+            ParameterNames.RemoveAt(i, 1, false);
+            ParameterIndices.RemoveAt(i, 1, false);
+            StartValues.RemoveAt(i, 1, false);
+            EndValues.RemoveAt(i, 1, false);
+            ElapsedTimes.RemoveAt(i, 1, false);
+            InverseDurations.RemoveAt(i, 1, false);
+            Easings.RemoveAt(i, 1, false);
+            WrittenValues.RemoveAt(i, 1, false);
+        }
+    }
+}
+
+void FMaterialTweenSystem::StopAll()
+{
+    Materials.Reset();
+    ParameterNames.Reset();
+    ParameterIndices.Reset();
+    StartValues.Reset();
+    EndValues.Reset();
+    ElapsedTimes.Reset();
+    InverseDurations.Reset();
+    Easings.Reset();
+    WrittenValues.Reset();
+}
+
+void FMaterialTweenSystem::Replace(const UMaterialInstanceDynamic* OldMaterial, UMaterialInstanceDynamic* NewMaterial)
+{
+    for (int32 i = 0; i < Materials.Num(); i++)
+    {
+        if (Materials[i].Get() == OldMaterial)
+        {
+            // Indices belong to one instance; the new one gets the current value and its own index
+            Materials[i] = NewMaterial;
+            if (NewMaterial)
+            {
+                WrittenValues[i] = Evaluate(i);
+                NewMaterial->InitializeScalarParameterAndGetIndex(ParameterNames[i], WrittenValues[i], ParameterIndices[i]);
+            }
+        }
+    }
+}
+
+void FMaterialTweenSystem::Tick(float DeltaTime)
+{
+    const int32 Count = Materials.Num();
+    if (Count == 0)
+    {
+        return;
+    }
+
+    if (bNeedsSort)
+    {
+        SortByMaterial();
+    }
+
+    // Advance and evaluate every tween before touching any material
+    CurrentValues.SetNumUninitialized(Count, false);
+    for (int32 i = 0; i < Count; i++)
+    {
+        ElapsedTimes[i] += DeltaTime;
+        CurrentValues[i] = Evaluate(i);
+    }
+
+    // Write the values material by material, then compact finished tweens in order
+    int32 Kept = 0;
+    for (int32 i = 0; i < Count; i++)
+    {
+        UMaterialInstanceDynamic* Material = Materials[i].Get();
+        if (!Material)
+        {
+            continue;
+        }
+
+        // The by-name write only runs if the material's parameters were cleared since the tween started
+        if (CurrentValues[i] != WrittenValues[i])
+        {
+            if (!Material->SetScalarParameterByIndex(ParameterIndices[i], CurrentValues[i]))
+            {
+                Material->InitializeScalarParameterAndGetIndex(ParameterNames[i], CurrentValues[i], ParameterIndices[i]);
+            }
+            WrittenValues[i] = CurrentValues[i];
+        }
+
+        const bool bFinished = InverseDurations[i] <= 0.0f || ElapsedTimes[i] * InverseDurations[i] >= 1.0f;
+        if (bFinished)
+        {
+            continue;
+        }
+
+        if (Kept != i)
+        {
+            Materials[Kept] = Materials[i];
+            ParameterNames[Kept] = ParameterNames[i];
+            ParameterIndices[Kept] = ParameterIndices[i];
+            StartValues[Kept] = StartValues[i];
+            EndValues[Kept] = EndValues[i];
+            ElapsedTimes[Kept] = ElapsedTimes[i];
+            InverseDurations[Kept] = InverseDurations[i];
+            Easings[Kept] = Easings[i];
+            WrittenValues[Kept] = WrittenValues[i];
+        }
+        Kept++;
+    }
+
+    Materials.SetNum(Kept, false);
+    ParameterNames.SetNum(Kept, false);
+    ParameterIndices.SetNum(Kept, false);
+    StartValues.SetNum(Kept, false);
+    EndValues.SetNum(Kept, false);
+    ElapsedTimes.SetNum(Kept, false);
+    InverseDurations.SetNum(Kept, false);
+    Easings.SetNum(Kept, false);
+    WrittenValues.SetNum(Kept, false);
+}
+
+bool FMaterialTweenSystem::IsAnimating(const UMaterialInstanceDynamic* Material, FName ParameterName) const
+{
+    return Find(Material, ParameterName) != INDEX_NONE;
+}
+
+int64 FMaterialTweenSystem::GetAllocatedSize() const
+{
+    return Materials.GetAllocatedSize() + ParameterNames.GetAllocatedSize() + ParameterIndices.GetAllocatedSize()
+        + StartValues.GetAllocatedSize() + EndValues.GetAllocatedSize() + ElapsedTimes.GetAllocatedSize()
+        + InverseDurations.GetAllocatedSize() + Easings.GetAllocatedSize() + WrittenValues.GetAllocatedSize() + CurrentValues.GetAllocatedSize()
+        + SortOrder.GetAllocatedSize();
+}
+
+float FMaterialTweenSystem::Ease(EMaterialTweenEasing Easing, float Alpha)
+{
+    switch (Easing)
+    {
+        case EMaterialTweenEasing::EaseIn:
+            return Alpha * Alpha;
+        case EMaterialTweenEasing::EaseOut:
+            return 1.0f - FMath::Square(1.0f - Alpha);
+        case EMaterialTweenEasing::EaseInOut:
+            return FMath::SmoothStep(0.0f, 1.0f, Alpha);
+        default:
+            return Alpha;
+    }
+}
+
+int32 FMaterialTweenSystem::Find(const UMaterialInstanceDynamic* Material, FName ParameterName) const
+{
+    for (int32 i = 0; i < Materials.Num(); i++)
+    {
+        if (ParameterNames[i] == ParameterName && Materials[i].Get() == Material)
+        {
+            return i;
+        }
+    }
+    return INDEX_NONE;
+}
+
+float FMaterialTweenSystem::Evaluate(int32 Index) const
+{
+    const float Alpha = InverseDurations[Index] > 0.0f ? FMath::Min(ElapsedTimes[Index] * InverseDurations[Index], 1.0f) : 1.0f;
+    return FMath::Lerp(StartValues[Index], EndValues[Index], Ease(Easings[Index], Alpha));
+}
+
+void FMaterialTweenSystem::SortByMaterial()
+{
+    bNeedsSort = false;
+
+    SortOrder.SetNumUninitialized(Materials.Num(), false);
+    for (int32 i = 0; i < SortOrder.Num(); i++)
+    {
+        SortOrder[i] = i;
+    }
+
+    // Any order that groups equal materials will do; the stable sort keeps each material's tweens in start order
+    Algo::StableSortBy(SortOrder, [this](int32 Index)
+    {
+        return reinterpret_cast<UPTRINT>(Materials[Index].Get());
+    });
+
+    MaterialTweenOrder::Apply(Materials, SortOrder);
+    MaterialTweenOrder::Apply(ParameterNames, SortOrder);
+    MaterialTweenOrder::Apply(ParameterIndices, SortOrder);
+    MaterialTweenOrder::Apply(StartValues, SortOrder);
+    MaterialTweenOrder::Apply(EndValues, SortOrder);
+    MaterialTweenOrder::Apply(ElapsedTimes, SortOrder);
+    MaterialTweenOrder::Apply(InverseDurations, SortOrder);
+    MaterialTweenOrder::Apply(Easings, SortOrder);
+    MaterialTweenOrder::Apply(WrittenValues, SortOrder);
+}
@@ -0,0 +1,48 @@
+#include "Optimization/AnimeWorldRunnerStats.h"
+
+DEFINE_STAT(STAT_AWR_EnvironmentTick);
+DEFINE_STAT(STAT_AWR_GenerateLayout);
+DEFINE_STAT(STAT_AWR_LoadChunk);
+
+DEFINE_STAT(STAT_AWR_CharacterTick);
+DEFINE_STAT(STAT_AWR_AnimUpdate);
+
+DEFINE_STAT(STAT_AWR_EffectsTick);
+DEFINE_STAT(STAT_AWR_PlayEffect);
+
+DEFINE_STAT(STAT_AWR_MaterialsTick);
+DEFINE_STAT(STAT_AWR_UpdateGlobalParameters);
+DEFINE_STAT(STAT_AWR_CreateMaterial);
+
+DEFINE_STAT(STAT_AWR_UITick);
+DEFINE_STAT(STAT_AWR_ShowHideUI);
+DEFINE_STAT(STAT_AWR_GameModeTick);
+DEFINE_STAT(STAT_AWR_Inventory);
+DEFINE_STAT(STAT_AWR_SaveGame);
+
+DEFINE_STAT(STAT_AWR_ISMInstances);
+DEFINE_STAT(STAT_AWR_ActiveParticleComponents);
+DEFINE_STAT(STAT_AWR_ActiveAudioComponents);
+DEFINE_STAT(STAT_AWR_ActiveMIDs);
+DEFINE_STAT(STAT_AWR_MaterialTweens);
+DEFINE_STAT(STAT_AWR_PrunedMIDs);
+DEFINE_STAT(STAT_AWR_MaterialRegistryMemory);
+DEFINE_STAT(STAT_AWR_EffectsFull);
+DEFINE_STAT(STAT_AWR_EffectsReduced);
+DEFINE_STAT(STAT_AWR_EffectsSuppressed);
+DEFINE_STAT(STAT_AWR_BurstSpawns);
+DEFINE_STAT(STAT_AWR_VirtualSoundVoices);
+
+DEFINE_STAT(STAT_AWR_PooledActors);
+DEFINE_STAT(STAT_AWR_PooledActorsInUse);
+DEFINE_STAT(STAT_AWR_PooledEffectComponents);
+DEFINE_STAT(STAT_AWR_EffectComponentsCreated);
+
+DEFINE_STAT(STAT_AWR_ISMInstanceMemory);
+DEFINE_STAT(STAT_AWR_ChunkLayoutMemory);
+
+UE_TRACE_CHANNEL_DEFINE(AWREnvironmentChannel);
+UE_TRACE_CHANNEL_DEFINE(AWRCharacterChannel);
+UE_TRACE_CHANNEL_DEFINE(AWREffectsChannel);
+UE_TRACE_CHANNEL_DEFINE(AWRMaterialsChannel);
+UE_TRACE_CHANNEL_DEFINE(AWRGameplayChannel);
@@ -0,0 +1,328 @@
+#include "Optimization/DeviceCalibration.h"
+#include "Kismet/GameplayStatics.h"
+#include "GeneralProjectSettings.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/ConfigCacheIni.h"
+
+const TCHAR* FDeviceCalibration::SaveSlotName = TEXT("AnimeWorldRunnerCalibration");
+const int32 FDeviceCalibration::CurrentKernelVersion = 1;
+
+namespace DeviceCalibrationKernels
+{
+    // Items processed per kernel batch
+    static const int32 BatchSize = 64;
+
+    static const TCHAR* ConfigSection = TEXT("AnimeWorldRunner.DeviceCalibration");
+
+    // Batches per millisecond that score 1.0. The defaults are placeholders, not measurements: the
+    // rates measured on the reference device belong in DefaultGame.ini, with a CurrentKernelVersion bump
+    static float GetReferenceRate(const TCHAR* Key, float DefaultRate)
+    {
+        float Rate = DefaultRate;
+        if (GConfig)
+        {
+            GConfig->GetFloat(ConfigSection, Key, Rate, GGameIni);
+        }
+        return FMath::Max(Rate, KINDA_SMALL_NUMBER);
+    }
+
+    // Written at the end so the compiler cannot drop the kernel work
+    static volatile float ResultSink = 0.0f;
+
+    // Mirrors AModularEnvironmentSystem::GenerateProceduralLayout
+    struct FTransformKernel
+    {
+        FRandomStream Random = FRandomStream(12345);
+        TArray<FTransform> Transforms;
+        float Sink = 0.0f;
+
+        void operator()()
+        {
+            Transforms.Reset(BatchSize);
+            for (int32 i = 0; i < BatchSize; i++)
+            {
+                FTransform Transform;
+                Transform.SetLocation(FVector(Random.FRandRange(-800.0f, 800.0f), Random.FRandRange(-800.0f, 800.0f), Random.FRandRange(0.0f, 200.0f)));
+                Transform.SetRotation(FQuat::MakeFromEuler(FVector(Random.FRandRange(-15.0f, 15.0f), Random.FRandRange(-15.0f, 15.0f), Random.FRandRange(0.0f, 360.0f))));
+                Transform.SetScale3D(FVector(Random.FRandRange(0.5f, 2.0f)));
+                Transforms.Add(Transform);
+            }
+            Sink += Transforms.Last().GetLocation().X;
+        }
+    };
+
+    // Stands in for building instanced static mesh render data: matrices and bounds
+    struct FInstanceBatchKernel
+    {
+        TArray<FTransform> Transforms;
+        TArray<FMatrix> Matrices;
+        float Sink = 0.0f;
+
+        FInstanceBatchKernel()
+        {
+            FRandomStream Random(54321);
+            for (int32 i = 0; i < BatchSize; i++)
+            {
+                Transforms.Add(FTransform(FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f), Random.GetUnitVector() * 1000.0f, FVector(Random.FRandRange(0.8f, 1.5f))));
+            }
+        }
+
+        void operator()()
+        {
+            Matrices.Reset(BatchSize);
+            FBox Bounds(ForceInit);
+            for (const FTransform& Transform : Transforms)
+            {
+                const FMatrix Matrix = Transform.ToMatrixWithScale();
+                Bounds += Matrix.GetOrigin();
+                Matrices.Add(Matrix);
+            }
+            Sink += Bounds.GetExtent().X;
+        }
+    };
+
+    // Mirrors the per-frame math in UAnimeCharacterAnimInstance::NativeUpdateAnimation
+    struct FAnimationKernel
+    {
+        float Speeds[BatchSize];
+        float Directions[BatchSize];
+        float Blends[BatchSize];
+        float Time = 0.0f;
+        float Sink = 0.0f;
+
+        FAnimationKernel()
+        {
+            for (int32 i = 0; i < BatchSize; i++)
+            {
+                Speeds[i] = 0.0f;
+                Directions[i] = 0.0f;
+                Blends[i] = 0.0f;
+            }
+        }
+
+        void operator()()
+        {
+            const float DeltaTime = 1.0f / 60.0f;
+            Time += DeltaTime;
+
+            for (int32 i = 0; i < BatchSize; i++)
+            {
+                const FVector Velocity(FMath::Cos(Time + i) * 600.0f, FMath::Sin(Time * 0.5f + i) * 600.0f, 0.0f);
+                const FVector Normalized = Velocity.GetSafeNormal2D();
+                const float ForwardDot = FVector::DotProduct(FVector::ForwardVector, Normalized);
+                const float RightDot = FVector::DotProduct(FVector::RightVector, Normalized);
+
+                Speeds[i] = FMath::FInterpTo(Speeds[i], Velocity.Size2D(), DeltaTime, 10.0f);
+                Directions[i] = FMath::FInterpTo(Directions[i], FMath::RadiansToDegrees(FMath::Atan2(RightDot, ForwardDot)), DeltaTime, 8.0f);
+                Blends[i] = FMath::Lerp(Blends[i], FMath::Clamp(Speeds[i] / 600.0f, 0.0f, 1.0f), 0.2f) + FMath::Sin(Time * 3.0f) * 0.01f;
+            }
+            Sink += Speeds[0] + Directions[BatchSize - 1] + Blends[BatchSize / 2];
+        }
+    };
+}
+
+struct FDeviceCalibrationRun::FKernels
+{
+    DeviceCalibrationKernels::FTransformKernel Transform;
+    DeviceCalibrationKernels::FInstanceBatchKernel InstanceBatch;
+    DeviceCalibrationKernels::FAnimationKernel Animation;
+
+    void Run(int32 KernelIndex)
+    {
+        switch (KernelIndex)
+        {
+            case 0: Transform(); break;
+            case 1: InstanceBatch(); break;
+            default: Animation(); break;
+        }
+    }
+};
+
+FDeviceCalibrationRun::FDeviceCalibrationRun(float BudgetMs)
+    : Kernels(MakeUnique<FKernels>())
+{
+    // Each kernel gets an equal share, leaving a little room for the warm-up batches
+    KernelSeconds = FMath::Max(BudgetMs, 30.0f) * 0.001 * 0.3;
+
+    CurrentKernel = 0;
+    for (int32 i = 0; i < NumKernels; i++)
+    {
+        KernelBatches[i] = 0;
+        KernelElapsed[i] = 0.0;
+    }
+    MeasuredSeconds = 0.0;
+}
+
+FDeviceCalibrationRun::~FDeviceCalibrationRun()
+{
+}
+
+bool FDeviceCalibrationRun::Step(float MaxSliceMs)
+{
+    using namespace DeviceCalibrationKernels;
+
+    if (IsDone())
+    {
+        return true;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    const double EndTime = StartTime + FMath::Max(MaxSliceMs, 1.0f) * 0.001;
+    double Now = StartTime;
+
+    // One untimed batch to warm caches and allocations, again after every frame in between
+    bool bWarm = false;
+
+    while (CurrentKernel < NumKernels && Now < EndTime)
+    {
+        if (!bWarm)
+        {
+            Kernels->Run(CurrentKernel);
+            bWarm = true;
+            Now = FPlatformTime::Seconds();
+            continue;
+        }
+
+        const double BatchStart = Now;
+        Kernels->Run(CurrentKernel);
+        Now = FPlatformTime::Seconds();
+
+        KernelBatches[CurrentKernel]++;
+        KernelElapsed[CurrentKernel] += Now - BatchStart;
+        if (KernelElapsed[CurrentKernel] >= KernelSeconds)
+        {
+            CurrentKernel++;
+            bWarm = false;
+        }
+    }
+
+    MeasuredSeconds += Now - StartTime;
+
+    if (CurrentKernel < NumKernels)
+    {
+        return false;
+    }
+
+    const float TransformRate = static_cast<float>(KernelBatches[0] / (KernelElapsed[0] * 1000.0));
+    const float InstanceBatchRate = static_cast<float>(KernelBatches[1] / (KernelElapsed[1] * 1000.0));
+    const float AnimationRate = static_cast<float>(KernelBatches[2] / (KernelElapsed[2] * 1000.0));
+
+    Result.TransformScore = TransformRate / GetReferenceRate(TEXT("ReferenceTransformRate"), 12.0f);
+    Result.InstanceBatchScore = InstanceBatchRate / GetReferenceRate(TEXT("ReferenceInstanceBatchRate"), 20.0f);
+    Result.AnimationScore = AnimationRate / GetReferenceRate(TEXT("ReferenceAnimationRate"), 25.0f);
+    Result.CombinedScore = FMath::Pow(Result.TransformScore * Result.InstanceBatchScore * Result.AnimationScore, 1.0f / 3.0f);
+
+    ResultSink = Kernels->Transform.Sink + Kernels->InstanceBatch.Sink + Kernels->Animation.Sink;
+
+    Result.CalibrationTimeMs = static_cast<float>(MeasuredSeconds * 1000.0);
+    Result.AppVersion = FDeviceCalibration::GetCurrentAppVersion();
+    Result.KernelVersion = FDeviceCalibration::CurrentKernelVersion;
+    Result.bIsValid = true;
+
+    UE_LOG(LogTemp, Log, TEXT("Device calibration: score %.2f (transforms %.2f, instances %.2f, animation %.2f, %.3f/%.3f/%.3f batches per ms) in %.1f ms"),
+        Result.CombinedScore, Result.TransformScore, Result.InstanceBatchScore, Result.AnimationScore,
+        TransformRate, InstanceBatchRate, AnimationRate, Result.CalibrationTimeMs);
+
+    return true;
+}
+
+FDeviceCalibrationResult FDeviceCalibration::Run(float BudgetMs)
+{
+    FDeviceCalibrationRun Calibration(BudgetMs);
+    while (!Calibration.Step(BudgetMs))
+    {
+    }
+    return Calibration.GetResult();
+}
+
+FDeviceCalibrationResult FDeviceCalibration::GetOrRun(float BudgetMs)
+{
+    const FDeviceCalibrationResult& Cached = GetCached();
+    if (Cached.bIsValid)
+    {
+        return Cached;
+    }
+
+    const FDeviceCalibrationResult Result = Run(BudgetMs);
+    SaveResult(Result);
+    return Result;
+}
+
+const FDeviceCalibrationResult& FDeviceCalibration::GetCached()
+{
+    return AccessCache();
+}
+
+FDeviceCalibrationResult& FDeviceCalibration::AccessCache()
+{
+    // Loaded once per session; SaveResult keeps it current
+    static FDeviceCalibrationResult CachedResult;
+    static bool bLoaded = false;
+
+    if (!bLoaded)
+    {
+        bLoaded = true;
+
+        if (UGameplayStatics::DoesSaveGameExist(SaveSlotName, 0))
+        {
+            if (UDeviceCalibrationSaveGame* SaveGame = Cast<UDeviceCalibrationSaveGame>(UGameplayStatics::LoadGameFromSlot(SaveSlotName, 0)))
+            {
+                if (IsUpToDate(SaveGame->Result))
+                {
+                    CachedResult = SaveGame->Result;
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Log, TEXT("Device calibration from %s is out of date, it will be measured again"), *SaveGame->Result.AppVersion);
+                }
+            }
+        }
+    }
+
+    return CachedResult;
+}
+
+bool FDeviceCalibration::SaveResult(const FDeviceCalibrationResult& Result)
+{
+    AccessCache() = Result;
+
+    UDeviceCalibrationSaveGame* SaveGame = Cast<UDeviceCalibrationSaveGame>(UGameplayStatics::CreateSaveGameObject(UDeviceCalibrationSaveGame::StaticClass()));
+    if (!SaveGame)
+    {
+        return false;
+    }
+
+    SaveGame->Result = Result;
+    return UGameplayStatics::SaveGameToSlot(SaveGame, SaveSlotName, 0);
+}
+
+int32 FDeviceCalibration::GetPerformanceTier(const FDeviceCalibrationResult& Result)
+{
+    if (!Result.bIsValid)
+    {
+        return -1;
+    }
+
+    if (Result.CombinedScore < 0.6f)
+    {
+        return 0;
+    }
+    else if (Result.CombinedScore < 1.4f)
+    {
+        return 1;
+    }
+
+    return 2;
+}
+
+FString FDeviceCalibration::GetCurrentAppVersion()
+{
+    // Project version plus the build changelist so every app update triggers a new calibration
+    return FString::Printf(TEXT("%s-%s"), *GetDefault<UGeneralProjectSettings>()->ProjectVersion, FApp::GetBuildVersion());
+}
+
+bool FDeviceCalibration::IsUpToDate(const FDeviceCalibrationResult& Result)
+{
+    return Result.bIsValid && Result.KernelVersion == CurrentKernelVersion && Result.AppVersion == GetCurrentAppVersion();
+}
@@ -0,0 +1,193 @@
+#include "Optimization/DynamicResolutionController.h"
+#include "Optimization/FrameTimeTrace.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+FDynamicResolutionController::FDynamicResolutionController()
+{
+    Reset(1.0f);
+}
+
+void FDynamicResolutionController::Configure(const FDynamicResolutionControllerSettings& InSettings)
+{
+    Settings = InSettings;
+    Settings.MaxScale = FMath::Max(Settings.MaxScale, Settings.MinScale);
+    Settings.QuantizationStep = FMath::Max(Settings.QuantizationStep, KINDA_SMALL_NUMBER);
+
+    ContinuousScale = FMath::Clamp(ContinuousScale, Settings.MinScale, Settings.MaxScale);
+    AppliedScale = FMath::Clamp(AppliedScale, Settings.MinScale, Settings.MaxScale);
+}
+
+void FDynamicResolutionController::Reset(float InitialScale)
+{
+    bHasSample = false;
+    SmoothedFrameTimeMs = Settings.TargetFrameTimeMs;
+    FrameTimeTrend = 0.0f;
+    PredictedFrameTimeMs = Settings.TargetFrameTimeMs;
+    PreviousError = 0.0f;
+
+    ContinuousScale = FMath::Clamp(InitialScale, Settings.MinScale, Settings.MaxScale);
+    AppliedScale = ContinuousScale;
+}
+
+bool FDynamicResolutionController::Update(float FrameTimeMs, float DeltaSeconds)
+{
+    if (FrameTimeMs <= 0.0f || DeltaSeconds <= 0.0f)
+    {
+        return false;
+    }
+
+    // Exponential smoothing that is independent of the frame rate
+    if (!bHasSample)
+    {
+        SmoothedFrameTimeMs = FrameTimeMs;
+        bHasSample = true;
+    }
+    else
+    {
+        const float Alpha = 1.0f - FMath::Exp(-DeltaSeconds / FMath::Max(Settings.SmoothingTimeSeconds, KINDA_SMALL_NUMBER));
+        const float PreviousSmoothed = SmoothedFrameTimeMs;
+        SmoothedFrameTimeMs += (FrameTimeMs - SmoothedFrameTimeMs) * Alpha;
+        FrameTimeTrend += ((SmoothedFrameTimeMs - PreviousSmoothed) / DeltaSeconds - FrameTimeTrend) * Alpha;
+    }
+
+    PredictedFrameTimeMs = SmoothedFrameTimeMs + FrameTimeTrend * Settings.PredictionHorizonSeconds;
+
+    // Positive error means headroom, negative means we are over budget
+    float Error = (Settings.TargetFrameTimeMs - PredictedFrameTimeMs) / Settings.TargetFrameTimeMs;
+    if (FMath::Abs(Error) < Settings.Deadband)
+    {
+        Error = 0.0f;
+    }
+
+    // Velocity form PI: clamping the output cannot wind up the integral term
+    float ScaleDelta = Settings.ProportionalGain * (Error - PreviousError) + Settings.IntegralGain * Error * DeltaSeconds;
+    PreviousError = Error;
+
+    const float MaxDelta = Settings.MaxScaleRatePerSecond * DeltaSeconds;
+    ScaleDelta = FMath::Clamp(ScaleDelta, -MaxDelta, MaxDelta);
+    ContinuousScale = FMath::Clamp(ContinuousScale + ScaleDelta, Settings.MinScale, Settings.MaxScale);
+
+    // A quarter step past where rounding would switch, so noise at a step boundary does not toggle the scale
+    const float Step = Settings.QuantizationStep;
+    if (FMath::Abs(ContinuousScale - AppliedScale) < Step * 0.75f)
+    {
+        return false;
+    }
+
+    const float NewScale = FMath::Clamp(FMath::GridSnap(ContinuousScale, Step), Settings.MinScale, Settings.MaxScale);
+    if (FMath::IsNearlyEqual(NewScale, AppliedScale))
+    {
+        return false;
+    }
+
+    AppliedScale = NewScale;
+    return true;
+}
+
+FDynamicResolutionSimulationReport FDynamicResolutionController::Simulate(const FDynamicResolutionControllerSettings& InSettings, const TArray<float>& FrameTimesMs, float GPUBoundFraction)
+{
+    FDynamicResolutionSimulationReport Report;
+
+    FDynamicResolutionController Controller;
+    Controller.Configure(InSettings);
+    Controller.Reset(InSettings.MaxScale);
+
+    const float Target = InSettings.TargetFrameTimeMs;
+    const float SettlingBand = 2.0f * InSettings.Deadband;
+    GPUBoundFraction = FMath::Clamp(GPUBoundFraction, 0.0f, 1.0f);
+
+    float Time = 0.0f;
+    double FrameTimeSum = 0.0;
+    bool bCrossedTarget = false;
+    bool bStartedOverBudget = false;
+    float MaxExcursion = 0.0f;
+    float LastUnsettledTime = 0.0f;
+    bool bLastFrameUnsettled = false;
+
+    Report.MinAppliedScale = Controller.GetAppliedScale();
+    Report.MaxAppliedScale = Controller.GetAppliedScale();
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameTimesMs.Num(); FrameIndex++)
+    {
+        // Recorded frame times are at full resolution; the GPU share scales with pixel count
+        const float Scale = Controller.GetAppliedScale();
+        const float FrameTime = FrameTimesMs[FrameIndex] * ((1.0f - GPUBoundFraction) + GPUBoundFraction * Scale * Scale);
+
+        Time += FrameTime * 0.001f;
+        FrameTimeSum += FrameTime;
+
+        const bool bScaleChanged = Controller.Update(FrameTime, FrameTime * 0.001f);
+        if (bScaleChanged)
+        {
+            Report.CVarWrites++;
+            Report.MinAppliedScale = FMath::Min(Report.MinAppliedScale, Controller.GetAppliedScale());
+            Report.MaxAppliedScale = FMath::Max(Report.MaxAppliedScale, Controller.GetAppliedScale());
+        }
+
+        // Outside the band only counts while the controller still has room to correct it
+        const float Smoothed = Controller.GetSmoothedFrameTime();
+        const float AppliedScale = Controller.GetAppliedScale();
+        const bool bOverBand = Smoothed > Target * (1.0f + SettlingBand) && AppliedScale > InSettings.MinScale;
+        const bool bUnderBand = Smoothed < Target * (1.0f - SettlingBand) && AppliedScale < InSettings.MaxScale;
+        bLastFrameUnsettled = bScaleChanged || bOverBand || bUnderBand;
+        if (bLastFrameUnsettled)
+        {
+            LastUnsettledTime = Time;
+        }
+
+        // Overshoot is measured on the smoothed signal, past the first target crossing
+        if (FrameIndex == 0)
+        {
+            bStartedOverBudget = Smoothed > Target;
+        }
+        else if (!bCrossedTarget)
+        {
+            bCrossedTarget = bStartedOverBudget ? Smoothed <= Target : Smoothed > Target;
+        }
+        else
+        {
+            MaxExcursion = FMath::Max(MaxExcursion, bStartedOverBudget ? Target - Smoothed : Smoothed - Target);
+        }
+    }
+
+    Report.NumFrames = FrameTimesMs.Num();
+    Report.DurationSeconds = Time;
+    Report.SettlingTimeSeconds = LastUnsettledTime;
+    Report.bSettled = Report.NumFrames > 0 && !bLastFrameUnsettled;
+    Report.OvershootPercent = 100.0f * MaxExcursion / Target;
+    Report.FinalScale = Controller.GetAppliedScale();
+    Report.AverageFrameTimeMs = Report.NumFrames > 0 ? static_cast<float>(FrameTimeSum / Report.NumFrames) : 0.0f;
+
+    return Report;
+}
+
+namespace DynamicResolutionSimulation
+{
+    static void LogReport(const TCHAR* TraceName, const FDynamicResolutionSimulationReport& Report)
+    {
+        UE_LOG(LogTemp, Log, TEXT("DynRes [%s]: %d frames / %.1fs, settling %.2fs%s, overshoot %.1f%%, CVar writes %d, scale %.2f (range %.2f-%.2f), avg frame %.2fms"),
+            TraceName, Report.NumFrames, Report.DurationSeconds, Report.SettlingTimeSeconds, Report.bSettled ? TEXT("") : TEXT(" (not settled)"), Report.OvershootPercent,
+            Report.CVarWrites, Report.FinalScale, Report.MinAppliedScale, Report.MaxAppliedScale, Report.AverageFrameTimeMs);
+    }
+
+    static void RunSimulation(const TArray<FString>& Args)
+    {
+        if (Args.Num() == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("DynRes: usage AWR.DynRes.Simulate <trace file>"));
+            return;
+        }
+
+        TArray<float> Trace;
+        if (FFrameTimeTrace::LoadFromFile(Args[0], Trace))
+        {
+            LogReport(*FPaths::GetCleanFilename(Args[0]), FDynamicResolutionController::Simulate(FDynamicResolutionControllerSettings(), Trace));
+        }
+    }
+
+    static FAutoConsoleCommand SimulateCommand(
+        TEXT("AWR.DynRes.Simulate"),
+        TEXT("Runs the dynamic resolution controller against a recorded frame time trace (relative to Saved/) and logs settling time, overshoot and CVar writes."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunSimulation));
+}
@@ -0,0 +1,172 @@
+#include "Optimization/FrameTimeStats.h"
+
+FFrameTimeStats::FFrameTimeStats()
+{
+    HitchThresholdMs = 33.4f; // Two frames at 60 FPS
+    TotalHitchCount = 0;
+    Reset();
+}
+
+void FFrameTimeStats::Reset()
+{
+    FMemory::Memzero(Samples, sizeof(Samples));
+    FMemory::Memzero(HitchFlags, sizeof(HitchFlags));
+    FMemory::Memzero(Histogram, sizeof(Histogram));
+
+    MaxQueueHead = 0;
+    MaxQueueNum = 0;
+    NextSequence = 0;
+    Count = 0;
+    RunningSum = 0.0;
+    WindowHitchCount = 0;
+    TotalHitchCount = 0;
+}
+
+void FFrameTimeStats::SetHitchThreshold(float ThresholdMs)
+{
+    HitchThresholdMs = FMath::Max(ThresholdMs, 1.0f);
+}
+
+int32 FFrameTimeStats::GetBucketIndex(float FrameTimeMs)
+{
+    return FMath::Clamp(FMath::FloorToInt(FrameTimeMs / BucketWidthMs), 0, NumBuckets);
+}
+
+void FFrameTimeStats::AddSample(float FrameTimeMs)
+{
+    FrameTimeMs = FMath::Max(FrameTimeMs, 0.0f);
+
+    const int64 Sequence = NextSequence++;
+    const int32 Slot = static_cast<int32>(Sequence % WindowSize);
+
+    // Evict the sample that falls out of the window
+    if (Count == WindowSize)
+    {
+        const float Evicted = Samples[Slot];
+        RunningSum -= Evicted;
+        Histogram[GetBucketIndex(Evicted)]--;
+
+        if (HitchFlags[Slot])
+        {
+            WindowHitchCount--;
+        }
+
+        if (MaxQueueNum > 0 && MaxQueue[MaxQueueHead] <= Sequence - WindowSize)
+        {
+            MaxQueueHead = (MaxQueueHead + 1) % WindowSize;
+            MaxQueueNum--;
+        }
+    }
+    else
+    {
+        Count++;
+    }
+
+    // Insert the new sample
+    Samples[Slot] = FrameTimeMs;
+    RunningSum += FrameTimeMs;
+    Histogram[GetBucketIndex(FrameTimeMs)]++;
+
+    const bool bIsHitch = FrameTimeMs > HitchThresholdMs;
+    HitchFlags[Slot] = bIsHitch;
+    if (bIsHitch)
+    {
+        WindowHitchCount++;
+        TotalHitchCount++;
+    }
+
+    // Keep the max queue strictly decreasing so its front is always the window maximum
+    while (MaxQueueNum > 0)
+    {
+        const int32 BackIndex = (MaxQueueHead + MaxQueueNum - 1) % WindowSize;
+        if (Samples[MaxQueue[BackIndex] % WindowSize] > FrameTimeMs)
+        {
+            break;
+        }
+        MaxQueueNum--;
+    }
+    MaxQueue[(MaxQueueHead + MaxQueueNum) % WindowSize] = Sequence;
+    MaxQueueNum++;
+}
+
+float FFrameTimeStats::GetLatest() const
+{
+    if (Count == 0) return 0.0f;
+    return Samples[static_cast<int32>((NextSequence - 1) % WindowSize)];
+}
+
+float FFrameTimeStats::GetAverage() const
+{
+    if (Count == 0) return 0.0f;
+    return static_cast<float>(RunningSum / Count);
+}
+
+float FFrameTimeStats::GetMax() const
+{
+    if (MaxQueueNum == 0) return 0.0f;
+    return Samples[MaxQueue[MaxQueueHead] % WindowSize];
+}
+
+float FFrameTimeStats::GetBucketValue(int32 BucketIndex, int32 RankInBucket, int32 BucketCount) const
+{
+    // The overflow bucket has no upper edge, so report the exact window maximum
+    if (BucketIndex >= NumBuckets)
+    {
+        return GetMax();
+    }
+
+    const float Fraction = (RankInBucket + 0.5f) / BucketCount;
+    const float Value = (BucketIndex + Fraction) * BucketWidthMs;
+    return FMath::Min(Value, GetMax());
+}
+
+float FFrameTimeStats::GetPercentile(float Percentile) const
+{
+    if (Count == 0) return 0.0f;
+
+    const int32 TargetRank = FMath::Clamp(FMath::CeilToInt(Percentile * Count) - 1, 0, Count - 1);
+
+    int32 Cumulative = 0;
+    for (int32 BucketIndex = 0; BucketIndex <= NumBuckets; BucketIndex++)
+    {
+        const int32 BucketCount = Histogram[BucketIndex];
+        if (Cumulative + BucketCount > TargetRank)
+        {
+            return GetBucketValue(BucketIndex, TargetRank - Cumulative, BucketCount);
+        }
+        Cumulative += BucketCount;
+    }
+
+    return GetMax();
+}
+
+void FFrameTimeStats::GetPercentiles(float& OutP50, float& OutP95, float& OutP99) const
+{
+    OutP50 = OutP95 = OutP99 = 0.0f;
+    if (Count == 0) return;
+
+    const float Percentiles[3] = { 0.50f, 0.95f, 0.99f };
+    float* Outputs[3] = { &OutP50, &OutP95, &OutP99 };
+
+    int32 Next = 0;
+    int32 TargetRank = FMath::Clamp(FMath::CeilToInt(Percentiles[Next] * Count) - 1, 0, Count - 1);
+    int32 Cumulative = 0;
+
+    for (int32 BucketIndex = 0; BucketIndex <= NumBuckets && Next < 3; BucketIndex++)
+    {
+        const int32 BucketCount = Histogram[BucketIndex];
+
+        // Several percentiles can land in the same bucket
+        while (Next < 3 && Cumulative + BucketCount > TargetRank)
+        {
+            *Outputs[Next] = GetBucketValue(BucketIndex, TargetRank - Cumulative, BucketCount);
+            Next++;
+            if (Next < 3)
+            {
+                TargetRank = FMath::Clamp(FMath::CeilToInt(Percentiles[Next] * Count) - 1, 0, Count - 1);
+            }
+        }
+
+        Cumulative += BucketCount;
+    }
+}
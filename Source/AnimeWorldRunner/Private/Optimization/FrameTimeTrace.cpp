@@ -0,0 +1,29 @@
+#include "Optimization/FrameTimeTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool FFrameTimeTrace::LoadFromFile(const FString& FileName, TArray<float>& OutFrameTimesMs)
+{
+    OutFrameTimesMs.Reset();
+
+    FString FileContents;
+    const FString TracePath = FPaths::IsRelative(FileName) ? FPaths::ProjectSavedDir() / FileName : FileName;
+    if (!FFileHelper::LoadFileToString(FileContents, *TracePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Frame time trace: could not read %s"), *TracePath);
+        return false;
+    }
+
+    TArray<FString> Tokens;
+    FileContents.ParseIntoArrayWS(Tokens, TEXT(","));
+
+    OutFrameTimesMs.Reserve(Tokens.Num());
+    for (const FString& Token : Tokens)
+    {
+        if (Token.IsNumeric())
+        {
+            OutFrameTimesMs.Add(FCString::Atof(*Token));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,202 @@
+#include "Optimization/HitchRecorder.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+
+namespace HitchRecorderSettings
+{
+    static TAutoConsoleVariable<int32> CVarEnable(
+        TEXT("AWR.Hitch.Enable"),
+        1,
+        TEXT("Records per-system frame timings and writes a CSV to Saved/Profiling/Hitches when a frame spikes."));
+
+    static TAutoConsoleVariable<float> CVarThresholdMs(
+        TEXT("AWR.Hitch.ThresholdMs"),
+        50.0f,
+        TEXT("Frame time (ms) above which a frame counts as a hitch."));
+
+    static TAutoConsoleVariable<float> CVarCooldownSeconds(
+        TEXT("AWR.Hitch.CooldownSeconds"),
+        5.0f,
+        TEXT("Minimum time between two hitch reports."));
+
+    static TAutoConsoleVariable<int32> CVarMaxReports(
+        TEXT("AWR.Hitch.MaxReports"),
+        20,
+        TEXT("Maximum number of hitch reports written per session."));
+}
+
+FHitchRecorder& FHitchRecorder::Get()
+{
+    static FHitchRecorder Recorder;
+    return Recorder;
+}
+
+FHitchRecorder::FHitchRecorder()
+{
+    FMemory::Memzero(Frames, sizeof(Frames));
+    CurrentFrame = 0;
+    RecordedFrames = 0;
+    LastEndFrameCycles = FPlatformTime::Cycles64();
+    PendingHitchFrame = INDEX_NONE;
+    FramesUntilReport = 0;
+    LastReportTime = -FLT_MAX;
+    ReportsWritten = 0;
+    FMemory::Memzero(ChildCycles, sizeof(ChildCycles));
+    ScopeDepth = 0;
+
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FHitchRecorder::EndFrame);
+    PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FHitchRecorder::Shutdown);
+}
+
+void FHitchRecorder::Shutdown()
+{
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+    EndFrameHandle.Reset();
+    PreExitHandle.Reset();
+}
+
+void FHitchRecorder::BeginScope()
+{
+    // Game thread only; scopes on other threads would race on the frame record
+    if (!IsInGameThread())
+    {
+        return;
+    }
+
+    if (ScopeDepth < MaxScopeDepth)
+    {
+        ChildCycles[ScopeDepth] = 0;
+    }
+    ScopeDepth++;
+}
+
+void FHitchRecorder::EndScope(EHitchScope Scope, uint64 Cycles)
+{
+    if (!IsInGameThread() || ScopeDepth <= 0)
+    {
+        return;
+    }
+
+    ScopeDepth--;
+    const uint64 NestedCycles = ScopeDepth < MaxScopeDepth ? FMath::Min(ChildCycles[ScopeDepth], Cycles) : 0;
+    if (ScopeDepth > 0 && ScopeDepth <= MaxScopeDepth)
+    {
+        ChildCycles[ScopeDepth - 1] += Cycles;
+    }
+
+    FFrameRecord& Frame = Frames[CurrentFrame];
+    Frame.ScopeCycles[(int32)Scope] += Cycles - NestedCycles;
+    Frame.ScopeCalls[(int32)Scope]++;
+}
+
+void FHitchRecorder::EndFrame()
+{
+    const uint64 NowCycles = FPlatformTime::Cycles64();
+    const float FrameTimeMs = static_cast<float>(FPlatformTime::ToMilliseconds64(NowCycles - LastEndFrameCycles));
+    LastEndFrameCycles = NowCycles;
+
+    FFrameRecord& Frame = Frames[CurrentFrame];
+    Frame.FrameNumber = GFrameCounter;
+    Frame.FrameTimeMs = FrameTimeMs;
+
+    RecordedFrames = FMath::Min(RecordedFrames + 1, NumFrames);
+
+    if (HitchRecorderSettings::CVarEnable.GetValueOnGameThread() != 0)
+    {
+        if (PendingHitchFrame != INDEX_NONE)
+        {
+            if (--FramesUntilReport <= 0)
+            {
+                WriteHitchReport(PendingHitchFrame);
+                PendingHitchFrame = INDEX_NONE;
+            }
+        }
+        else if (FrameTimeMs > HitchRecorderSettings::CVarThresholdMs.GetValueOnGameThread()
+            && RecordedFrames > FramesBeforeHitch
+            && ReportsWritten < HitchRecorderSettings::CVarMaxReports.GetValueOnGameThread()
+            && FPlatformTime::Seconds() - LastReportTime >= HitchRecorderSettings::CVarCooldownSeconds.GetValueOnGameThread())
+        {
+            PendingHitchFrame = CurrentFrame;
+            FramesUntilReport = FramesAfterHitch;
+        }
+    }
+
+    // Start the next frame with empty timings
+    CurrentFrame = (CurrentFrame + 1) % NumFrames;
+    FFrameRecord& NextFrame = Frames[CurrentFrame];
+    FMemory::Memzero(NextFrame.ScopeCycles, sizeof(NextFrame.ScopeCycles));
+    FMemory::Memzero(NextFrame.ScopeCalls, sizeof(NextFrame.ScopeCalls));
+}
+
+void FHitchRecorder::WriteHitchReport(int32 HitchFrameIndex)
+{
+    LastReportTime = FPlatformTime::Seconds();
+    ReportsWritten++;
+
+    const FFrameRecord& HitchFrame = Frames[HitchFrameIndex];
+
+    // Header
+    FString Csv = TEXT("Frame,Hitch,FrameMs");
+    for (int32 ScopeIndex = 0; ScopeIndex < (int32)EHitchScope::Count; ScopeIndex++)
+    {
+        const TCHAR* ScopeName = GetScopeName((EHitchScope)ScopeIndex);
+        Csv += FString::Printf(TEXT(",%sMs,%sCalls"), ScopeName, ScopeName);
+    }
+    Csv += TEXT(",UntrackedMs\n");
+
+    for (int32 Offset = -FramesBeforeHitch; Offset <= FramesAfterHitch; Offset++)
+    {
+        const int32 FrameIndex = (HitchFrameIndex + Offset + NumFrames) % NumFrames;
+        const FFrameRecord& Frame = Frames[FrameIndex];
+
+        double TrackedMs = 0.0;
+        Csv += FString::Printf(TEXT("%llu,%d,%.3f"), Frame.FrameNumber, Offset == 0 ? 1 : 0, Frame.FrameTimeMs);
+        for (int32 ScopeIndex = 0; ScopeIndex < (int32)EHitchScope::Count; ScopeIndex++)
+        {
+            const double ScopeMs = FPlatformTime::ToMilliseconds64(Frame.ScopeCycles[ScopeIndex]);
+            TrackedMs += ScopeMs;
+            Csv += FString::Printf(TEXT(",%.3f,%d"), ScopeMs, Frame.ScopeCalls[ScopeIndex]);
+        }
+        Csv += FString::Printf(TEXT(",%.3f\n"), FMath::Max(Frame.FrameTimeMs - TrackedMs, 0.0));
+    }
+
+    const FString FilePath = FPaths::ProfilingDir() / TEXT("Hitches") /
+        FString::Printf(TEXT("Hitch_%s_%llu.csv"), *FDateTime::Now().ToString(), HitchFrame.FrameNumber);
+
+    UE_LOG(LogTemp, Warning, TEXT("Hitch of %.1f ms in frame %llu, writing %s"), HitchFrame.FrameTimeMs, HitchFrame.FrameNumber, *FilePath);
+
+    // Writing on the game thread would add a hitch of its own
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Csv = MoveTemp(Csv), FilePath]()
+    {
+        FFileHelper::SaveStringToFile(Csv, *FilePath);
+    });
+}
+
+const TCHAR* FHitchRecorder::GetScopeName(EHitchScope Scope)
+{
+    switch (Scope)
+    {
+        case EHitchScope::Environment:
+            return TEXT("Environment");
+        case EHitchScope::GameMode:
+            return TEXT("GameMode");
+        case EHitchScope::Effects:
+            return TEXT("Effects");
+        case EHitchScope::Materials:
+            return TEXT("Materials");
+        case EHitchScope::UI:
+            return TEXT("UI");
+        case EHitchScope::Inventory:
+            return TEXT("Inventory");
+        case EHitchScope::Save:
+            return TEXT("Save");
+        default:
+            return TEXT("Unknown");
+    }
+}
@@ -1,4 +1,11 @@
 #include "Optimization/MobileOptimizationManager.h"
+#include "Environment/ModularEnvironmentSystem.h"
+#include "Effects/AnimeEffectsManager.h"
+#include "Materials/AnimeMaterialManager.h"
+#include "UI/AnimeUIManager.h"
+#include "GameModes/AWRGameModeBase.h"
+#include "EngineUtils.h"
+#include "UObject/UObjectIterator.h"
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "HAL/PlatformApplicationMisc.h"
@@ -9,6 +16,10 @@
 #include "Particles/ParticleSystem.h"
 #include "RenderingThread.h"
 #include "Stats/Stats.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "HAL/IConsoleManager.h"
 
 UMobileOptimizationManager::UMobileOptimizationManager()
 {
@@ -21,12 +32,28 @@ UMobileOptimizationManager::UMobileOptimizationManager()
     
     bDynamicResolutionEnabled = false;
     CurrentResolutionScale = 1.0f;
-    ResolutionAdjustmentSpeed = 0.1f;
+    ResolutionAdjustmentSpeed = 0.25f;
+    ResolutionDeadband = 0.05f;
+    ResolutionScaleStep = 0.05f;
+    ResolutionPredictionHorizon = 0.1f;
+    
+    bEnableCalibration = true;
+    CalibrationBudgetMs = 300.0f;
+    CalibrationSliceMs = 8.0f;
+    CalibrationTierTable = nullptr;
+    bDetectAfterCalibration = false;
+    bCalibratedLastFrame = false;
+    
+    bEnablePerformanceGovernor = true;
+    
+    MemorySampleInterval = 5.0f;
+    MemorySampleTimer = 0.0f;
+    
+    bEnableTelemetry = true;
+    TelemetryTimer = 0.0f;
     
     PerformanceTimer = 0.0f;
     FrameCounter = 0;
-    
-    FPSHistory.Reserve(60); // Store 60 frames of history
 }
 
 void UMobileOptimizationManager::BeginPlay()
@@ -34,27 +61,71 @@ void UMobileOptimizationManager::BeginPlay()
     Super::BeginPlay();
     
     InitializeDeviceProfiles();
-    AutoDetectQualityLevel();
-    ApplyOptimizationSettings(CurrentSettings);
+    EnsureDeviceCalibration();
+    
+    // Detect and apply in one pass so startup only switches profiles once. An unknown device that is still
+    // calibrating keeps the engine defaults for those few frames and gets its profile when the score is in.
+    if (PendingCalibration && !DeviceProfiles.Contains(DetectDeviceModel()))
+    {
+        bDetectAfterCalibration = true;
+    }
+    else
+    {
+        FMobileOptimizationSettings DetectedSettings;
+        SelectAutoDetectedSettings(DetectedSettings);
+        ApplyOptimizationSettings(DetectedSettings);
+    }
     
     if (bEnablePerformanceMonitoring)
     {
         StartPerformanceMonitoring();
     }
+    
+    if (bEnableTelemetry && FTelemetryRecorder::IsEnabled())
+    {
+        TelemetryRecorder.BeginSession(DetectDeviceModel());
+    }
+}
+
+void UMobileOptimizationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Headless soak runs (-nullrhi -AWRMemorySoak) get their report when the session ends
+    if (FParse::Param(FCommandLine::Get(), TEXT("AWRMemorySoak")))
+    {
+        WriteMemorySoakReport();
+    }
+    
+    TelemetryRecorder.EndSession();
+    
+    Super::EndPlay(EndPlayReason);
 }
 
 void UMobileOptimizationManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
-    if (bEnablePerformanceMonitoring)
+    // A frame that measured a calibration slice is slower than the game would be; keep it out of the
+    // frame time statistics, dynamic resolution and the governor
+    const bool bCalibrationFrame = bCalibratedLastFrame;
+    bCalibratedLastFrame = UpdateDeviceCalibration();
+    
+    if (bEnablePerformanceMonitoring && !bCalibrationFrame)
     {
         UpdatePerformanceMetrics(DeltaTime);
         
         if (bDynamicResolutionEnabled)
         {
-            AdjustDynamicResolution();
+            AdjustDynamicResolution(DeltaTime);
         }
+        
+        UpdateMemoryBudgets(DeltaTime);
+        
+        if (bEnablePerformanceGovernor && PerformanceGovernor.Update(CurrentMetrics.P95FrameTime, DeltaTime))
+        {
+            ApplyPerformanceBudgets();
+        }
+        
+        RecordTelemetry(DeltaTime);
     }
 }
 
@@ -75,6 +146,7 @@ void UMobileOptimizationManager::InitializeDeviceProfiles()
     A56Profile.ShadowMapResolution = 512;
     A56Profile.MaxDrawCalls = 80;
     A56Profile.MaxTriangles = 80000;
+    A56Profile.MaxActiveEffects = 12;
     DeviceProfiles.Add("SM-A546B", A56Profile); // Samsung A56 model number
     
     // Low-end device profile
@@ -91,6 +163,12 @@ void UMobileOptimizationManager::InitializeDeviceProfiles()
     LowEndProfile.bEnablePostProcessing = false;
     LowEndProfile.MaxDrawCalls = 50;
     LowEndProfile.MaxTriangles = 40000;
+    LowEndProfile.MaxActiveEffects = 8;
+    LowEndProfile.MemoryBudgets.EnvironmentMB = 24.0f;
+    LowEndProfile.MemoryBudgets.ChunkDataMB = 4.0f;
+    LowEndProfile.MemoryBudgets.EffectsMB = 12.0f;
+    LowEndProfile.MemoryBudgets.MaterialsMB = 8.0f;
+    LowEndProfile.MemoryBudgets.UIMB = 16.0f;
     DeviceProfiles.Add("LowEnd", LowEndProfile);
     
     // High-end device profile
@@ -110,29 +188,51 @@ void UMobileOptimizationManager::InitializeDeviceProfiles()
     HighEndProfile.bEnableAntiAliasing = true;
     HighEndProfile.MaxDrawCalls = 150;
     HighEndProfile.MaxTriangles = 150000;
+    HighEndProfile.MaxActiveEffects = 24;
+    HighEndProfile.MemoryBudgets.EnvironmentMB = 96.0f;
+    HighEndProfile.MemoryBudgets.ChunkDataMB = 16.0f;
+    HighEndProfile.MemoryBudgets.EffectsMB = 48.0f;
+    HighEndProfile.MemoryBudgets.MaterialsMB = 32.0f;
+    HighEndProfile.MemoryBudgets.UIMB = 64.0f;
     DeviceProfiles.Add("HighEnd", HighEndProfile);
 }
 
 void UMobileOptimizationManager::ApplyOptimizationSettings(const FMobileOptimizationSettings& Settings)
 {
-    CurrentSettings = Settings;
+    // Copy first: callers may pass CurrentSettings itself
+    FMobileOptimizationSettings NewSettings = Settings;
+    if (NewSettings.QualityLevel == EMobileQualityLevel::Auto)
+    {
+        NewSettings.QualityLevel = ResolveAutoQualityLevel();
+    }
+    
+    CurrentSettings = NewSettings;
     
-    // Apply quality level
-    ApplyQualitySettings(Settings.QualityLevel);
+    // Build the whole profile, later entries override earlier ones
+    FQualityProfile Profile;
+    ApplyQualitySettings(NewSettings.QualityLevel, Profile);
+    SetConsoleVariables(Profile);
+    AddTextureQuality(NewSettings.TextureQuality, Profile);
+    AddLODSettings(NewSettings.LODBias, NewSettings.MaxDrawDistance, Profile);
+    AddDynamicResolutionSettings(NewSettings.bEnableDynamicResolution, Profile);
+    Profile.Set(TEXT("t.MaxFPS"), NewSettings.TargetFrameRate);
     
-    // Set console variables for optimization
-    SetConsoleVariables();
+    CurrentSettings.LODBias = NewSettings.LODBias;
+    CurrentSettings.MaxDrawDistance = NewSettings.MaxDrawDistance;
     
-    // Apply texture quality
-    SetTextureQuality(Settings.TextureQuality);
+    ProfileApplier.Apply(Profile, *UEnum::GetValueAsString(NewSettings.QualityLevel));
     
-    // Apply LOD settings
-    SetLODBias(Settings.LODBias);
-    SetMaxDrawDistance(Settings.MaxDrawDistance);
+    // Non console state that used to be set through the individual setters
+    bDynamicResolutionEnabled = NewSettings.bEnableDynamicResolution;
+    FrameTimeStats.SetHitchThreshold(GetFrameBudgetMs() * 2.0f);
+    ConfigureResolutionController();
+    ResolutionController.Reset(CurrentResolutionScale);
     
-    // Apply dynamic resolution
-    EnableDynamicResolution(Settings.bEnableDynamicResolution);
-    SetTargetFrameRate(Settings.TargetFrameRate);
+    // Reset clamps to the new profile's range; apply what the controller ended up with
+    SetResolutionScale(ResolutionController.GetAppliedScale());
+    ConfigurePerformanceGovernor();
+    ApplyPerformanceBudgets();
+    OptimizeMaterials();
     
     // Update material parameter collection
     if (OptimizationMPC)
@@ -140,66 +240,209 @@ void UMobileOptimizationManager::ApplyOptimizationSettings(const FMobileOptimiza
         UMaterialParameterCollectionInstance* MPCInstance = GetWorld()->GetParameterCollectionInstance(OptimizationMPC);
         if (MPCInstance)
         {
-            MPCInstance->SetScalarParameterValue("QualityLevel", (float)Settings.QualityLevel);
-            MPCInstance->SetScalarParameterValue("LODBias", Settings.LODBias);
-            MPCInstance->SetScalarParameterValue("MaxDrawDistance", Settings.MaxDrawDistance);
-            MPCInstance->SetScalarParameterValue("ShadowQuality", Settings.bEnableShadows ? 1.0f : 0.0f);
+            MPCInstance->SetScalarParameterValue("QualityLevel", (float)NewSettings.QualityLevel);
+            MPCInstance->SetScalarParameterValue("LODBias", NewSettings.LODBias);
+            MPCInstance->SetScalarParameterValue("MaxDrawDistance", NewSettings.MaxDrawDistance);
+            MPCInstance->SetScalarParameterValue("ShadowQuality", NewSettings.bEnableShadows ? 1.0f : 0.0f);
         }
     }
 }
 
 void UMobileOptimizationManager::SetQualityLevel(EMobileQualityLevel QualityLevel)
 {
+    if (QualityLevel == EMobileQualityLevel::Auto)
+    {
+        QualityLevel = ResolveAutoQualityLevel();
+    }
+    
     CurrentSettings.QualityLevel = QualityLevel;
-    ApplyQualitySettings(QualityLevel);
+    
+    FQualityProfile Profile;
+    ApplyQualitySettings(QualityLevel, Profile);
+    ProfileApplier.Apply(Profile, *UEnum::GetValueAsString(QualityLevel));
+    OptimizeMaterials();
 }
 
-void UMobileOptimizationManager::ApplyQualitySettings(EMobileQualityLevel QualityLevel)
+void UMobileOptimizationManager::ApplyQualitySettings(EMobileQualityLevel QualityLevel, FQualityProfile& Profile)
 {
     switch (QualityLevel)
     {
         case EMobileQualityLevel::Low:
-            OptimizeForLowEnd();
+            OptimizeForLowEnd(Profile);
             break;
         case EMobileQualityLevel::Medium:
-            OptimizeForMidRange();
+            OptimizeForMidRange(Profile);
             break;
         case EMobileQualityLevel::High:
         case EMobileQualityLevel::Ultra:
-            OptimizeForHighEnd();
+            OptimizeForHighEnd(Profile);
             break;
         case EMobileQualityLevel::Auto:
-            AutoDetectQualityLevel();
+            ApplyQualitySettings(ResolveAutoQualityLevel(), Profile);
             break;
     }
 }
 
 void UMobileOptimizationManager::AutoDetectQualityLevel()
+{
+    FMobileOptimizationSettings DetectedSettings;
+    SelectAutoDetectedSettings(DetectedSettings);
+    ApplyOptimizationSettings(DetectedSettings);
+}
+
+void UMobileOptimizationManager::SelectAutoDetectedSettings(FMobileOptimizationSettings& OutSettings)
 {
     FString DeviceModel = DetectDeviceModel();
     
     // Check if we have a specific profile for this device
     if (FMobileOptimizationSettings* DeviceProfile = DeviceProfiles.Find(DeviceModel))
     {
-        ApplyOptimizationSettings(*DeviceProfile);
+        OutSettings = *DeviceProfile;
+        return;
+    }
+    
+    // Unknown device: map the calibration score through the tier table
+    if (CalibrationResult.bIsValid)
+    {
+        const FMobileCalibrationTierRow Tier = SelectCalibrationTier(CalibrationResult.CombinedScore);
+        UE_LOG(LogTemp, Log, TEXT("Calibration score %.2f selects %s %s"), CalibrationResult.CombinedScore,
+            *UEnum::GetValueAsString(Tier.QualityLevel), *Tier.DeviceProfile);
+        
+        if (FMobileOptimizationSettings* TierProfile = DeviceProfiles.Find(Tier.DeviceProfile))
+        {
+            OutSettings = *TierProfile;
+            return;
+        }
+        
+        OutSettings = CurrentSettings;
+        OutSettings.QualityLevel = Tier.QualityLevel;
+        return;
+    }
+    
+    OutSettings = CurrentSettings;
+    OutSettings.QualityLevel = ResolveAutoQualityLevel();
+}
+
+void UMobileOptimizationManager::EnsureDeviceCalibration()
+{
+    if (!bEnableCalibration || CalibrationResult.bIsValid || PendingCalibration)
+    {
         return;
     }
     
-    // Fallback to performance-based detection
-    float AverageFPS = CurrentMetrics.AverageFPS;
+    // Cached per app version, so the benchmark only runs on first launch and after updates
+    const FDeviceCalibrationResult& Cached = FDeviceCalibration::GetCached();
+    if (Cached.bIsValid)
+    {
+        CalibrationResult = Cached;
+        return;
+    }
     
-    if (AverageFPS >= 55.0f)
+    // Measured a slice per frame from tick; only devices with their own profile are set up before it finishes
+    PendingCalibration = MakeUnique<FDeviceCalibrationRun>(CalibrationBudgetMs);
+}
+
+bool UMobileOptimizationManager::UpdateDeviceCalibration()
+{
+    if (!PendingCalibration)
     {
-        SetQualityLevel(EMobileQualityLevel::High);
+        return false;
     }
-    else if (AverageFPS >= 45.0f)
+    
+    if (!PendingCalibration->Step(CalibrationSliceMs))
     {
-        SetQualityLevel(EMobileQualityLevel::Medium);
+        return true;
     }
-    else
+    
+    CalibrationResult = PendingCalibration->GetResult();
+    PendingCalibration.Reset();
+    
+    FDeviceCalibration::SaveResult(CalibrationResult);
+    
+    // Devices with their own profile were set up at startup already
+    if (bDetectAfterCalibration)
+    {
+        bDetectAfterCalibration = false;
+        AutoDetectQualityLevel();
+    }
+    return true;
+}
+
+void UMobileOptimizationManager::RecalibrateDevice()
+{
+    PendingCalibration = MakeUnique<FDeviceCalibrationRun>(CalibrationBudgetMs);
+    bDetectAfterCalibration = true;
+}
+
+FMobileCalibrationTierRow UMobileOptimizationManager::SelectCalibrationTier(float Score) const
+{
+    FMobileCalibrationTierRow BestTier;
+    bool bFoundTier = false;
+    
+    if (CalibrationTierTable)
+    {
+        TArray<FMobileCalibrationTierRow*> Rows;
+        CalibrationTierTable->GetAllRows<FMobileCalibrationTierRow>(TEXT("SelectCalibrationTier"), Rows);
+        
+        // Highest MinScore the device reaches wins, regardless of row order
+        for (const FMobileCalibrationTierRow* Row : Rows)
+        {
+            if (Row && Score >= Row->MinScore && (!bFoundTier || Row->MinScore > BestTier.MinScore))
+            {
+                BestTier = *Row;
+                bFoundTier = true;
+            }
+        }
+    }
+    
+    if (!bFoundTier)
+    {
+        switch (FDeviceCalibration::GetPerformanceTier(CalibrationResult))
+        {
+            case 0:
+                BestTier.QualityLevel = EMobileQualityLevel::Low;
+                BestTier.DeviceProfile = TEXT("LowEnd");
+                break;
+            case 2:
+                BestTier.QualityLevel = EMobileQualityLevel::High;
+                BestTier.DeviceProfile = TEXT("HighEnd");
+                break;
+            default:
+                BestTier.QualityLevel = EMobileQualityLevel::Medium;
+                break;
+        }
+    }
+    
+    return BestTier;
+}
+
+EMobileQualityLevel UMobileOptimizationManager::ResolveAutoQualityLevel() const
+{
+    // At startup the frame time window is still empty, so prefer the calibration
+    if (CalibrationResult.bIsValid && FrameTimeStats.Num() < FFrameTimeStats::WindowSize)
     {
-        SetQualityLevel(EMobileQualityLevel::Low);
+        return SelectCalibrationTier(CalibrationResult.CombinedScore).QualityLevel;
     }
+    
+    // Without calibration and before a full window of frames the percentiles are still their defaults
+    if (FrameTimeStats.Num() < FFrameTimeStats::WindowSize)
+    {
+        return EMobileQualityLevel::Medium;
+    }
+    
+    // Fallback to performance-based detection using the sustained (p95) frame rate
+    float SustainedFPS = CurrentMetrics.P95FrameTime > 0.0f ? 1000.0f / CurrentMetrics.P95FrameTime : CurrentMetrics.AverageFPS;
+    
+    if (SustainedFPS >= 55.0f)
+    {
+        return EMobileQualityLevel::High;
+    }
+    else if (SustainedFPS >= 45.0f)
+    {
+        return EMobileQualityLevel::Medium;
+    }
+    
+    return EMobileQualityLevel::Low;
 }
 
 FString UMobileOptimizationManager::DetectDeviceModel()
@@ -235,22 +478,23 @@ void UMobileOptimizationManager::EnableDynamicResolution(bool bEnable)
     bDynamicResolutionEnabled = bEnable;
     CurrentSettings.bEnableDynamicResolution = bEnable;
     
+    ConfigureResolutionController();
+    ResolutionController.Reset(CurrentResolutionScale);
+    SetResolutionScale(ResolutionController.GetAppliedScale());
+    
+    FQualityProfile Profile;
+    AddDynamicResolutionSettings(bEnable, Profile);
+    ProfileApplier.Apply(Profile);
+}
+
+void UMobileOptimizationManager::AddDynamicResolutionSettings(bool bEnable, FQualityProfile& Profile) const
+{
+    Profile.Set(TEXT("r.DynamicRes.OperationMode"), bEnable ? 1 : 0);
+    
     if (bEnable)
     {
-        // Enable dynamic resolution scaling
-        if (GEngine)
-        {
-            GEngine->Exec(GetWorld(), TEXT("r.DynamicRes.OperationMode 1"));
-            GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.DynamicRes.MinResolutionScale %f"), CurrentSettings.MinResolutionScale));
-            GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.DynamicRes.MaxResolutionScale %f"), CurrentSettings.MaxResolutionScale));
-        }
-    }
-    else
-    {
-        if (GEngine)
-        {
-            GEngine->Exec(GetWorld(), TEXT("r.DynamicRes.OperationMode 0"));
-        }
+        Profile.Set(TEXT("r.DynamicRes.MinResolutionScale"), CurrentSettings.MinResolutionScale);
+        Profile.Set(TEXT("r.DynamicRes.MaxResolutionScale"), CurrentSettings.MaxResolutionScale);
     }
 }
 
@@ -258,26 +502,38 @@ void UMobileOptimizationManager::SetResolutionScale(float Scale)
 {
     CurrentResolutionScale = FMath::Clamp(Scale, CurrentSettings.MinResolutionScale, CurrentSettings.MaxResolutionScale);
     
-    if (GEngine)
+    // Keep the controller in sync with manual overrides
+    if (!FMath::IsNearlyEqual(ResolutionController.GetAppliedScale(), CurrentResolutionScale))
     {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.ScreenPercentage %f"), CurrentResolutionScale * 100.0f));
+        ResolutionController.Reset(CurrentResolutionScale);
     }
+    
+    ProfileApplier.ApplySingle(TEXT("r.ScreenPercentage"), CurrentResolutionScale * 100.0f);
 }
 
 void UMobileOptimizationManager::SetTargetFrameRate(float TargetFPS)
 {
     CurrentSettings.TargetFrameRate = TargetFPS;
     
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("t.MaxFPS %f"), TargetFPS));
-    }
+    // A hitch is any frame that misses two vsync intervals
+    FrameTimeStats.SetHitchThreshold(GetFrameBudgetMs() * 2.0f);
+    ConfigureResolutionController();
+    ConfigurePerformanceGovernor();
+    
+    ProfileApplier.ApplySingle(TEXT("t.MaxFPS"), TargetFPS);
 }
 
 void UMobileOptimizationManager::SetTextureQuality(EMobileTextureQuality Quality)
 {
     CurrentSettings.TextureQuality = Quality;
     
+    FQualityProfile Profile;
+    AddTextureQuality(Quality, Profile);
+    ProfileApplier.Apply(Profile);
+}
+
+void UMobileOptimizationManager::AddTextureQuality(EMobileTextureQuality Quality, FQualityProfile& Profile) const
+{
     float TextureScale = 1.0f;
     switch (Quality)
     {
@@ -295,31 +551,32 @@ void UMobileOptimizationManager::SetTextureQuality(EMobileTextureQuality Quality
             break;
     }
     
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.Streaming.MipBias %f"), FMath::Log2(1.0f / TextureScale)));
-    }
+    Profile.Set(TEXT("r.Streaming.MipBias"), FMath::Log2(1.0f / TextureScale));
 }
 
 void UMobileOptimizationManager::SetLODBias(float Bias)
 {
     CurrentSettings.LODBias = Bias;
     
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.StaticMeshLODBias %f"), Bias));
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.SkeletalMeshLODBias %f"), Bias));
-    }
+    FQualityProfile Profile;
+    AddLODSettings(Bias, CurrentSettings.MaxDrawDistance, Profile);
+    ProfileApplier.Apply(Profile);
 }
 
 void UMobileOptimizationManager::SetMaxDrawDistance(float Distance)
 {
     CurrentSettings.MaxDrawDistance = Distance;
     
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.DrawDistanceScale %f"), Distance / 5000.0f));
-    }
+    FQualityProfile Profile;
+    AddLODSettings(CurrentSettings.LODBias, Distance, Profile);
+    ProfileApplier.Apply(Profile);
+}
+
+void UMobileOptimizationManager::AddLODSettings(float Bias, float Distance, FQualityProfile& Profile) const
+{
+    Profile.Set(TEXT("r.StaticMeshLODBias"), Bias);
+    Profile.Set(TEXT("r.SkeletalMeshLODBias"), Bias);
+    Profile.Set(TEXT("r.DrawDistanceScale"), Distance / 5000.0f);
 }
 
 void UMobileOptimizationManager::UpdatePerformanceMetrics(float DeltaTime)
@@ -327,36 +584,35 @@ void UMobileOptimizationManager::UpdatePerformanceMetrics(float DeltaTime)
     PerformanceTimer += DeltaTime;
     FrameCounter++;
     
-    // Update FPS
+    // Update frame time statistics
     if (DeltaTime > 0.0f)
     {
         CurrentMetrics.CurrentFPS = 1.0f / DeltaTime;
         CurrentMetrics.FrameTime = DeltaTime * 1000.0f; // Convert to milliseconds
         
-        // Add to history
-        FPSHistory.Add(CurrentMetrics.CurrentFPS);
-        if (FPSHistory.Num() > 60)
-        {
-            FPSHistory.RemoveAt(0);
-        }
+        FrameTimeStats.AddSample(CurrentMetrics.FrameTime);
         
-        // Calculate average FPS
-        float TotalFPS = 0.0f;
-        for (float FPS : FPSHistory)
-        {
-            TotalFPS += FPS;
-        }
-        CurrentMetrics.AverageFPS = TotalFPS / FPSHistory.Num();
+        // Average FPS is derived from the mean frame time so spikes are not hidden
+        CurrentMetrics.AverageFrameTime = FrameTimeStats.GetAverage();
+        CurrentMetrics.AverageFPS = CurrentMetrics.AverageFrameTime > 0.0f ? 1000.0f / CurrentMetrics.AverageFrameTime : 0.0f;
+        
+        FrameTimeStats.GetPercentiles(CurrentMetrics.P50FrameTime, CurrentMetrics.P95FrameTime, CurrentMetrics.P99FrameTime);
+        CurrentMetrics.MaxFrameTime = FrameTimeStats.GetMax();
+        CurrentMetrics.OnePercentLowFPS = CurrentMetrics.P99FrameTime > 0.0f ? 1000.0f / CurrentMetrics.P99FrameTime : 0.0f;
+        CurrentMetrics.HitchCount = FrameTimeStats.GetWindowHitchCount();
+        CurrentMetrics.TotalHitchCount = FrameTimeStats.GetTotalHitchCount();
     }
     
     // Update other metrics periodically
     if (PerformanceTimer >= PerformanceUpdateInterval)
     {
-        // Get rendering stats (simplified - would need proper stat gathering in production)
-        CurrentMetrics.DrawCalls = 0; // Would get from rendering stats
-        CurrentMetrics.Triangles = 0; // Would get from rendering stats
-        CurrentMetrics.GPUTime = 0.0f; // Would get from GPU profiling
-        CurrentMetrics.CPUTime = CurrentMetrics.FrameTime;
+        const FRenderMetricsSample& RenderSample = IPerformanceMetricsProvider::GetFrameSample(GetWorld());
+        CurrentMetrics.DrawCalls = RenderSample.DrawCalls;
+        CurrentMetrics.Triangles = RenderSample.PrimitivesDrawn;
+        CurrentMetrics.GPUTime = RenderSample.GPUTimeMs;
+        CurrentMetrics.CPUTime = RenderSample.GameThreadMs;
+        CurrentMetrics.RenderThreadTime = RenderSample.RenderThreadMs;
+        CurrentMetrics.MetricsSource = RenderSample.Source;
         CurrentMetrics.MemoryUsage = GetMemoryUsage();
         CurrentMetrics.CurrentResolutionScale = CurrentResolutionScale;
         
@@ -364,24 +620,115 @@ void UMobileOptimizationManager::UpdatePerformanceMetrics(float DeltaTime)
     }
 }
 
-void UMobileOptimizationManager::AdjustDynamicResolution()
+void UMobileOptimizationManager::AdjustDynamicResolution(float DeltaTime)
 {
     if (!bDynamicResolutionEnabled) return;
     
-    float TargetFPS = CurrentSettings.TargetFrameRate;
-    float CurrentFPS = CurrentMetrics.CurrentFPS;
-    float FPSDifference = CurrentFPS - TargetFPS;
+    // The controller smooths the frame time itself and only reports quantized changes,
+    // so r.ScreenPercentage is written only when the applied scale actually moves
+    if (ResolutionController.Update(CurrentMetrics.FrameTime, DeltaTime))
+    {
+        SetResolutionScale(ResolutionController.GetAppliedScale());
+    }
+}
+
+void UMobileOptimizationManager::ConfigureResolutionController()
+{
+    FDynamicResolutionControllerSettings ControllerSettings;
+    ControllerSettings.TargetFrameTimeMs = GetFrameBudgetMs();
+    ControllerSettings.MinScale = CurrentSettings.MinResolutionScale;
+    ControllerSettings.MaxScale = CurrentSettings.MaxResolutionScale;
+    ControllerSettings.MaxScaleRatePerSecond = ResolutionAdjustmentSpeed;
+    ControllerSettings.Deadband = ResolutionDeadband;
+    ControllerSettings.QuantizationStep = ResolutionScaleStep;
+    ControllerSettings.PredictionHorizonSeconds = ResolutionPredictionHorizon;
+    
+    ResolutionController.Configure(ControllerSettings);
+}
+
+void UMobileOptimizationManager::ConfigurePerformanceGovernor()
+{
+    FPerformanceGovernorSettings GovernorSettings = PerformanceGovernor.GetSettings();
+    GovernorSettings.TargetFrameTimeMs = GetFrameBudgetMs();
+    PerformanceGovernor.Configure(GovernorSettings);
+}
+
+void UMobileOptimizationManager::EnablePerformanceGovernor(bool bEnable)
+{
+    if (bEnablePerformanceGovernor == bEnable)
+    {
+        return;
+    }
+    
+    bEnablePerformanceGovernor = bEnable;
+    
+    // Hand back the full budgets when the governor is switched off
+    if (!bEnable && PerformanceGovernor.GetLevel() > 0)
+    {
+        PerformanceGovernor.Reset();
+        ApplyPerformanceBudgets();
+    }
+}
+
+int32 UMobileOptimizationManager::GetPerformanceBudgetLevel() const
+{
+    return PerformanceGovernor.GetLevel();
+}
+
+float UMobileOptimizationManager::GetEffectSignificanceScale(EMobileQualityLevel QualityLevel)
+{
+    switch (QualityLevel)
+    {
+        case EMobileQualityLevel::Low:
+            return 0.5f;
+        case EMobileQualityLevel::Medium:
+            return 0.75f;
+        case EMobileQualityLevel::Ultra:
+            return 1.25f;
+        default:
+            return 1.0f;
+    }
+}
+
+void UMobileOptimizationManager::ApplyPerformanceBudgets()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+    
+    const FPerformanceBudgets& Budgets = PerformanceGovernor.GetBudgets();
     
-    // Adjust resolution based on FPS performance
-    if (FPSDifference < -5.0f) // FPS too low
+    for (TActorIterator<AModularEnvironmentSystem> It(World); It; ++It)
     {
-        float NewScale = CurrentResolutionScale - (ResolutionAdjustmentSpeed * 0.1f);
-        SetResolutionScale(NewScale);
+        It->SetPerformanceBudget(Budgets.EnvironmentInstanceScale, FMath::Max(1, FMath::RoundToInt(CurrentSettings.MaxDrawCalls * Budgets.EnvironmentInstanceScale)));
     }
-    else if (FPSDifference > 5.0f) // FPS too high, can increase quality
+    
+    // Decisions are rare, so walking the component lists here is cheap enough
+    for (TObjectIterator<UAnimeEffectsManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            It->SetEffectBudget(FMath::Min(Budgets.MaxConcurrentEffects, CurrentSettings.MaxActiveEffects), Budgets.EffectScale);
+            It->SetSignificanceScale(GetEffectSignificanceScale(CurrentSettings.QualityLevel));
+        }
+    }
+    
+    for (TObjectIterator<UAnimeMaterialManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            It->SetGlobalUpdateRate(Budgets.MaterialUpdateRate);
+        }
+    }
+    
+    for (TObjectIterator<UAnimeUIManager> It; It; ++It)
     {
-        float NewScale = CurrentResolutionScale + (ResolutionAdjustmentSpeed * 0.05f);
-        SetResolutionScale(NewScale);
+        if (It->GetWorld() == World)
+        {
+            It->SetAnimationUpdateRate(Budgets.UIAnimationRate);
+        }
     }
 }
 
@@ -392,13 +739,19 @@ FPerformanceMetrics UMobileOptimizationManager::GetPerformanceMetrics()
 
 bool UMobileOptimizationManager::IsPerformanceTargetMet()
 {
-    return CurrentMetrics.AverageFPS >= (CurrentSettings.TargetFrameRate * 0.9f); // 90% of target
+    // 95% of frames must land within the budget of 90% of the target frame rate
+    return CurrentMetrics.P95FrameTime <= GetFrameBudgetMs() / 0.9f;
+}
+
+float UMobileOptimizationManager::GetFrameBudgetMs() const
+{
+    return 1000.0f / FMath::Max(CurrentSettings.TargetFrameRate, 1.0f);
 }
 
 void UMobileOptimizationManager::StartPerformanceMonitoring()
 {
     bEnablePerformanceMonitoring = true;
-    FPSHistory.Empty();
+    FrameTimeStats.Reset();
     PerformanceTimer = 0.0f;
     FrameCounter = 0;
 }
@@ -415,16 +768,107 @@ float UMobileOptimizationManager::GetMemoryUsage()
     return MemStats.UsedPhysical / (1024.0f * 1024.0f); // Convert to MB
 }
 
+float UMobileOptimizationManager::GetSubsystemMemoryMB(EMemoryBudgetCategory Category) const
+{
+    return MemoryTracker.GetBytes(Category) / (1024.0f * 1024.0f);
+}
+
+bool UMobileOptimizationManager::IsSubsystemOverMemoryBudget(EMemoryBudgetCategory Category) const
+{
+    return MemoryTracker.IsOverBudget(Category);
+}
+
+bool UMobileOptimizationManager::WriteMemorySoakReport()
+{
+    const FString FilePath = FPaths::ProfilingDir() / TEXT("MemorySoak") /
+        FString::Printf(TEXT("MemorySoak_%s.csv"), *FDateTime::Now().ToString());
+    
+    return MemoryTracker.WriteSoakReport(FilePath, CurrentSettings.MemoryBudgets);
+}
+
+void UMobileOptimizationManager::UpdateMemoryBudgets(float DeltaTime)
+{
+    MemorySampleTimer += DeltaTime;
+    if (MemorySampleTimer < MemorySampleInterval)
+    {
+        return;
+    }
+    MemorySampleTimer = 0.0f;
+    
+    MemoryTracker.Sample(GetWorld(), GetWorld()->GetTimeSeconds());
+    
+    // Over budget counts as over the frame budget for the governor, so it sheds work and does not upshift
+    PerformanceGovernor.SetMemoryPressure(MemoryTracker.CheckBudgets(CurrentSettings.MemoryBudgets));
+}
+
+void UMobileOptimizationManager::RecordTelemetry(float DeltaTime)
+{
+    if (!TelemetryRecorder.IsRecording())
+    {
+        return;
+    }
+    
+    TelemetryTimer += DeltaTime;
+    if (TelemetryTimer < 1.0f)
+    {
+        return;
+    }
+    TelemetryTimer -= 1.0f;
+    
+    UWorld* World = GetWorld();
+    
+    FTelemetryRow Row;
+    Row.TimeSeconds = World->GetTimeSeconds();
+    Row.TargetFrameMs = GetFrameBudgetMs();
+    Row.AverageFrameMs = CurrentMetrics.AverageFrameTime;
+    Row.P50FrameMs = CurrentMetrics.P50FrameTime;
+    Row.P95FrameMs = CurrentMetrics.P95FrameTime;
+    Row.P99FrameMs = CurrentMetrics.P99FrameTime;
+    Row.MaxFrameMs = CurrentMetrics.MaxFrameTime;
+    Row.ResolutionScale = CurrentResolutionScale;
+    Row.QualityLevel = (int32)CurrentSettings.QualityLevel;
+    Row.GovernorLevel = PerformanceGovernor.GetLevel();
+    Row.DrawCalls = CurrentMetrics.DrawCalls;
+    Row.MemoryMB = CurrentMetrics.MemoryUsage;
+    
+    for (TActorIterator<AModularEnvironmentSystem> It(World); It; ++It)
+    {
+        Row.ISMInstances += It->GetInstanceCount();
+    }
+    
+    for (TObjectIterator<UAnimeEffectsManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            Row.ActiveEffects += It->GetActiveEffectCount();
+        }
+    }
+    
+    // Users above MIDs is what the material cache saves; draw calls show whether the shared instances batch
+    for (TObjectIterator<UAnimeMaterialManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            Row.ActiveMIDs += It->GetActiveMaterialCount();
+            Row.MaterialUsers += It->GetMaterialUserCount();
+        }
+    }
+    
+    if (const AAWRGameModeBase* GameMode = World->GetAuthGameMode<AAWRGameModeBase>())
+    {
+        Row.RunDistance = GameMode->GetDistanceTraveled();
+    }
+    
+    TelemetryRecorder.AddRow(Row);
+}
+
 void UMobileOptimizationManager::OptimizeMemoryUsage()
 {
     // Force garbage collection
     GarbageCollect();
     
     // Reduce texture streaming pool
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), TEXT("r.Streaming.PoolSize 512"));
-    }
+    ProfileApplier.ApplySingle(TEXT("r.Streaming.PoolSize"), 512);
 }
 
 void UMobileOptimizationManager::GarbageCollect()
@@ -435,121 +879,108 @@ void UMobileOptimizationManager::GarbageCollect()
     }
 }
 
-void UMobileOptimizationManager::SetConsoleVariables()
+void UMobileOptimizationManager::SetConsoleVariables(FQualityProfile& Profile) const
 {
-    if (!GEngine) return;
-    
     // Mobile-specific optimizations
-    GEngine->Exec(GetWorld(), TEXT("r.Mobile.EnableStaticAndCSMShadowReceivers 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.Mobile.EnableMovableLightCSMShaderCulling 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.Mobile.AllowDitheredLODTransition 1"));
+    Profile.Set(TEXT("r.Mobile.EnableStaticAndCSMShadowReceivers"), 1);
+    Profile.Set(TEXT("r.Mobile.EnableMovableLightCSMShaderCulling"), 1);
+    Profile.Set(TEXT("r.Mobile.AllowDitheredLODTransition"), 1);
     
     // Occlusion culling
-    if (CurrentSettings.bEnableOcclusion)
-    {
-        GEngine->Exec(GetWorld(), TEXT("r.HZBOcclusion 1"));
-        GEngine->Exec(GetWorld(), TEXT("r.OcclusionCulling 1"));
-    }
-    else
-    {
-        GEngine->Exec(GetWorld(), TEXT("r.HZBOcclusion 0"));
-        GEngine->Exec(GetWorld(), TEXT("r.OcclusionCulling 0"));
-    }
+    Profile.Set(TEXT("r.HZBOcclusion"), CurrentSettings.bEnableOcclusion);
+    Profile.Set(TEXT("r.OcclusionCulling"), CurrentSettings.bEnableOcclusion);
     
     // Shadow settings
     if (CurrentSettings.bEnableShadows)
     {
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.Shadow.MaxResolution %d"), CurrentSettings.ShadowMapResolution));
-        GEngine->Exec(GetWorld(), *FString::Printf(TEXT("r.Shadow.DistanceScale %f"), CurrentSettings.ShadowDistance / 1000.0f));
+        Profile.Set(TEXT("r.Shadow.MaxResolution"), CurrentSettings.ShadowMapResolution);
+        Profile.Set(TEXT("r.Shadow.DistanceScale"), CurrentSettings.ShadowDistance / 1000.0f);
     }
     else
     {
-        GEngine->Exec(GetWorld(), TEXT("r.Shadow.MaxResolution 0"));
+        Profile.Set(TEXT("r.Shadow.MaxResolution"), 0);
     }
     
     // Post processing
     if (!CurrentSettings.bEnablePostProcessing)
     {
-        GEngine->Exec(GetWorld(), TEXT("r.PostProcessAAQuality 0"));
-        GEngine->Exec(GetWorld(), TEXT("r.BloomQuality 0"));
+        Profile.Set(TEXT("r.PostProcessAAQuality"), 0);
+        Profile.Set(TEXT("r.BloomQuality"), 0);
     }
     else
     {
         if (CurrentSettings.bEnableAntiAliasing)
         {
-            GEngine->Exec(GetWorld(), TEXT("r.PostProcessAAQuality 2"));
+            Profile.Set(TEXT("r.PostProcessAAQuality"), 2);
         }
         if (CurrentSettings.bEnableBloom)
         {
-            GEngine->Exec(GetWorld(), TEXT("r.BloomQuality 2"));
+            Profile.Set(TEXT("r.BloomQuality"), 2);
         }
     }
 }
 
-void UMobileOptimizationManager::OptimizeForLowEnd()
+void UMobileOptimizationManager::OptimizeForLowEnd(FQualityProfile& Profile)
 {
-    if (!GEngine) return;
-    
     // Aggressive optimizations for low-end devices
-    GEngine->Exec(GetWorld(), TEXT("r.MaterialQualityLevel 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.ShadowQuality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.PostProcessAAQuality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.BloomQuality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.LightShaftQuality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.RefractionQuality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.SSR.Quality 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.DetailMode 0"));
-    GEngine->Exec(GetWorld(), TEXT("r.TranslucencyLightingVolume 0"));
+    Profile.Set(TEXT("r.MaterialQualityLevel"), 0);
+    Profile.Set(TEXT("r.ShadowQuality"), 0);
+    Profile.Set(TEXT("r.PostProcessAAQuality"), 0);
+    Profile.Set(TEXT("r.BloomQuality"), 0);
+    Profile.Set(TEXT("r.LightShaftQuality"), 0);
+    Profile.Set(TEXT("r.RefractionQuality"), 0);
+    Profile.Set(TEXT("r.SSR.Quality"), 0);
+    Profile.Set(TEXT("r.DetailMode"), 0);
+    Profile.Set(TEXT("r.TranslucencyLightingVolume"), 0);
     
     // Reduce draw distance and LOD bias
-    SetLODBias(2.0f);
-    SetMaxDrawDistance(1500.0f);
+    CurrentSettings.LODBias = 2.0f;
+    CurrentSettings.MaxDrawDistance = 1500.0f;
+    AddLODSettings(CurrentSettings.LODBias, CurrentSettings.MaxDrawDistance, Profile);
     
     // Disable expensive features
-    GEngine->Exec(GetWorld(), TEXT("fx.MaxGPUParticlesSpawnedPerFrame 64"));
-    GEngine->Exec(GetWorld(), TEXT("r.Streaming.MipBias 2"));
+    Profile.Set(TEXT("fx.MaxGPUParticlesSpawnedPerFrame"), 64);
+    Profile.Set(TEXT("r.Streaming.MipBias"), 2);
 }
 
-void UMobileOptimizationManager::OptimizeForMidRange()
+void UMobileOptimizationManager::OptimizeForMidRange(FQualityProfile& Profile)
 {
-    if (!GEngine) return;
-    
     // Balanced settings for mid-range devices like Samsung A56
-    GEngine->Exec(GetWorld(), TEXT("r.MaterialQualityLevel 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.ShadowQuality 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.PostProcessAAQuality 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.BloomQuality 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.LightShaftQuality 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.RefractionQuality 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.SSR.Quality 1"));
-    GEngine->Exec(GetWorld(), TEXT("r.DetailMode 1"));
+    Profile.Set(TEXT("r.MaterialQualityLevel"), 1);
+    Profile.Set(TEXT("r.ShadowQuality"), 2);
+    Profile.Set(TEXT("r.PostProcessAAQuality"), 1);
+    Profile.Set(TEXT("r.BloomQuality"), 1);
+    Profile.Set(TEXT("r.LightShaftQuality"), 1);
+    Profile.Set(TEXT("r.RefractionQuality"), 1);
+    Profile.Set(TEXT("r.SSR.Quality"), 1);
+    Profile.Set(TEXT("r.DetailMode"), 1);
     
-    SetLODBias(1.0f);
-    SetMaxDrawDistance(2500.0f);
+    CurrentSettings.LODBias = 1.0f;
+    CurrentSettings.MaxDrawDistance = 2500.0f;
+    AddLODSettings(CurrentSettings.LODBias, CurrentSettings.MaxDrawDistance, Profile);
     
-    GEngine->Exec(GetWorld(), TEXT("fx.MaxGPUParticlesSpawnedPerFrame 128"));
-    GEngine->Exec(GetWorld(), TEXT("r.Streaming.MipBias 1"));
+    Profile.Set(TEXT("fx.MaxGPUParticlesSpawnedPerFrame"), 128);
+    Profile.Set(TEXT("r.Streaming.MipBias"), 1);
 }
 
-void UMobileOptimizationManager::OptimizeForHighEnd()
+void UMobileOptimizationManager::OptimizeForHighEnd(FQualityProfile& Profile)
 {
-    if (!GEngine) return;
-    
     // High quality settings for premium devices
-    GEngine->Exec(GetWorld(), TEXT("r.MaterialQualityLevel 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.ShadowQuality 3"));
-    GEngine->Exec(GetWorld(), TEXT("r.PostProcessAAQuality 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.BloomQuality 3"));
-    GEngine->Exec(GetWorld(), TEXT("r.LightShaftQuality 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.RefractionQuality 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.SSR.Quality 2"));
-    GEngine->Exec(GetWorld(), TEXT("r.DetailMode 2"));
+    Profile.Set(TEXT("r.MaterialQualityLevel"), 2);
+    Profile.Set(TEXT("r.ShadowQuality"), 3);
+    Profile.Set(TEXT("r.PostProcessAAQuality"), 2);
+    Profile.Set(TEXT("r.BloomQuality"), 3);
+    Profile.Set(TEXT("r.LightShaftQuality"), 2);
+    Profile.Set(TEXT("r.RefractionQuality"), 2);
+    Profile.Set(TEXT("r.SSR.Quality"), 2);
+    Profile.Set(TEXT("r.DetailMode"), 2);
     
-    SetLODBias(0.5f);
-    SetMaxDrawDistance(4000.0f);
+    CurrentSettings.LODBias = 0.5f;
+    CurrentSettings.MaxDrawDistance = 4000.0f;
+    AddLODSettings(CurrentSettings.LODBias, CurrentSettings.MaxDrawDistance, Profile);
     
-    GEngine->Exec(GetWorld(), TEXT("fx.MaxGPUParticlesSpawnedPerFrame 256"));
-    GEngine->Exec(GetWorld(), TEXT("r.Streaming.MipBias 0"));
+    Profile.Set(TEXT("fx.MaxGPUParticlesSpawnedPerFrame"), 256);
+    Profile.Set(TEXT("r.Streaming.MipBias"), 0);
 }
 
 void UMobileOptimizationManager::OptimizeRenderingSettings()
@@ -567,33 +998,25 @@ void UMobileOptimizationManager::EnableInstancing(bool bEnable)
 {
     CurrentSettings.bEnableInstancing = bEnable;
     
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), bEnable ? TEXT("r.InstancedStereo 1") : TEXT("r.InstancedStereo 0"));
-    }
+    ProfileApplier.ApplySingle(TEXT("r.InstancedStereo"), bEnable ? 1 : 0);
 }
 
 void UMobileOptimizationManager::CompressTextures()
 {
     // Enable ASTC texture compression for mobile
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), TEXT("r.Mobile.UseHWsRGBEncoding 1"));
-    }
+    ProfileApplier.ApplySingle(TEXT("r.Mobile.UseHWsRGBEncoding"), 1);
 }
 
 void UMobileOptimizationManager::StreamTextures(bool bEnable)
 {
-    if (GEngine)
-    {
-        GEngine->Exec(GetWorld(), bEnable ? TEXT("r.TextureStreaming 1") : TEXT("r.TextureStreaming 0"));
-    }
+    ProfileApplier.ApplySingle(TEXT("r.TextureStreaming"), bEnable ? 1 : 0);
 }
 
 void UMobileOptimizationManager::UpdateLODSettings()
 {
-    SetLODBias(CurrentSettings.LODBias);
-    SetMaxDrawDistance(CurrentSettings.MaxDrawDistance);
+    FQualityProfile Profile;
+    AddLODSettings(CurrentSettings.LODBias, CurrentSettings.MaxDrawDistance, Profile);
+    ProfileApplier.Apply(Profile);
 }
 
 void UMobileOptimizationManager::OptimizeStaticMeshes()
@@ -604,16 +1027,40 @@ void UMobileOptimizationManager::OptimizeStaticMeshes()
 
 void UMobileOptimizationManager::OptimizeMaterials()
 {
-    // This would optimize material complexity for mobile
-    // Implementation would work with the AnimeMaterialManager
+    // Material managers swap to the cheaper shader permutations of the tier; repeating a tier is a no-op
+    for (TObjectIterator<UAnimeMaterialManager> It; It; ++It)
+    {
+        if (It->GetWorld() == GetWorld())
+        {
+            It->SetQualityLevel((int32)CurrentSettings.QualityLevel);
+        }
+    }
 }
 
 void UMobileOptimizationManager::OptimizeParticleSystems()
 {
-    if (GEngine)
+    // Reduce particle counts for mobile
+    FQualityProfile Profile;
+    Profile.Set(TEXT("fx.MaxGPUParticlesSpawnedPerFrame"), 64);
+    Profile.Set(TEXT("fx.MaxCPUParticlesPerEmitter"), 100);
+    ProfileApplier.Apply(Profile, TEXT("ParticleSystems"));
+}
+
+namespace MobileOptimizationCommands
+{
+    static void WriteSoakReports(const TArray<FString>& Args, UWorld* World)
     {
-        // Reduce particle counts for mobile
-        GEngine->Exec(GetWorld(), TEXT("fx.MaxGPUParticlesSpawnedPerFrame 64"));
-        GEngine->Exec(GetWorld(), TEXT("fx.MaxCPUParticlesPerEmitter 100"));
+        for (TObjectIterator<UMobileOptimizationManager> It; It; ++It)
+        {
+            if (It->GetWorld() == World)
+            {
+                It->WriteMemorySoakReport();
+            }
+        }
     }
+    
+    static FAutoConsoleCommandWithWorldAndArgs SoakReportCommand(
+        TEXT("AWR.Memory.SoakReport"),
+        TEXT("Writes the per-subsystem memory history to Saved/Profiling/MemorySoak. Runs automatically at the end of a session started with -AWRMemorySoak."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&WriteSoakReports));
 }
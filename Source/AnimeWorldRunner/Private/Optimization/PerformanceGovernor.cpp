@@ -0,0 +1,236 @@
+#include "Optimization/PerformanceGovernor.h"
+#include "Optimization/FrameTimeStats.h"
+#include "Optimization/FrameTimeTrace.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+namespace PerformanceGovernorBudgets
+{
+    // Level 0 is the full budget; each further entry is one downshift step
+    static const float MaterialUpdateRates[] = { 0.0f, 30.0f, 15.0f, 10.0f };
+    static const float UIAnimationRates[] = { 0.0f, 30.0f, 15.0f };
+    static const int32 MaxConcurrentEffects[] = { 16, 10, 6, 3 };
+    static const float EffectScales[] = { 1.0f, 0.85f, 0.7f, 0.5f };
+    static const float EnvironmentInstanceScales[] = { 1.0f, 0.8f, 0.6f, 0.45f };
+
+    static int32 GetNumLevels(EGovernedBudget Budget)
+    {
+        switch (Budget)
+        {
+            case EGovernedBudget::MaterialUpdateRate:
+                return UE_ARRAY_COUNT(MaterialUpdateRates);
+            case EGovernedBudget::UIAnimationRate:
+                return UE_ARRAY_COUNT(UIAnimationRates);
+            case EGovernedBudget::ConcurrentEffects:
+                return UE_ARRAY_COUNT(MaxConcurrentEffects);
+            case EGovernedBudget::EnvironmentInstances:
+                return UE_ARRAY_COUNT(EnvironmentInstanceScales);
+            default:
+                return 1;
+        }
+    }
+}
+
+FPerformanceGovernor::FPerformanceGovernor()
+{
+    BuildLadder();
+    Reset();
+}
+
+void FPerformanceGovernor::Configure(const FPerformanceGovernorSettings& InSettings)
+{
+    Settings = InSettings;
+    Settings.TargetFrameTimeMs = FMath::Max(Settings.TargetFrameTimeMs, 1.0f);
+}
+
+void FPerformanceGovernor::Reset()
+{
+    Level = 0;
+    for (int32 i = 0; i < (int32)EGovernedBudget::Count; i++)
+    {
+        BudgetLevels[i] = 0;
+    }
+
+    OverBudgetTime = 0.0f;
+    UnderBudgetTime = 0.0f;
+    CooldownRemaining = 0.0f;
+    bMemoryPressure = false;
+
+    UpdateBudgets();
+}
+
+void FPerformanceGovernor::BuildLadder()
+{
+    int32 MaxLevels = 0;
+    for (int32 i = 0; i < (int32)EGovernedBudget::Count; i++)
+    {
+        MaxLevels = FMath::Max(MaxLevels, PerformanceGovernorBudgets::GetNumLevels((EGovernedBudget)i));
+    }
+
+    Ladder.Reset();
+    for (int32 Pass = 1; Pass < MaxLevels; Pass++)
+    {
+        for (int32 i = 0; i < (int32)EGovernedBudget::Count; i++)
+        {
+            if (Pass < PerformanceGovernorBudgets::GetNumLevels((EGovernedBudget)i))
+            {
+                Ladder.Add((EGovernedBudget)i);
+            }
+        }
+    }
+}
+
+bool FPerformanceGovernor::Update(float P95FrameTimeMs, float DeltaSeconds)
+{
+    if (P95FrameTimeMs <= 0.0f || DeltaSeconds <= 0.0f)
+    {
+        return false;
+    }
+
+    CooldownRemaining = FMath::Max(CooldownRemaining - DeltaSeconds, 0.0f);
+
+    const bool bOverBudget = bMemoryPressure || P95FrameTimeMs > Settings.TargetFrameTimeMs * Settings.DownshiftRatio;
+    const bool bUnderBudget = !bMemoryPressure && P95FrameTimeMs < Settings.TargetFrameTimeMs * Settings.UpshiftRatio;
+
+    OverBudgetTime = bOverBudget ? OverBudgetTime + DeltaSeconds : 0.0f;
+    UnderBudgetTime = bUnderBudget ? UnderBudgetTime + DeltaSeconds : 0.0f;
+
+    if (CooldownRemaining > 0.0f)
+    {
+        return false;
+    }
+
+    if (OverBudgetTime >= Settings.DownshiftHoldSeconds && Level < Ladder.Num())
+    {
+        const EGovernedBudget Budget = Ladder[Level++];
+        BudgetLevels[(int32)Budget]++;
+        LogDecision(TEXT("downshift"), Budget, P95FrameTimeMs);
+    }
+    else if (UnderBudgetTime >= Settings.UpshiftHoldSeconds && Level > 0)
+    {
+        const EGovernedBudget Budget = Ladder[--Level];
+        BudgetLevels[(int32)Budget]--;
+        LogDecision(TEXT("upshift"), Budget, P95FrameTimeMs);
+    }
+    else
+    {
+        return false;
+    }
+
+    OverBudgetTime = 0.0f;
+    UnderBudgetTime = 0.0f;
+    CooldownRemaining = Settings.CooldownSeconds;
+
+    UpdateBudgets();
+    return true;
+}
+
+void FPerformanceGovernor::UpdateBudgets()
+{
+    using namespace PerformanceGovernorBudgets;
+
+    Budgets.MaterialUpdateRate = MaterialUpdateRates[BudgetLevels[(int32)EGovernedBudget::MaterialUpdateRate]];
+    Budgets.UIAnimationRate = UIAnimationRates[BudgetLevels[(int32)EGovernedBudget::UIAnimationRate]];
+    Budgets.MaxConcurrentEffects = MaxConcurrentEffects[BudgetLevels[(int32)EGovernedBudget::ConcurrentEffects]];
+    Budgets.EffectScale = EffectScales[BudgetLevels[(int32)EGovernedBudget::ConcurrentEffects]];
+    Budgets.EnvironmentInstanceScale = EnvironmentInstanceScales[BudgetLevels[(int32)EGovernedBudget::EnvironmentInstances]];
+}
+
+const TCHAR* FPerformanceGovernor::GetBudgetName(EGovernedBudget Budget)
+{
+    switch (Budget)
+    {
+        case EGovernedBudget::MaterialUpdateRate:
+            return TEXT("MaterialUpdateRate");
+        case EGovernedBudget::UIAnimationRate:
+            return TEXT("UIAnimationRate");
+        case EGovernedBudget::ConcurrentEffects:
+            return TEXT("ConcurrentEffects");
+        case EGovernedBudget::EnvironmentInstances:
+            return TEXT("EnvironmentInstances");
+        default:
+            return TEXT("Unknown");
+    }
+}
+
+void FPerformanceGovernor::LogDecision(const TCHAR* Direction, EGovernedBudget Budget, float P95FrameTimeMs) const
+{
+    UE_LOG(LogTemp, Log, TEXT("Performance governor: %s %s to level %d (p95 %.2f ms, target %.2f ms, step %d of %d%s)"),
+        Direction, GetBudgetName(Budget), BudgetLevels[(int32)Budget], P95FrameTimeMs, Settings.TargetFrameTimeMs, Level, Ladder.Num(),
+        bMemoryPressure ? TEXT(", memory over budget") : TEXT(""));
+}
+
+FPerformanceGovernorSimulationReport FPerformanceGovernor::Simulate(const FPerformanceGovernorSettings& InSettings, const TArray<float>& FrameTimesMs, float StepCostFraction)
+{
+    FPerformanceGovernorSimulationReport Report;
+
+    FPerformanceGovernor Governor;
+    Governor.Configure(InSettings);
+
+    FFrameTimeStats Stats;
+    int32 OverBudgetFrames = 0;
+    float Time = 0.0f;
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameTimesMs.Num(); FrameIndex++)
+    {
+        const float FrameTime = FrameTimesMs[FrameIndex] * FMath::Max(1.0f - StepCostFraction * Governor.GetLevel(), 0.1f);
+        Time += FrameTime * 0.001f;
+
+        Stats.AddSample(FrameTime);
+        if (FrameTime > InSettings.TargetFrameTimeMs)
+        {
+            OverBudgetFrames++;
+        }
+
+        const int32 PreviousLevel = Governor.GetLevel();
+        if (Governor.Update(Stats.GetPercentile(0.95f), FrameTime * 0.001f))
+        {
+            if (Governor.GetLevel() > PreviousLevel)
+            {
+                Report.Downshifts++;
+            }
+            else
+            {
+                Report.Upshifts++;
+            }
+            Report.MaxLevel = FMath::Max(Report.MaxLevel, Governor.GetLevel());
+        }
+    }
+
+    Report.NumFrames = FrameTimesMs.Num();
+    Report.DurationSeconds = Time;
+    Report.FinalLevel = Governor.GetLevel();
+    Report.OverBudgetPercent = Report.NumFrames > 0 ? 100.0f * OverBudgetFrames / Report.NumFrames : 0.0f;
+
+    return Report;
+}
+
+namespace PerformanceGovernorSimulation
+{
+    static void LogReport(const TCHAR* TraceName, const FPerformanceGovernorSimulationReport& Report)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Governor [%s]: %d frames / %.1fs, %d downshifts, %d upshifts, level %d (max %d), %.1f%% frames over budget"),
+            TraceName, Report.NumFrames, Report.DurationSeconds, Report.Downshifts, Report.Upshifts,
+            Report.FinalLevel, Report.MaxLevel, Report.OverBudgetPercent);
+    }
+
+    static void RunSimulation(const TArray<FString>& Args)
+    {
+        if (Args.Num() == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Governor: usage AWR.Governor.Simulate <trace file>"));
+            return;
+        }
+
+        TArray<float> Trace;
+        if (FFrameTimeTrace::LoadFromFile(Args[0], Trace))
+        {
+            LogReport(*FPaths::GetCleanFilename(Args[0]), FPerformanceGovernor::Simulate(FPerformanceGovernorSettings(), Trace));
+        }
+    }
+
+    static FAutoConsoleCommand SimulateCommand(
+        TEXT("AWR.Governor.Simulate"),
+        TEXT("Runs the performance governor against a recorded frame time trace (relative to Saved/) and logs every budget decision."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunSimulation));
+}
@@ -0,0 +1,162 @@
+#include "Optimization/PerformanceMetricsProvider.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "RHI.h"
+#include "DynamicRHI.h"
+#include "RenderCore.h"
+#include "UObject/UObjectIterator.h"
+
+IPerformanceMetricsProvider& IPerformanceMetricsProvider::Get()
+{
+    if (const TSharedPtr<IPerformanceMetricsProvider>& Override = AccessOverride())
+    {
+        return *Override;
+    }
+
+    static FRHIMetricsProvider RHIProvider;
+    static FFallbackMetricsProvider FallbackProvider;
+
+    // Nothing reaches the RHI counters with a null RHI (servers, automation, -nullrhi soak runs)
+    if (GUsingNullRHI)
+    {
+        return FallbackProvider;
+    }
+
+    return RHIProvider;
+}
+
+void IPerformanceMetricsProvider::SetOverride(const TSharedPtr<IPerformanceMetricsProvider>& Provider)
+{
+    AccessOverride() = Provider;
+}
+
+TSharedPtr<IPerformanceMetricsProvider>& IPerformanceMetricsProvider::AccessOverride()
+{
+    static TSharedPtr<IPerformanceMetricsProvider> Override;
+    return Override;
+}
+
+const FRenderMetricsSample& IPerformanceMetricsProvider::GetFrameSample(const UWorld* World)
+{
+    static FRenderMetricsSample CachedSample;
+    static uint64 CachedFrame = MAX_uint64;
+    static const UWorld* CachedWorld = nullptr;
+
+    if (CachedFrame != GFrameCounter || CachedWorld != World)
+    {
+        CachedFrame = GFrameCounter;
+        CachedWorld = World;
+        Get().Sample(World, CachedSample);
+    }
+
+    return CachedSample;
+}
+
+void FRHIMetricsProvider::Sample(const UWorld* World, FRenderMetricsSample& OutSample)
+{
+    // The G* counters hold the previous completed frame
+    OutSample.DrawCalls = GNumDrawCallsRHI[0];
+    OutSample.PrimitivesDrawn = GNumPrimitivesDrawnRHI[0];
+    OutSample.GPUTimeMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles(0));
+    OutSample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    OutSample.RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+    OutSample.Source = EPerformanceMetricsSource::RHI;
+}
+
+void FFallbackMetricsProvider::Sample(const UWorld* World, FRenderMetricsSample& OutSample)
+{
+    int32 VisibleComponents = 0;
+    int64 Triangles = 0;
+
+    for (TObjectIterator<UPrimitiveComponent> It; World && It; ++It)
+    {
+        const UPrimitiveComponent* Component = *It;
+        if (Component->GetWorld() != World || !Component->IsRegistered() || !Component->IsVisible())
+        {
+            continue;
+        }
+
+        // Each visible component is roughly one draw per material section; count it once
+        VisibleComponents++;
+
+        if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+        {
+            const UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+            if (Mesh && Mesh->GetRenderData())
+            {
+                const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component);
+                const int32 Instances = InstancedComponent ? InstancedComponent->GetInstanceCount() : 1;
+                Triangles += (int64)Mesh->GetNumTriangles(0) * Instances;
+            }
+        }
+    }
+
+    OutSample.DrawCalls = VisibleComponents;
+    OutSample.PrimitivesDrawn = (int32)FMath::Min<int64>(Triangles, MAX_int32);
+    OutSample.GPUTimeMs = 0.0f;
+    OutSample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    OutSample.RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+    OutSample.Source = EPerformanceMetricsSource::Fallback;
+}
+
+FMockMetricsProvider::FMockMetricsProvider()
+{
+    NextSample = 0;
+    NumSampled = 0;
+}
+
+void FMockMetricsProvider::SetSample(const FRenderMetricsSample& InSample)
+{
+    Reset();
+    AddSample(InSample);
+}
+
+void FMockMetricsProvider::AddSample(const FRenderMetricsSample& InSample)
+{
+    Samples.Add(InSample);
+    Samples.Last().Source = EPerformanceMetricsSource::Mock;
+}
+
+void FMockMetricsProvider::Reset()
+{
+    Samples.Reset();
+    NextSample = 0;
+    NumSampled = 0;
+}
+
+void FMockMetricsProvider::Sample(const UWorld* World, FRenderMetricsSample& OutSample)
+{
+    NumSampled++;
+
+    if (Samples.Num() == 0)
+    {
+        OutSample = FRenderMetricsSample();
+        OutSample.Source = EPerformanceMetricsSource::Mock;
+        return;
+    }
+
+    OutSample = Samples[NextSample];
+    NextSample = (NextSample + 1) % Samples.Num();
+}
+
+namespace PerformanceMetricsCommands
+{
+    static void DumpMetrics(const TArray<FString>& Args, UWorld* World)
+    {
+        IPerformanceMetricsProvider& Provider = IPerformanceMetricsProvider::Get();
+
+        FRenderMetricsSample Sample;
+        Provider.Sample(World, Sample);
+
+        UE_LOG(LogTemp, Log, TEXT("Metrics [%s]: %d draw calls, %d primitives, GPU %.2f ms, game thread %.2f ms, render thread %.2f ms"),
+            Provider.GetName(), Sample.DrawCalls, Sample.PrimitivesDrawn, Sample.GPUTimeMs, Sample.GameThreadMs, Sample.RenderThreadMs);
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs DumpCommand(
+        TEXT("AWR.Metrics.Dump"),
+        TEXT("Logs one sample from the active performance metrics provider."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpMetrics));
+}
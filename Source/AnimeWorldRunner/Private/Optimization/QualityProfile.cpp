@@ -0,0 +1,92 @@
+#include "Optimization/QualityProfile.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+void FQualityProfile::Set(const TCHAR* Name, float Value)
+{
+    Values.Add(FName(Name), Value);
+}
+
+IConsoleVariable* FQualityProfileApplier::FindHandle(FName Name)
+{
+    if (IConsoleVariable** Cached = Handles.Find(Name))
+    {
+        return *Cached;
+    }
+
+    IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*Name.ToString());
+    if (!Variable)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("Console variable %s does not exist on this platform"), *Name.ToString());
+    }
+
+    Handles.Add(Name, Variable);
+    return Variable;
+}
+
+bool FQualityProfileApplier::NeedsUpdate(IConsoleVariable* Variable, float Value)
+{
+    if (Variable->IsVariableInt() || Variable->IsVariableBool())
+    {
+        return Variable->GetInt() != FMath::RoundToInt(Value);
+    }
+
+    return !FMath::IsNearlyEqual(Variable->GetFloat(), Value, KINDA_SMALL_NUMBER);
+}
+
+void FQualityProfileApplier::Write(IConsoleVariable* Variable, float Value)
+{
+    if (Variable->IsVariableInt() || Variable->IsVariableBool())
+    {
+        Variable->Set(FMath::RoundToInt(Value), ECVF_SetByCode);
+    }
+    else
+    {
+        Variable->Set(Value, ECVF_SetByCode);
+    }
+}
+
+int32 FQualityProfileApplier::Apply(const FQualityProfile& Profile, const TCHAR* Reason)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Diff against the live values first, then write the changes in one batch
+    PendingWrites.Reset(Profile.Num());
+    for (const TPair<FName, float>& Entry : Profile.Values)
+    {
+        IConsoleVariable* Variable = FindHandle(Entry.Key);
+        if (Variable && NeedsUpdate(Variable, Entry.Value))
+        {
+            PendingWrites.Emplace(Variable, Entry.Value);
+        }
+    }
+
+    for (const TPair<IConsoleVariable*, float>& PendingWrite : PendingWrites)
+    {
+        Write(PendingWrite.Key, PendingWrite.Value);
+    }
+
+    const int32 NumChanged = PendingWrites.Num();
+    TotalWrites += NumChanged;
+
+    if (Reason)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Quality profile '%s': %d of %d console variables changed in %.3f ms"),
+            Reason, NumChanged, Profile.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    }
+
+    return NumChanged;
+}
+
+bool FQualityProfileApplier::ApplySingle(const TCHAR* Name, float Value)
+{
+    IConsoleVariable* Variable = FindHandle(FName(Name));
+    if (!Variable || !NeedsUpdate(Variable, Value))
+    {
+        return false;
+    }
+
+    Write(Variable, Value);
+    TotalWrites++;
+    return true;
+}
@@ -0,0 +1,241 @@
+#include "Optimization/SubsystemMemoryTracker.h"
+#include "Environment/ModularEnvironmentSystem.h"
+#include "Effects/AnimeEffectsManager.h"
+#include "Materials/AnimeMaterialManager.h"
+#include "UI/AnimeUIManager.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/UObjectIterator.h"
+#include "Misc/FileHelper.h"
+
+LLM_DEFINE_TAG(AWR, TEXT("AWR"));
+LLM_DEFINE_TAG(AWR_Environment, TEXT("Environment"), TEXT("AWR"));
+LLM_DEFINE_TAG(AWR_ChunkData, TEXT("ChunkData"), TEXT("AWR"));
+LLM_DEFINE_TAG(AWR_Effects, TEXT("Effects"), TEXT("AWR"));
+LLM_DEFINE_TAG(AWR_Materials, TEXT("Materials"), TEXT("AWR"));
+LLM_DEFINE_TAG(AWR_UI, TEXT("UI"), TEXT("AWR"));
+
+float FSubsystemMemoryBudgets::GetBudgetMB(EMemoryBudgetCategory Category) const
+{
+    switch (Category)
+    {
+        case EMemoryBudgetCategory::Environment:
+            return EnvironmentMB;
+        case EMemoryBudgetCategory::ChunkData:
+            return ChunkDataMB;
+        case EMemoryBudgetCategory::Effects:
+            return EffectsMB;
+        case EMemoryBudgetCategory::Materials:
+            return MaterialsMB;
+        case EMemoryBudgetCategory::UI:
+            return UIMB;
+        default:
+            return 0.0f;
+    }
+}
+
+FSubsystemMemoryTracker::FSubsystemMemoryTracker()
+{
+    OverBudgetMask = 0;
+    bUsingLLM = false;
+    NextSample = 0;
+}
+
+void FSubsystemMemoryTracker::Sample(const UWorld* World, double TimeSeconds)
+{
+    FMemorySample NewSample;
+    NewSample.TimeSeconds = TimeSeconds;
+    FMemory::Memzero(NewSample.Bytes, sizeof(NewSample.Bytes));
+
+    bUsingLLM = SampleLLM(NewSample);
+    if (!bUsingLLM)
+    {
+        SampleSubsystems(World, NewSample);
+    }
+
+    if (History.Num() < MaxHistory)
+    {
+        History.Add(NewSample);
+    }
+    else
+    {
+        History[NextSample] = NewSample;
+    }
+    NextSample = (NextSample + 1) % MaxHistory;
+}
+
+const FSubsystemMemoryTracker::FMemorySample& FSubsystemMemoryTracker::GetSample(int32 Age) const
+{
+    // Age 0 is the latest sample
+    const int32 Index = (NextSample - 1 - Age) % History.Num();
+    return History[Index < 0 ? Index + History.Num() : Index];
+}
+
+bool FSubsystemMemoryTracker::SampleLLM(FMemorySample& OutSample)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+    if (!Tracker.IsEnabled())
+    {
+        return false;
+    }
+
+    const FName TagNames[] =
+    {
+        LLM_TAG_NAME(AWR_Environment),
+        LLM_TAG_NAME(AWR_ChunkData),
+        LLM_TAG_NAME(AWR_Effects),
+        LLM_TAG_NAME(AWR_Materials),
+        LLM_TAG_NAME(AWR_UI)
+    };
+    static_assert(UE_ARRAY_COUNT(TagNames) == (int32)EMemoryBudgetCategory::Count, "One LLM tag per memory category");
+
+    for (int32 i = 0; i < (int32)EMemoryBudgetCategory::Count; i++)
+    {
+        OutSample.Bytes[i] = Tracker.GetTagAmountForTracker(ELLMTracker::Default, TagNames[i], ELLMTagSet::None, UE::LLM::ESizeParams::ReportCurrent);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FSubsystemMemoryTracker::SampleSubsystems(const UWorld* World, FMemorySample& OutSample)
+{
+    if (!World)
+    {
+        return;
+    }
+
+    for (TActorIterator<AModularEnvironmentSystem> It(const_cast<UWorld*>(World)); It; ++It)
+    {
+        OutSample.Bytes[(int32)EMemoryBudgetCategory::Environment] += It->GetInstanceMemoryBytes();
+        OutSample.Bytes[(int32)EMemoryBudgetCategory::ChunkData] += It->GetChunkDataMemoryBytes();
+    }
+
+    for (TObjectIterator<UAnimeEffectsManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            OutSample.Bytes[(int32)EMemoryBudgetCategory::Effects] += It->GetEffectMemoryBytes();
+        }
+    }
+
+    for (TObjectIterator<UAnimeMaterialManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            OutSample.Bytes[(int32)EMemoryBudgetCategory::Materials] += It->GetMaterialMemoryBytes();
+        }
+    }
+
+    for (TObjectIterator<UAnimeUIManager> It; It; ++It)
+    {
+        if (It->GetWorld() == World)
+        {
+            OutSample.Bytes[(int32)EMemoryBudgetCategory::UI] += It->GetWidgetMemoryBytes();
+        }
+    }
+}
+
+bool FSubsystemMemoryTracker::CheckBudgets(const FSubsystemMemoryBudgets& Budgets)
+{
+    if (History.Num() == 0)
+    {
+        return false;
+    }
+
+    const FMemorySample& Latest = GetSample(0);
+    for (int32 i = 0; i < (int32)EMemoryBudgetCategory::Count; i++)
+    {
+        const EMemoryBudgetCategory Category = (EMemoryBudgetCategory)i;
+        const float BudgetMB = Budgets.GetBudgetMB(Category);
+        const float UsedMB = Latest.Bytes[i] / (1024.0f * 1024.0f);
+        const bool bOver = BudgetMB > 0.0f && UsedMB > BudgetMB;
+        const bool bWasOver = (OverBudgetMask & (1u << i)) != 0;
+
+        if (bOver != bWasOver)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Memory budget: %s %s (%.1f MB of %.1f MB)"),
+                GetCategoryName(Category), bOver ? TEXT("over budget") : TEXT("back within budget"), UsedMB, BudgetMB);
+        }
+
+        if (bOver)
+        {
+            OverBudgetMask |= (1u << i);
+        }
+        else
+        {
+            OverBudgetMask &= ~(1u << i);
+        }
+    }
+
+    return OverBudgetMask != 0;
+}
+
+int64 FSubsystemMemoryTracker::GetBytes(EMemoryBudgetCategory Category) const
+{
+    if (History.Num() == 0 || Category >= EMemoryBudgetCategory::Count)
+    {
+        return 0;
+    }
+    return GetSample(0).Bytes[(int32)Category];
+}
+
+bool FSubsystemMemoryTracker::IsOverBudget(EMemoryBudgetCategory Category) const
+{
+    return Category < EMemoryBudgetCategory::Count && (OverBudgetMask & (1u << (int32)Category)) != 0;
+}
+
+bool FSubsystemMemoryTracker::WriteSoakReport(const FString& FilePath, const FSubsystemMemoryBudgets& Budgets) const
+{
+    FString Csv = TEXT("TimeSeconds");
+    for (int32 i = 0; i < (int32)EMemoryBudgetCategory::Count; i++)
+    {
+        Csv += FString::Printf(TEXT(",%sMB"), GetCategoryName((EMemoryBudgetCategory)i));
+    }
+    Csv += TEXT("\n");
+
+    // Oldest first
+    for (int32 Age = History.Num() - 1; Age >= 0; Age--)
+    {
+        const FMemorySample& MemorySample = GetSample(Age);
+        Csv += FString::Printf(TEXT("%.1f"), MemorySample.TimeSeconds);
+        for (int32 i = 0; i < (int32)EMemoryBudgetCategory::Count; i++)
+        {
+            Csv += FString::Printf(TEXT(",%.3f"), MemorySample.Bytes[i] / (1024.0 * 1024.0));
+        }
+        Csv += TEXT("\n");
+    }
+
+    // Budgets as the last row so a plot can draw them as limits
+    Csv += TEXT("Budget");
+    for (int32 i = 0; i < (int32)EMemoryBudgetCategory::Count; i++)
+    {
+        Csv += FString::Printf(TEXT(",%.3f"), Budgets.GetBudgetMB((EMemoryBudgetCategory)i));
+    }
+    Csv += TEXT("\n");
+
+    UE_LOG(LogTemp, Log, TEXT("Memory soak report: %d samples (%s), writing %s"), History.Num(), bUsingLLM ? TEXT("LLM") : TEXT("subsystem accounting"), *FilePath);
+
+    return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
+
+const TCHAR* FSubsystemMemoryTracker::GetCategoryName(EMemoryBudgetCategory Category)
+{
+    switch (Category)
+    {
+        case EMemoryBudgetCategory::Environment:
+            return TEXT("Environment");
+        case EMemoryBudgetCategory::ChunkData:
+            return TEXT("ChunkData");
+        case EMemoryBudgetCategory::Effects:
+            return TEXT("Effects");
+        case EMemoryBudgetCategory::Materials:
+            return TEXT("Materials");
+        case EMemoryBudgetCategory::UI:
+            return TEXT("UI");
+        default:
+            return TEXT("Unknown");
+    }
+}
@@ -0,0 +1,325 @@
+#include "Optimization/TelemetryRecorder.h"
+#include "Optimization/DeviceCalibration.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Containers/StringConv.h"
+
+namespace TelemetrySettings
+{
+    static TAutoConsoleVariable<int32> CVarEnable(
+        TEXT("AWR.Telemetry.Enable"),
+        1,
+        TEXT("Writes one row of performance telemetry per second to Saved/Telemetry."));
+
+    static TAutoConsoleVariable<int32> CVarMaxFiles(
+        TEXT("AWR.Telemetry.MaxFiles"),
+        20,
+        TEXT("Telemetry logs kept in Saved/Telemetry; the oldest are deleted when a session starts."));
+
+    static TAutoConsoleVariable<int32> CVarMaxFileKB(
+        TEXT("AWR.Telemetry.MaxFileKB"),
+        1024,
+        TEXT("Size at which a telemetry log is continued in a new file."));
+
+    static const TCHAR* FilePrefix = TEXT("Telemetry_");
+
+    static const TCHAR* ColumnHeader = TEXT("TimeSeconds,TargetFrameMs,AverageFrameMs,P50FrameMs,P95FrameMs,P99FrameMs,MaxFrameMs,ResolutionScale,QualityLevel,GovernorLevel,DrawCalls,ISMInstances,ActiveEffects,MemoryMB,RunDistance,ActiveMIDs,MaterialUsers\n");
+}
+
+FTelemetryRecorder::FTelemetryRecorder()
+    : WriterPipe(TEXT("TelemetryWriter"))
+{
+    bRecording = false;
+    FileBytes = 0;
+    FilePart = 0;
+}
+
+FTelemetryRecorder::~FTelemetryRecorder()
+{
+    EndSession();
+}
+
+FString FTelemetryRecorder::GetTelemetryDir()
+{
+    return FPaths::ProjectSavedDir() / TEXT("Telemetry");
+}
+
+bool FTelemetryRecorder::IsEnabled()
+{
+    return TelemetrySettings::CVarEnable.GetValueOnGameThread() != 0;
+}
+
+void FTelemetryRecorder::BeginSession(const FString& InDeviceName)
+{
+    EndSession();
+
+    bRecording = true;
+    PendingRows.Reset(FlushRowCount);
+
+    const FString NewSessionName = FDateTime::Now().ToString();
+    LastWrite = WriterPipe.Launch(TEXT("TelemetryBeginSession"), [this, InDeviceName, NewSessionName]()
+    {
+        DeviceName = InDeviceName;
+        SessionName = NewSessionName;
+        FilePart = 0;
+        FilePath.Reset();
+
+        PruneOldFiles();
+    });
+}
+
+void FTelemetryRecorder::AddRow(const FTelemetryRow& Row)
+{
+    if (!bRecording)
+    {
+        return;
+    }
+
+    PendingRows.Add(Row);
+    if (PendingRows.Num() >= FlushRowCount)
+    {
+        Flush();
+    }
+}
+
+void FTelemetryRecorder::Flush()
+{
+    if (PendingRows.Num() == 0)
+    {
+        return;
+    }
+
+    LastWrite = WriterPipe.Launch(TEXT("TelemetryWrite"), [this, Rows = MoveTemp(PendingRows)]()
+    {
+        WriteRows(Rows);
+    });
+    PendingRows.Reset(FlushRowCount);
+}
+
+void FTelemetryRecorder::EndSession()
+{
+    if (!bRecording)
+    {
+        return;
+    }
+
+    Flush();
+    bRecording = false;
+
+    // The pipe lambdas capture this, so they must finish before the recorder goes away
+    LastWrite.Wait();
+}
+
+void FTelemetryRecorder::WriteRows(const TArray<FTelemetryRow>& Rows)
+{
+    const int64 MaxFileBytes = (int64)FMath::Max(TelemetrySettings::CVarMaxFileKB.GetValueOnAnyThread(), 16) * 1024;
+    if (FilePath.IsEmpty() || FileBytes >= MaxFileBytes)
+    {
+        FilePath = OpenFile();
+    }
+
+    FString Csv;
+    Csv.Reserve(Rows.Num() * 128);
+    for (const FTelemetryRow& Row : Rows)
+    {
+        Csv += FString::Printf(TEXT("%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%d,%d,%.1f,%.1f,%d,%d\n"),
+            Row.TimeSeconds, Row.TargetFrameMs, Row.AverageFrameMs, Row.P50FrameMs, Row.P95FrameMs, Row.P99FrameMs, Row.MaxFrameMs,
+            Row.ResolutionScale, Row.QualityLevel, Row.GovernorLevel, Row.DrawCalls, Row.ISMInstances, Row.ActiveEffects,
+            Row.MemoryMB, Row.RunDistance, Row.ActiveMIDs, Row.MaterialUsers);
+    }
+
+    // Converted here so rotation counts the bytes actually written
+    const FTCHARToUTF8 Utf8Csv(*Csv);
+    FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(reinterpret_cast<const uint8*>(Utf8Csv.Get()), Utf8Csv.Length()), *FilePath, &IFileManager::Get(), FILEWRITE_Append);
+    FileBytes += Utf8Csv.Length();
+}
+
+FString FTelemetryRecorder::OpenFile()
+{
+    const FString NewFilePath = GetTelemetryDir() /
+        FString::Printf(TEXT("%s%s_%02d.csv"), TelemetrySettings::FilePrefix, *SessionName, FilePart++);
+
+    // Each part carries the device line and header so it can be summarized on its own
+    const FString Header = FString::Printf(TEXT("# Device=%s,Session=%s,Version=%s\n%s"),
+        *DeviceName, *SessionName, *FDeviceCalibration::GetCurrentAppVersion(), TelemetrySettings::ColumnHeader);
+
+    const FTCHARToUTF8 Utf8Header(*Header);
+    FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(reinterpret_cast<const uint8*>(Utf8Header.Get()), Utf8Header.Length()), *NewFilePath);
+    FileBytes = Utf8Header.Length();
+
+    return NewFilePath;
+}
+
+void FTelemetryRecorder::PruneOldFiles()
+{
+    const FString Directory = GetTelemetryDir();
+
+    TArray<FString> FileNames;
+    IFileManager::Get().FindFiles(FileNames, *(Directory / FString(TelemetrySettings::FilePrefix) + TEXT("*.csv")), true, false);
+
+    const int32 MaxFiles = FMath::Max(TelemetrySettings::CVarMaxFiles.GetValueOnAnyThread(), 1);
+    if (FileNames.Num() < MaxFiles)
+    {
+        return;
+    }
+
+    // Session names are timestamps, so name order is age order
+    FileNames.Sort();
+    for (int32 i = 0; i <= FileNames.Num() - MaxFiles; i++)
+    {
+        IFileManager::Get().Delete(*(Directory / FileNames[i]));
+    }
+}
+
+namespace TelemetrySummary
+{
+    struct FDeviceSummary
+    {
+        TSet<FString> Sessions;
+        int32 Seconds = 0;
+        int32 SecondsOverBudget = 0;
+        double SumP50 = 0.0;
+        double SumP95 = 0.0;
+        double SumResolutionScale = 0.0;
+        float WorstP99 = 0.0f;
+        TArray<float> P95Values;
+        int32 MinQualityLevel = MAX_int32;
+        int32 MaxGovernorLevel = 0;
+        float PeakMemoryMB = 0.0f;
+        float LongestRun = 0.0f;
+    };
+
+    static FString ParseHeaderValue(const FString& HeaderLine, const TCHAR* Key)
+    {
+        TArray<FString> Pairs;
+        HeaderLine.RightChop(1).TrimStartAndEnd().ParseIntoArray(Pairs, TEXT(","));
+        for (const FString& Pair : Pairs)
+        {
+            FString PairKey;
+            FString PairValue;
+            if (Pair.Split(TEXT("="), &PairKey, &PairValue) && PairKey == Key)
+            {
+                return PairValue;
+            }
+        }
+        return FString();
+    }
+
+    static bool ReadLog(const FString& FilePath, TMap<FString, FDeviceSummary>& Summaries)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath) || Lines.Num() < 2 || !Lines[0].StartsWith(TEXT("#")))
+        {
+            return false;
+        }
+
+        const FString Device = ParseHeaderValue(Lines[0], TEXT("Device"));
+        FDeviceSummary& Summary = Summaries.FindOrAdd(Device.IsEmpty() ? TEXT("Unknown") : Device);
+        Summary.Sessions.Add(ParseHeaderValue(Lines[0], TEXT("Session")));
+
+        TArray<FString> Columns;
+        Lines[1].ParseIntoArray(Columns, TEXT(","));
+        const int32 TargetIndex = Columns.IndexOfByKey(TEXT("TargetFrameMs"));
+        const int32 P50Index = Columns.IndexOfByKey(TEXT("P50FrameMs"));
+        const int32 P95Index = Columns.IndexOfByKey(TEXT("P95FrameMs"));
+        const int32 P99Index = Columns.IndexOfByKey(TEXT("P99FrameMs"));
+        const int32 ScaleIndex = Columns.IndexOfByKey(TEXT("ResolutionScale"));
+        const int32 QualityIndex = Columns.IndexOfByKey(TEXT("QualityLevel"));
+        const int32 GovernorIndex = Columns.IndexOfByKey(TEXT("GovernorLevel"));
+        const int32 MemoryIndex = Columns.IndexOfByKey(TEXT("MemoryMB"));
+        const int32 DistanceIndex = Columns.IndexOfByKey(TEXT("RunDistance"));
+
+        TArray<FString> Values;
+        for (int32 LineIndex = 2; LineIndex < Lines.Num(); LineIndex++)
+        {
+            Lines[LineIndex].ParseIntoArray(Values, TEXT(","), false);
+            if (Values.Num() != Columns.Num())
+            {
+                continue;
+            }
+
+            auto GetValue = [&Values](int32 Index) { return Index != INDEX_NONE ? FCString::Atof(*Values[Index]) : 0.0f; };
+
+            const float P95 = GetValue(P95Index);
+            Summary.Seconds++;
+            Summary.SumP50 += GetValue(P50Index);
+            Summary.SumP95 += P95;
+            Summary.P95Values.Add(P95);
+            Summary.SumResolutionScale += GetValue(ScaleIndex);
+            Summary.WorstP99 = FMath::Max(Summary.WorstP99, GetValue(P99Index));
+            Summary.MinQualityLevel = FMath::Min(Summary.MinQualityLevel, (int32)GetValue(QualityIndex));
+            Summary.MaxGovernorLevel = FMath::Max(Summary.MaxGovernorLevel, (int32)GetValue(GovernorIndex));
+            Summary.PeakMemoryMB = FMath::Max(Summary.PeakMemoryMB, GetValue(MemoryIndex));
+            Summary.LongestRun = FMath::Max(Summary.LongestRun, GetValue(DistanceIndex));
+
+            if (P95 > GetValue(TargetIndex) && GetValue(TargetIndex) > 0.0f)
+            {
+                Summary.SecondsOverBudget++;
+            }
+        }
+
+        return true;
+    }
+}
+
+int32 FTelemetrySummarizer::SummarizeDirectory(const FString& Directory, const FString& OutputPath)
+{
+    using namespace TelemetrySummary;
+
+    TArray<FString> FileNames;
+    IFileManager::Get().FindFiles(FileNames, *(Directory / FString(TelemetrySettings::FilePrefix) + TEXT("*.csv")), true, false);
+
+    TMap<FString, FDeviceSummary> Summaries;
+    int32 LogsRead = 0;
+    for (const FString& FileName : FileNames)
+    {
+        if (ReadLog(Directory / FileName, Summaries))
+        {
+            LogsRead++;
+        }
+    }
+
+    FString Csv = TEXT("Device,Sessions,Seconds,MeanP50FrameMs,MeanP95FrameMs,P95OfP95FrameMs,WorstP99FrameMs,OverBudgetPercent,MeanResolutionScale,MinQualityLevel,MaxGovernorLevel,PeakMemoryMB,LongestRun\n");
+    for (TPair<FString, FDeviceSummary>& Pair : Summaries)
+    {
+        FDeviceSummary& Summary = Pair.Value;
+        if (Summary.Seconds == 0)
+        {
+            continue;
+        }
+
+        Summary.P95Values.Sort();
+        const float P95OfP95 = Summary.P95Values[FMath::Min(FMath::FloorToInt(Summary.P95Values.Num() * 0.95f), Summary.P95Values.Num() - 1)];
+
+        const FString Line = FString::Printf(TEXT("%s,%d,%d,%.2f,%.2f,%.2f,%.2f,%.1f,%.2f,%d,%d,%.1f,%.1f\n"),
+            *Pair.Key, Summary.Sessions.Num(), Summary.Seconds,
+            Summary.SumP50 / Summary.Seconds, Summary.SumP95 / Summary.Seconds, P95OfP95, Summary.WorstP99,
+            100.0f * Summary.SecondsOverBudget / Summary.Seconds, Summary.SumResolutionScale / Summary.Seconds,
+            Summary.MinQualityLevel, Summary.MaxGovernorLevel, Summary.PeakMemoryMB, Summary.LongestRun);
+
+        UE_LOG(LogTemp, Log, TEXT("Telemetry summary: %s"), *Line.TrimEnd());
+        Csv += Line;
+    }
+
+    FFileHelper::SaveStringToFile(Csv, *OutputPath);
+    UE_LOG(LogTemp, Log, TEXT("Telemetry summary of %d logs from %d devices written to %s"), LogsRead, Summaries.Num(), *OutputPath);
+
+    return LogsRead;
+}
+
+namespace TelemetryCommands
+{
+    static void Summarize(const TArray<FString>& Args)
+    {
+        const FString Directory = Args.Num() > 0 ? Args[0] : FTelemetryRecorder::GetTelemetryDir();
+        FTelemetrySummarizer::SummarizeDirectory(Directory, Directory / TEXT("Summary.csv"));
+    }
+
+    static FAutoConsoleCommand SummarizeCommand(
+        TEXT("AWR.Telemetry.Summarize"),
+        TEXT("Summarizes the telemetry logs in Saved/Telemetry (or the given directory) into Summary.csv, one row per device."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&Summarize));
+}
@@ -0,0 +1,21 @@
+#include "Optimization/TelemetrySummaryCommandlet.h"
+#include "Optimization/TelemetryRecorder.h"
+
+UTelemetrySummaryCommandlet::UTelemetrySummaryCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UTelemetrySummaryCommandlet::Main(const FString& Params)
+{
+    FString Directory = FTelemetryRecorder::GetTelemetryDir();
+    FParse::Value(*Params, TEXT("Dir="), Directory);
+
+    FString OutputPath = Directory / TEXT("Summary.csv");
+    FParse::Value(*Params, TEXT("Out="), OutputPath);
+
+    return FTelemetrySummarizer::SummarizeDirectory(Directory, OutputPath) > 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include "Effects/AnimeEffectsManager.h"
+#include "Tests/AnimeTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Particles/ParticleSystem.h"
+#include "NiagaraSystem.h"
+#include "HAL/IConsoleManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimeContinuousEffectTest, "AnimeWorldRunner.Effects.ContinuousEffect",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimeContinuousEffectTest::RunTest(const FString& Parameters)
+{
+    FAnimeTestWorld TestWorld;
+    UAnimeEffectsManager* EffectsManager = TestWorld.AddComponent<UAnimeEffectsManager>();
+    
+    // Running has no template by default, so switching it on must not mark it active
+    EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, true);
+    TestFalse(TEXT("Running without a template is not active"), EffectsManager->IsContinuousEffectActive(EAnimeEffectType::Running));
+    
+    // An empty transient template is enough to activate a component
+    FAnimeEffectData RunningEffect;
+    RunningEffect.Duration = -1.0f;
+    RunningEffect.ParticleEffect = NewObject<UParticleSystem>(GetTransientPackage());
+    EffectsManager->SetEffectData(EAnimeEffectType::Running, RunningEffect);
+    
+    // Ten seconds of per-tick calls at 60 fps
+    const int32 PlaysBefore = EffectsManager->GetNumAttachedPlays();
+    for (int32 Frame = 0; Frame < 600; Frame++)
+    {
+        EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, true);
+    }
+    
+    TestEqual(TEXT("Per-tick calls activate the effect once"), EffectsManager->GetNumAttachedPlays() - PlaysBefore, 1);
+    TestTrue(TEXT("Running is active"), EffectsManager->IsContinuousEffectActive(EAnimeEffectType::Running));
+    TestEqual(TEXT("One running instance"), EffectsManager->GetActiveInstanceCount(EAnimeEffectType::Running), 1);
+    
+    EffectsManager->SetContinuousEffect(EAnimeEffectType::Running, false);
+    TestFalse(TEXT("Running is off after switching it off"), EffectsManager->IsContinuousEffectActive(EAnimeEffectType::Running));
+    TestEqual(TEXT("No running instance"), EffectsManager->GetActiveInstanceCount(EAnimeEffectType::Running), 0);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimeBurstBatchTest, "AnimeWorldRunner.Effects.BurstBatch",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimeBurstBatchTest::RunTest(const FString& Parameters)
+{
+    IConsoleVariable* BatchBursts = IConsoleManager::Get().FindConsoleVariable(TEXT("AWR.Effects.BatchBursts"));
+    if (!TestNotNull(TEXT("Burst batching CVar exists"), BatchBursts))
+    {
+        return false;
+    }
+    const int32 PreviousBatchBursts = BatchBursts->GetInt();
+    BatchBursts->Set(1, ECVF_SetByConsole);
+    
+    FAnimeTestWorld TestWorld;
+    UAnimeEffectsManager* EffectsManager = TestWorld.AddComponent<UAnimeEffectsManager>();
+    
+    // A transient system stands in for the burst asset; the batching path only needs it resident
+    FAnimeEffectData CollectEffect;
+    CollectEffect.Duration = 1.0f;
+    CollectEffect.BurstEffect = NewObject<UNiagaraSystem>(GetTransientPackage());
+    EffectsManager->SetEffectData(EAnimeEffectType::Collect, CollectEffect);
+    EffectsManager->PrewarmEffectPools();
+    TestTrue(TEXT("Collect has a burst batch"), EffectsManager->HasBurstBatch(EAnimeEffectType::Collect));
+    
+    // More collect plays in one frame than the batch takes
+    const int32 MaxSpawns = EffectsManager->GetMaxBurstSpawnsPerFrame();
+    const int32 NumPlays = MaxSpawns + 10;
+    const int32 CreatedBefore = EffectsManager->GetNumComponentsCreated();
+    const int32 DroppedBefore = EffectsManager->GetNumBurstSpawnsDropped();
+    for (int32 i = 0; i < NumPlays; i++)
+    {
+        EffectsManager->PlayEffect(EAnimeEffectType::Collect, FVector(100.0f * i, 0.0f, 0.0f));
+    }
+    
+    TestEqual(TEXT("Collect plays create no components"), EffectsManager->GetNumComponentsCreated() - CreatedBefore, 0);
+    TestEqual(TEXT("Collect plays take no instances"), EffectsManager->GetActiveInstanceCount(EAnimeEffectType::Collect), 0);
+    TestEqual(TEXT("The batch takes spawns up to its limit"), EffectsManager->GetNumQueuedBurstSpawns(EAnimeEffectType::Collect), MaxSpawns);
+    TestEqual(TEXT("Spawns past the limit are dropped"), EffectsManager->GetNumBurstSpawnsDropped() - DroppedBefore, NumPlays - MaxSpawns);
+    
+    BatchBursts->Set(PreviousBatchBursts, ECVF_SetByConsole);
+    return true;
+}
+
+#endif
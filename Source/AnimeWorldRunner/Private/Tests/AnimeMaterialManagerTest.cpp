@@ -0,0 +1,179 @@
+#include "Materials/AnimeMaterialManager.h"
+#include "Tests/AnimeTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimeMaterialLeakTest, "AnimeWorldRunner.Materials.LeakCheck",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimeMaterialLeakTest::RunTest(const FString& Parameters)
+{
+    FAnimeTestWorld TestWorld;
+    UAnimeMaterialManager* MaterialManager = TestWorld.AddComponent<UAnimeMaterialManager>();
+    
+    const int32 BaselineActive = MaterialManager->GetActiveMaterialCount();
+    const int32 BaselineTracked = MaterialManager->GetTrackedMaterialCount();
+    const int32 BaselineShared = MaterialManager->GetSharedMaterialCount();
+    const int64 BaselineBytes = MaterialManager->GetRegistryMemoryBytes();
+    
+    // Half unique and dropped, half shared with distinct settings so every call creates a material
+    const int32 Count = 10000;
+    TArray<UMaterialInstanceDynamic*> SharedMaterials;
+    FAnimeMaterialSettings Settings;
+    Settings.BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+    for (int32 i = 0; i < Count; i++)
+    {
+        Settings.EmissionIntensity = static_cast<float>(i);
+        UMaterialInstanceDynamic* Material = MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings, i % 2 == 0);
+        if (i % 2 != 0)
+        {
+            SharedMaterials.Add(Material);
+        }
+    }
+    
+    TestEqual(TEXT("Every call creates a material"), MaterialManager->GetActiveMaterialCount() - BaselineActive, Count);
+    
+    // The manager holds shared materials until their last release; dropped unique ones go
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    MaterialManager->PruneMaterials(MAX_int32);
+    TestEqual(TEXT("Only shared materials survive garbage collection"), MaterialManager->GetActiveMaterialCount() - BaselineActive, SharedMaterials.Num());
+    TestEqual(TEXT("Shared materials stay cached"), MaterialManager->GetSharedMaterialCount() - BaselineShared, SharedMaterials.Num());
+    
+    for (UMaterialInstanceDynamic* Material : SharedMaterials)
+    {
+        MaterialManager->ReleaseMaterial(Material);
+    }
+    SharedMaterials.Empty();
+    
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    MaterialManager->PruneMaterials(MAX_int32);
+    
+    TestEqual(TEXT("Registered materials return to baseline"), MaterialManager->GetActiveMaterialCount(), BaselineActive);
+    TestEqual(TEXT("Tracked materials return to baseline"), MaterialManager->GetTrackedMaterialCount(), BaselineTracked);
+    TestEqual(TEXT("Shared materials return to baseline"), MaterialManager->GetSharedMaterialCount(), BaselineShared);
+    TestTrue(FString::Printf(TEXT("Registry memory returns to baseline (%lld bytes, baseline %lld)"), MaterialManager->GetRegistryMemoryBytes(), BaselineBytes),
+        MaterialManager->GetRegistryMemoryBytes() <= BaselineBytes);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimeMaterialTierSwitchTest, "AnimeWorldRunner.Materials.TierSwitch",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimeMaterialTierSwitchTest::RunTest(const FString& Parameters)
+{
+    FAnimeTestWorld TestWorld;
+    UAnimeMaterialManager* MaterialManager = TestWorld.AddComponent<UAnimeMaterialManager>();
+    
+    // Transient parents over the engine default material stand in for permutation assets
+    UMaterialInterface* BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+    FAnimeMaterialQualityPermutations Permutations;
+    Permutations.Low = UMaterialInstanceDynamic::Create(BaseMaterial, GetTransientPackage());
+    Permutations.Medium = UMaterialInstanceDynamic::Create(BaseMaterial, GetTransientPackage());
+    MaterialManager->SetQualityPermutations(BaseMaterial, Permutations);
+    
+    FAnimeMaterialSettings Settings;
+    Settings.BaseMaterial = BaseMaterial;
+    UMaterialInstanceDynamic* Material = MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings, true);
+    if (!TestNotNull(TEXT("Material created"), Material))
+    {
+        return false;
+    }
+    
+    auto ReadScalars = [](const UMaterialInstanceDynamic* TierMaterial)
+    {
+        TArray<float> Values;
+        for (const FScalarParameterValue& Parameter : TierMaterial->ScalarParameterValues)
+        {
+            Values.Add(Parameter.ParameterValue);
+        }
+        return Values;
+    };
+    
+    // Every tier twice in a row, over two full cycles
+    const UMaterialInterface* FirstCycleParents[4] = {};
+    TArray<float> FirstCycleScalars[4];
+    for (int32 Cycle = 0; Cycle < 2; Cycle++)
+    {
+        for (int32 Level = 0; Level < 4; Level++)
+        {
+            MaterialManager->SetQualityLevel(Level);
+            UMaterialInstanceDynamic* TierMaterial = MaterialManager->GetCurrentMaterial(Material);
+            const TArray<float> Scalars = ReadScalars(TierMaterial);
+            
+            MaterialManager->SetQualityLevel(Level);
+            TestTrue(FString::Printf(TEXT("Setting quality %d again keeps the material"), Level), MaterialManager->GetCurrentMaterial(Material) == TierMaterial);
+            TestTrue(FString::Printf(TEXT("Setting quality %d again keeps the scalars"), Level), ReadScalars(TierMaterial) == Scalars);
+            
+            if (Cycle == 0)
+            {
+                FirstCycleParents[Level] = TierMaterial->Parent;
+                FirstCycleScalars[Level] = Scalars;
+            }
+            else
+            {
+                TestTrue(FString::Printf(TEXT("Quality %d has the same parent after a full cycle"), Level), TierMaterial->Parent == FirstCycleParents[Level]);
+                TestTrue(FString::Printf(TEXT("Quality %d has the same scalars after a full cycle"), Level), Scalars == FirstCycleScalars[Level]);
+            }
+        }
+    }
+    
+    TestTrue(TEXT("Low quality uses the Low permutation"), FirstCycleParents[0] == Permutations.Low);
+    TestTrue(TEXT("Medium quality uses the Medium permutation"), FirstCycleParents[1] == Permutations.Medium);
+    TestTrue(TEXT("Ultra quality uses the base material"), FirstCycleParents[3] == BaseMaterial);
+    
+    MaterialManager->ReleaseMaterial(Material);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimeSharedMaterialTest, "AnimeWorldRunner.Materials.SharedReadOnly",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimeSharedMaterialTest::RunTest(const FString& Parameters)
+{
+    FAnimeTestWorld TestWorld;
+    UAnimeMaterialManager* MaterialManager = TestWorld.AddComponent<UAnimeMaterialManager>();
+    
+    FAnimeMaterialSettings Settings;
+    Settings.BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+    UMaterialInstanceDynamic* Material = MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings);
+    if (!TestNotNull(TEXT("Material created"), Material))
+    {
+        return false;
+    }
+    TestTrue(TEXT("Material is shared"), MaterialManager->IsSharedMaterial(Material));
+    
+    TArray<float> Scalars;
+    for (const FScalarParameterValue& Parameter : Material->ScalarParameterValues)
+    {
+        Scalars.Add(Parameter.ParameterValue);
+    }
+    
+    // Edits of a shared instance are refused, so every holder and the cache key keep its settings
+    AddExpectedError(TEXT("shared material"), EAutomationExpectedErrorFlags::Contains, 2);
+    FAnimeMaterialSettings EditedSettings = Settings;
+    EditedSettings.EmissionIntensity = Settings.EmissionIntensity + 1.0f;
+    MaterialManager->UpdateMaterialParameters(Material, EditedSettings);
+    MaterialManager->StartMaterialAnimation(Material, TEXT("EmissionIntensity"), 0.0f, 1.0f, 1.0f);
+    
+    TArray<float> ScalarsAfterEdit;
+    for (const FScalarParameterValue& Parameter : Material->ScalarParameterValues)
+    {
+        ScalarsAfterEdit.Add(Parameter.ParameterValue);
+    }
+    TestTrue(TEXT("Shared material keeps its parameters"), ScalarsAfterEdit == Scalars);
+    
+    UMaterialInstanceDynamic* SameSettings = MaterialManager->CreateAnimeMaterial(EAnimeMaterialType::VFX, Settings);
+    TestTrue(TEXT("Equal settings still share the instance"), SameSettings == Material);
+    
+    MaterialManager->ReleaseMaterial(SameSettings);
+    MaterialManager->ReleaseMaterial(Material);
+    
+    return true;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// A game world that has begun play with one owner actor for the components under test.
+// The world and its context go away with this object, also when a test returns early.
+class FAnimeTestWorld
+{
+public:
+    FAnimeTestWorld()
+    {
+        World = UWorld::CreateWorld(EWorldType::Game, false);
+        FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+        WorldContext.SetCurrentWorld(World);
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+
+        Owner = World->SpawnActor<AActor>();
+        USceneComponent* Root = NewObject<USceneComponent>(Owner);
+        Owner->SetRootComponent(Root);
+        Root->RegisterComponent();
+    }
+
+    ~FAnimeTestWorld()
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+
+    FAnimeTestWorld(const FAnimeTestWorld&) = delete;
+    FAnimeTestWorld& operator=(const FAnimeTestWorld&) = delete;
+
+    // Creates and registers a component on the owner, which begins play right away
+    template<typename ComponentType>
+    ComponentType* AddComponent()
+    {
+        ComponentType* Component = NewObject<ComponentType>(Owner);
+        Component->RegisterComponent();
+        return Component;
+    }
+
+    UWorld* GetWorld() const { return World; }
+    AActor* GetOwner() const { return Owner; }
+
+private:
+    UWorld* World = nullptr;
+    AActor* Owner = nullptr;
+};
+
+#endif
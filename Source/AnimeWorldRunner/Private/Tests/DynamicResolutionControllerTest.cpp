@@ -0,0 +1,100 @@
+#include "Optimization/DynamicResolutionController.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DynamicResolutionTraces
+{
+    static const int32 NumFrames = 1200;
+    
+    static TArray<float> Constant(float FrameTimeMs)
+    {
+        TArray<float> Trace;
+        Trace.Init(FrameTimeMs, NumFrames);
+        return Trace;
+    }
+    
+    // Heavy scene for the middle third
+    static TArray<float> Step()
+    {
+        TArray<float> Trace;
+        for (int32 i = 0; i < NumFrames; i++)
+        {
+            Trace.Add((i >= 300 && i < 700) ? 24.0f : 14.0f);
+        }
+        return Trace;
+    }
+    
+    static TArray<float> Noisy()
+    {
+        TArray<float> Trace;
+        FRandomStream Random(1234);
+        for (int32 i = 0; i < NumFrames; i++)
+        {
+            Trace.Add(19.0f + Random.FRandRange(-4.0f, 4.0f));
+        }
+        return Trace;
+    }
+    
+    // Isolated hitches on an otherwise light scene
+    static TArray<float> Spikes()
+    {
+        TArray<float> Trace;
+        for (int32 i = 0; i < NumFrames; i++)
+        {
+            Trace.Add((i % 90 == 0) ? 60.0f : 15.0f);
+        }
+        return Trace;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicResolutionSettlingTest, "AnimeWorldRunner.Optimization.DynamicResolution.Settling",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicResolutionSettlingTest::RunTest(const FString& Parameters)
+{
+    const FDynamicResolutionControllerSettings Settings;
+    
+    // A scene a third over budget at full resolution
+    const FDynamicResolutionSimulationReport Heavy = FDynamicResolutionController::Simulate(Settings, DynamicResolutionTraces::Constant(22.0f));
+    TestTrue(TEXT("Heavy scene settles"), Heavy.bSettled);
+    TestTrue(FString::Printf(TEXT("Heavy scene settles within 5 s (%.2f s)"), Heavy.SettlingTimeSeconds), Heavy.SettlingTimeSeconds < 5.0f);
+    TestTrue(FString::Printf(TEXT("Heavy scene overshoots less than 10%% (%.1f%%)"), Heavy.OvershootPercent), Heavy.OvershootPercent < 10.0f);
+    TestTrue(FString::Printf(TEXT("Heavy scene takes at most 8 CVar writes (%d)"), Heavy.CVarWrites), Heavy.CVarWrites <= 8);
+    TestTrue(TEXT("Heavy scene lowers the scale"), Heavy.FinalScale < Settings.MaxScale);
+    
+    // The scale comes back once the heavy section is over
+    const FDynamicResolutionSimulationReport Step = FDynamicResolutionController::Simulate(Settings, DynamicResolutionTraces::Step());
+    TestTrue(TEXT("Step settles"), Step.bSettled);
+    TestTrue(TEXT("Step lowers the scale while heavy"), Step.MinAppliedScale < Settings.MaxScale);
+    TestEqual(TEXT("Step returns to full resolution"), Step.FinalScale, Settings.MaxScale);
+    TestTrue(FString::Printf(TEXT("Step takes at most 16 CVar writes (%d)"), Step.CVarWrites), Step.CVarWrites <= 16);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicResolutionStabilityTest, "AnimeWorldRunner.Optimization.DynamicResolution.Stability",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicResolutionStabilityTest::RunTest(const FString& Parameters)
+{
+    const FDynamicResolutionControllerSettings Settings;
+    
+    // Noise around the target must not toggle the scale between steps
+    const FDynamicResolutionSimulationReport Noisy = FDynamicResolutionController::Simulate(Settings, DynamicResolutionTraces::Noisy());
+    TestTrue(TEXT("Noisy trace settles"), Noisy.bSettled);
+    TestTrue(FString::Printf(TEXT("Noisy trace takes at most 10 CVar writes (%d)"), Noisy.CVarWrites), Noisy.CVarWrites <= 10);
+    
+    // Single hitches are smoothed away and never reach the CVar
+    const FDynamicResolutionSimulationReport Spikes = FDynamicResolutionController::Simulate(Settings, DynamicResolutionTraces::Spikes());
+    TestEqual(TEXT("Spikes write no CVar"), Spikes.CVarWrites, 0);
+    TestEqual(TEXT("Spikes keep full resolution"), Spikes.FinalScale, Settings.MaxScale);
+    
+    // Within budget nothing moves at all
+    const FDynamicResolutionSimulationReport Light = FDynamicResolutionController::Simulate(Settings, DynamicResolutionTraces::Constant(14.0f));
+    TestEqual(TEXT("Light scene writes no CVar"), Light.CVarWrites, 0);
+    
+    return true;
+}
+
+#endif
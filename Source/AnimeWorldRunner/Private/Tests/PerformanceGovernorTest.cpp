@@ -0,0 +1,150 @@
+#include "Optimization/PerformanceGovernor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerformanceGovernorLadderTest, "AnimeWorldRunner.Optimization.Governor.Ladder",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerformanceGovernorLadderTest::RunTest(const FString& Parameters)
+{
+    const FPerformanceGovernorSettings Settings;
+    const float OverBudget = Settings.TargetFrameTimeMs * 2.0f;
+    const float UnderBudget = Settings.TargetFrameTimeMs * 0.5f;
+    
+    // Quarter second updates add up exactly to the hold and cooldown times
+    const float DeltaSeconds = 0.25f;
+    const int32 HoldUpdates = FMath::RoundToInt(Settings.DownshiftHoldSeconds / DeltaSeconds);
+    const int32 CooldownUpdates = FMath::RoundToInt(Settings.CooldownSeconds / DeltaSeconds);
+    
+    FPerformanceGovernor Governor;
+    Governor.Configure(Settings);
+    
+    // Nothing happens before the over budget condition has held for the hold time
+    for (int32 i = 1; i < HoldUpdates; i++)
+    {
+        TestFalse(FString::Printf(TEXT("No downshift after %.2f s over budget"), i * DeltaSeconds), Governor.Update(OverBudget, DeltaSeconds));
+    }
+    TestTrue(TEXT("Downshift once the hold time is reached"), Governor.Update(OverBudget, DeltaSeconds));
+    TestEqual(TEXT("First step gives up the material update rate"), Governor.GetBudgetLevel(EGovernedBudget::MaterialUpdateRate), 1);
+    
+    // The next step waits for the cooldown, even though frames stayed over budget
+    for (int32 i = 1; i < CooldownUpdates; i++)
+    {
+        TestFalse(FString::Printf(TEXT("No decision %.2f s into the cooldown"), i * DeltaSeconds), Governor.Update(OverBudget, DeltaSeconds));
+    }
+    TestTrue(TEXT("Downshift once the cooldown is over"), Governor.Update(OverBudget, DeltaSeconds));
+    
+    // The first pass takes one step of every budget, in priority order
+    const EGovernedBudget FirstPass[] = { EGovernedBudget::MaterialUpdateRate, EGovernedBudget::UIAnimationRate, EGovernedBudget::ConcurrentEffects, EGovernedBudget::EnvironmentInstances };
+    TestEqual(TEXT("Second step gives up the UI animation rate"), Governor.GetBudgetLevel(EGovernedBudget::UIAnimationRate), 1);
+    TestEqual(TEXT("Effects untouched after two steps"), Governor.GetBudgetLevel(EGovernedBudget::ConcurrentEffects), 0);
+    
+    // Walk down the whole ladder; it stops at the last step
+    int32 NumUpdates = 0;
+    while (Governor.GetLevel() < Governor.GetNumLevels() && NumUpdates++ < 1000)
+    {
+        Governor.Update(OverBudget, DeltaSeconds);
+    }
+    TestEqual(TEXT("Ladder reaches its last step"), Governor.GetLevel(), Governor.GetNumLevels());
+    for (int32 i = 0; i < 2 * CooldownUpdates; i++)
+    {
+        TestFalse(TEXT("No step past the end of the ladder"), Governor.Update(OverBudget, DeltaSeconds));
+    }
+    for (EGovernedBudget Budget : FirstPass)
+    {
+        TestTrue(FString::Printf(TEXT("%s was reduced"), FPerformanceGovernor::GetBudgetName(Budget)), Governor.GetBudgetLevel(Budget) > 0);
+    }
+    
+    // Upshifting waits for the longer upshift hold and undoes the last step first
+    const int32 EnvironmentLevel = Governor.GetBudgetLevel(EGovernedBudget::EnvironmentInstances);
+    const int32 UpshiftHoldUpdates = FMath::RoundToInt(Settings.UpshiftHoldSeconds / DeltaSeconds);
+    for (int32 i = 1; i < UpshiftHoldUpdates; i++)
+    {
+        TestFalse(FString::Printf(TEXT("No upshift after %.2f s under budget"), i * DeltaSeconds), Governor.Update(UnderBudget, DeltaSeconds));
+    }
+    TestTrue(TEXT("Upshift once the upshift hold is reached"), Governor.Update(UnderBudget, DeltaSeconds));
+    TestEqual(TEXT("Upshift restores the environment instances first"), Governor.GetBudgetLevel(EGovernedBudget::EnvironmentInstances), EnvironmentLevel - 1);
+    TestEqual(TEXT("One step back up"), Governor.GetLevel(), Governor.GetNumLevels() - 1);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerformanceGovernorHoldTest, "AnimeWorldRunner.Optimization.Governor.Hold",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerformanceGovernorHoldTest::RunTest(const FString& Parameters)
+{
+    const FPerformanceGovernorSettings Settings;
+    
+    // Between the upshift and downshift thresholds the governor holds its level
+    FPerformanceGovernor Governor;
+    Governor.Configure(Settings);
+    for (int32 i = 0; i < 600; i++)
+    {
+        TestFalse(TEXT("No decision inside the hysteresis band"), Governor.Update(Settings.TargetFrameTimeMs, 0.1f));
+    }
+    TestEqual(TEXT("Level stays at full budgets"), Governor.GetLevel(), 0);
+    
+    // Memory pressure counts as over budget, however fast the frames are
+    Governor.SetMemoryPressure(true);
+    for (int32 i = 0; i < 600; i++)
+    {
+        Governor.Update(Settings.TargetFrameTimeMs * 0.5f, 0.1f);
+    }
+    TestTrue(TEXT("Memory pressure downshifts"), Governor.GetLevel() > 0);
+    
+    const int32 PressureLevel = Governor.GetLevel();
+    Governor.SetMemoryPressure(false);
+    Governor.Update(Settings.TargetFrameTimeMs * 0.5f, 0.1f);
+    TestEqual(TEXT("No immediate upshift once the pressure is gone"), Governor.GetLevel(), PressureLevel);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerformanceGovernorSimulationTest, "AnimeWorldRunner.Optimization.Governor.Simulation",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FPerformanceGovernorSimulationTest::RunTest(const FString& Parameters)
+{
+    const FPerformanceGovernorSettings Settings;
+    const int32 NumFrames = 3600;
+    
+    // Isolated hitches never move the p95 over the threshold
+    TArray<float> Spikes;
+    for (int32 i = 0; i < NumFrames; i++)
+    {
+        Spikes.Add((i % 120 == 0) ? 80.0f : 14.0f);
+    }
+    const FPerformanceGovernorSimulationReport SpikesReport = FPerformanceGovernor::Simulate(Settings, Spikes);
+    TestEqual(TEXT("Spikes cause no downshift"), SpikesReport.Downshifts, 0);
+    
+    // A busy section in the middle: steps down while it lasts, then gives budgets back
+    TArray<float> Heavy;
+    for (int32 i = 0; i < NumFrames; i++)
+    {
+        Heavy.Add((i >= 600 && i < 2400) ? 21.0f : 13.0f);
+    }
+    const FPerformanceGovernorSimulationReport HeavyReport = FPerformanceGovernor::Simulate(Settings, Heavy);
+    TestTrue(TEXT("Heavy section downshifts"), HeavyReport.Downshifts > 0);
+    TestTrue(TEXT("Budgets come back after the heavy section"), HeavyReport.Upshifts > 0 && HeavyReport.FinalLevel < HeavyReport.MaxLevel);
+    
+    // Cooldown spaces the steps, so a minute can hold at most one decision per cooldown
+    const float MaxDecisions = HeavyReport.DurationSeconds / Settings.CooldownSeconds + 1.0f;
+    TestTrue(TEXT("Decisions are spaced by the cooldown"), HeavyReport.Downshifts + HeavyReport.Upshifts <= MaxDecisions);
+    
+    // A scene that stays overloaded only ever steps down
+    TArray<float> Overloaded;
+    FRandomStream Random(4321);
+    for (int32 i = 0; i < NumFrames; i++)
+    {
+        Overloaded.Add(30.0f + Random.FRandRange(-3.0f, 3.0f));
+    }
+    const FPerformanceGovernorSimulationReport OverloadedReport = FPerformanceGovernor::Simulate(Settings, Overloaded);
+    TestTrue(TEXT("Overloaded scene downshifts repeatedly"), OverloadedReport.Downshifts >= 5);
+    TestEqual(TEXT("Overloaded scene never upshifts"), OverloadedReport.Upshifts, 0);
+    
+    return true;
+}
+
+#endif
@@ -1,4 +1,7 @@
 #include "UI/AnimeUIManager.h"
+#include "Optimization/HitchRecorder.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
+#include "Optimization/SubsystemMemoryTracker.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/Widget.h"
 #include "Engine/World.h"
@@ -22,6 +25,9 @@ UAnimeUIManager::UAnimeUIManager()
     NotificationTimer = 0.0f;
     NotificationSpacing = 80.0f;
     
+    AnimationUpdateRate = 0.0f; // Every frame
+    AnimationUpdateTimer = 0.0f;
+    
     // Initialize default UI style
     CurrentUIStyle = FAnimeUIStyle();
 }
@@ -45,11 +51,20 @@ void UAnimeUIManager::BeginPlay()
 
 void UAnimeUIManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    AWR_HITCH_SCOPE(UI);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_UITick, AWRGameplayChannel, "UAnimeUIManager::TickComponent");
+    
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     
     NotificationTimer += DeltaTime;
     ProcessNotificationQueue();
-    UpdateUIAnimations(DeltaTime);
+    
+    AnimationUpdateTimer += DeltaTime;
+    if (AnimationUpdateRate <= 0.0f || AnimationUpdateTimer >= 1.0f / AnimationUpdateRate)
+    {
+        UpdateUIAnimations(AnimationUpdateTimer);
+        AnimationUpdateTimer = 0.0f;
+    }
 }
 
 void UAnimeUIManager::InitializeUIWidgets()
@@ -69,6 +84,8 @@ void UAnimeUIManager::InitializeUIWidgets()
 
 void UAnimeUIManager::CreateUIWidget(EAnimeUIType UIType)
 {
+    AWR_LLM_SCOPE(UI);
+    
     if (TSubclassOf<UUserWidget>* WidgetClass = UIWidgetClasses.Find(UIType))
     {
         if (*WidgetClass)
@@ -94,6 +111,9 @@ void UAnimeUIManager::CreateUIWidget(EAnimeUIType UIType)
 
 void UAnimeUIManager::ShowUI(EAnimeUIType UIType, bool bAnimate)
 {
+    AWR_HITCH_SCOPE(UI);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_ShowHideUI, AWRGameplayChannel, "UAnimeUIManager::ShowUI");
+    
     if (UUserWidget** Widget = ActiveUIWidgets.Find(UIType))
     {
         if (*Widget)
@@ -117,6 +137,9 @@ void UAnimeUIManager::ShowUI(EAnimeUIType UIType, bool bAnimate)
 
 void UAnimeUIManager::HideUI(EAnimeUIType UIType, bool bAnimate)
 {
+    AWR_HITCH_SCOPE(UI);
+    AWR_SCOPE_CYCLE_COUNTER(STAT_AWR_ShowHideUI, AWRGameplayChannel, "UAnimeUIManager::HideUI");
+    
     if (UUserWidget** Widget = ActiveUIWidgets.Find(UIType))
     {
         if (*Widget)
@@ -251,6 +274,7 @@ void UAnimeUIManager::ProcessNotificationQueue()
         {
             if (*NotificationClass)
             {
+                AWR_LLM_SCOPE(UI);
                 UUserWidget* NotificationWidget = CreateWidget<UUserWidget>(GetWorld(), *NotificationClass);
                 if (NotificationWidget)
                 {
@@ -701,9 +725,37 @@ void UAnimeUIManager::AnimateSlideOut(UUserWidget* Widget, float Duration)
     AnimationTimers.Add(Widget, SlideTimer);
 }
 
+void UAnimeUIManager::SetAnimationUpdateRate(float UpdatesPerSecond)
+{
+    AnimationUpdateRate = FMath::Max(UpdatesPerSecond, 0.0f);
+}
+
 void UAnimeUIManager::UpdateUIAnimations(float DeltaTime)
 {
     // This function handles any continuous UI animations
     // Most animations are handled by timers, but this can be used for
     // continuous effects like glow pulsing, etc.
 }
+
+int64 UAnimeUIManager::GetWidgetMemoryBytes() const
+{
+    int64 WidgetBytes = 0;
+    
+    for (const auto& WidgetPair : ActiveUIWidgets)
+    {
+        if (IsValid(WidgetPair.Value))
+        {
+            WidgetBytes += WidgetPair.Value->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+        }
+    }
+    
+    for (UUserWidget* Notification : ActiveNotifications)
+    {
+        if (IsValid(Notification))
+        {
+            WidgetBytes += Notification->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+        }
+    }
+    
+    return WidgetBytes;
+}
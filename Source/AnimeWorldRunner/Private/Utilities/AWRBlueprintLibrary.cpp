@@ -1,10 +1,12 @@
 #include "Utilities/AWRBlueprintLibrary.h"
 #include "Engine/Engine.h"
+#include "UnrealEngine.h"
 #include "GameFramework/GameUserSettings.h"
 #include "HAL/PlatformApplicationMisc.h"
 #include "GenericPlatform/GenericPlatformMemory.h"
 #include "Engine/StreamableManager.h"
 #include "Engine/AssetManager.h"
+#include "Optimization/DeviceCalibration.h"
 
 void UAWRBlueprintLibrary::AdjustGraphicsForDevice()
 {
@@ -86,21 +88,27 @@ void UAWRBlueprintLibrary::SetTargetFramerate(int32 FrameRate)
 
 int32 UAWRBlueprintLibrary::GetDevicePerformanceTier()
 {
-    // Simple device tier detection based on memory
+    // Memory sets an upper bound on the tier
     int32 MemoryMB = GetDeviceMemoryMB();
+    int32 MemoryTier = 2; // High-end
     
     if (MemoryMB < 2048) // Less than 2GB
     {
-        return 0; // Low-end
+        MemoryTier = 0; // Low-end
     }
     else if (MemoryMB < 4096) // Less than 4GB
     {
-        return 1; // Mid-range
+        MemoryTier = 1; // Mid-range
     }
-    else
+    
+    // CPU throughput from the startup calibration, when one has been measured for this build
+    const int32 CalibratedTier = FDeviceCalibration::GetPerformanceTier(FDeviceCalibration::GetCached());
+    if (CalibratedTier < 0)
     {
-        return 2; // High-end
+        return MemoryTier;
     }
+    
+    return FMath::Min(MemoryTier, CalibratedTier);
 }
 
 FVector2D UAWRBlueprintLibrary::GetScreenResolution()
@@ -197,11 +205,8 @@ bool UAWRBlueprintLibrary::IsLowEndDevice()
 
 float UAWRBlueprintLibrary::GetCurrentFPS()
 {
-    if (GEngine)
-    {
-        return GEngine->GetMaxFPS();
-    }
-    return 60.0f;
+    // Measured rate averaged by the engine; GetMaxFPS is only the cap
+    return GAverageFPS;
 }
 
 float UAWRBlueprintLibrary::GetMemoryUsageMB()
@@ -209,3 +214,9 @@ float UAWRBlueprintLibrary::GetMemoryUsageMB()
     FPlatformMemoryStats MemStats = FPlatformMemory::GetStats();
     return static_cast<float>(MemStats.UsedPhysical / (1024 * 1024));
 }
+
+FRenderMetricsSample UAWRBlueprintLibrary::GetRenderMetrics(const UObject* WorldContextObject)
+{
+    const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+    return IPerformanceMetricsProvider::GetFrameSample(World);
+}
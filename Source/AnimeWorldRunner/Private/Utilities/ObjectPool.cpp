@@ -1,4 +1,5 @@
 #include "Utilities/ObjectPool.h"
+#include "Optimization/AnimeWorldRunnerStats.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 
@@ -57,6 +58,7 @@ AActor* UObjectPool::GetPooledObject()
         PooledActor->SetActorHiddenInGame(false);
         PooledActor->SetActorEnableCollision(true);
         ActiveObjects.Add(PooledActor);
+        INC_DWORD_STAT(STAT_AWR_PooledActorsInUse);
     }
     
     return PooledActor;
@@ -74,6 +76,7 @@ void UObjectPool::ReturnPooledObject(AActor* Actor)
     if (Index != INDEX_NONE)
     {
         ActiveObjects.RemoveAt(Index);
+        DEC_DWORD_STAT(STAT_AWR_PooledActorsInUse);
         
         // Deactivate the object
         Actor->SetActorHiddenInGame(true);
@@ -104,6 +107,9 @@ void UObjectPool::ClearPool()
         }
     }
     
+    DEC_DWORD_STAT_BY(STAT_AWR_PooledActorsInUse, ActiveObjects.Num());
+    DEC_DWORD_STAT_BY(STAT_AWR_PooledActors, ActiveObjects.Num() + InactiveObjects.Num());
+    
     ActiveObjects.Empty();
     InactiveObjects.Empty();
 }
@@ -137,5 +143,11 @@ AActor* UObjectPool::CreatePooledObject()
     FVector SpawnLocation = FVector(0.0f, 0.0f, -10000.0f); // Spawn far away
     FRotator SpawnRotation = FRotator::ZeroRotator;
     
-    return WorldContext->SpawnActor<AActor>(PooledObjectClass, SpawnLocation, SpawnRotation);
+    AActor* NewActor = WorldContext->SpawnActor<AActor>(PooledObjectClass, SpawnLocation, SpawnRotation);
+    if (NewActor)
+    {
+        INC_DWORD_STAT(STAT_AWR_PooledActors);
+    }
+    
+    return NewActor;
 }
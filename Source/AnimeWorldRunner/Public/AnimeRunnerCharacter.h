@@ -8,6 +8,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Components/AudioComponent.h"
+#include "Effects/AnimeEffectsManager.h"
 #include "AnimeRunnerCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -128,11 +129,16 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Effects")
     UParticleSystemComponent* RunEffectComponent;
     
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio")
+    // Unused; kept so Blueprints that read them still load. Sounds play through the effects manager's pooled voices.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio", meta = (DeprecatedProperty, DeprecationMessage = "Footsteps play as the Footstep effect through the effects manager."))
     UAudioComponent* FootstepAudioComponent;
     
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio")
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio", meta = (DeprecatedProperty, DeprecationMessage = "Ability sounds play with their effects through the effects manager."))
     UAudioComponent* AbilityAudioComponent;
+    
+    // Footsteps play through the effects manager's pooled voices, one per stride on the ground
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+    float FootstepStride;
 
     // 3D Movement properties
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
@@ -191,6 +197,10 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
     float ManaCost;
     
+    // Effects this character's abilities can play; preloaded while it is equipped
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+    TArray<EAnimeEffectType> AbilityEffects;
+    
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     class UInventoryComponent* InventoryComponent;
     
@@ -235,6 +245,9 @@ protected:
     float LookUpInputValue;
     float TurnInputValue;
     
+    // Ground distance covered since the last footstep
+    float FootstepDistance;
+    
     // Animation and state handling
     void UpdateAnimationState();
     void UpdateMovementMode();
@@ -7,8 +7,13 @@
 #include "Sound/SoundCue.h"
 #include "Components/AudioComponent.h"
 #include "Engine/World.h"
+#include "Engine/StreamableManager.h"
+#include "Environment/EnvironmentTheme.h"
 #include "AnimeEffectsManager.generated.h"
 
+class UNiagaraSystem;
+class UNiagaraComponent;
+
 UENUM(BlueprintType)
 enum class EAnimeEffectType : uint8
 {
@@ -26,7 +31,65 @@ enum class EAnimeEffectType : uint8
     Hit             UMETA(DisplayName = "Hit Effect"),
     Explosion       UMETA(DisplayName = "Explosion Effect"),
     Heal            UMETA(DisplayName = "Heal Effect"),
-    Shield          UMETA(DisplayName = "Shield Effect")
+    Shield          UMETA(DisplayName = "Shield Effect"),
+    Footstep        UMETA(DisplayName = "Footstep")
+};
+
+// Which playing instance gives way when an effect is over its instance cap or the global budget
+UENUM(BlueprintType)
+enum class EEffectStealPolicy : uint8
+{
+    Oldest          UMETA(DisplayName = "Steal Oldest"),
+    Farthest        UMETA(DisplayName = "Steal Farthest From Camera"),
+    LowestPriority  UMETA(DisplayName = "Steal Lowest Priority"),
+    DontSteal       UMETA(DisplayName = "Skip New Effect")
+};
+
+// Sounds of a category share a voice limit, a retrigger rate and an audible distance
+UENUM(BlueprintType)
+enum class EAnimeSoundCategory : uint8
+{
+    Default         UMETA(DisplayName = "Default"),
+    Movement        UMETA(DisplayName = "Footsteps and Movement"),
+    Ability         UMETA(DisplayName = "Abilities"),
+    Pickup          UMETA(DisplayName = "Pickups"),
+    Impact          UMETA(DisplayName = "Impacts"),
+    Ambient         UMETA(DisplayName = "Ambient Loops"),
+    Count           UMETA(Hidden)
+};
+
+USTRUCT(BlueprintType)
+struct FAnimeSoundCategorySettings
+{
+    GENERATED_BODY()
+
+    // Voices of this category that may play at once; the oldest gives way to a new sound
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio", meta = (ClampMin = "1"))
+    int32 MaxVoices;
+
+    // A one-shot started sooner than this after the last play of the same sound is dropped (coin chains)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio", meta = (ClampMin = "0.0"))
+    float MinRetriggerTime;
+
+    // Beyond this distance from the listener sounds take no voice; looping sounds resume when back in range
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio", meta = (ClampMin = "0.0"))
+    float MaxAudibleDistance;
+
+    FAnimeSoundCategorySettings()
+    {
+        MaxVoices = 4;
+        MinRetriggerTime = 0.0f;
+        MaxAudibleDistance = 5000.0f;
+    }
+};
+
+// Fidelity an effect plays at, re-evaluated every frame from distance, screen size and view direction
+UENUM(BlueprintType)
+enum class EEffectSignificance : uint8
+{
+    Full            UMETA(DisplayName = "Full"),
+    Reduced         UMETA(DisplayName = "Reduced Emitters"),
+    Suppressed      UMETA(DisplayName = "Suppressed")
 };
 
 USTRUCT(BlueprintType)
@@ -34,11 +97,24 @@ struct FAnimeEffectData
 {
     GENERATED_BODY()
 
+    // Soft references, loaded in the background when the effect enters the preload set
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    TSoftObjectPtr<UParticleSystem> ParticleEffect;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
-    UParticleSystem* ParticleEffect;
+    TSoftObjectPtr<USoundCue> SoundEffect;
 
+    // Optional shared system for frequent one-shots; spawns are batched and replace ParticleEffect.
+    // The system reads the User.BurstPositions and User.BurstColors arrays and spawns User.BurstCount bursts in a frame.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
-    USoundCue* SoundEffect;
+    TSoftObjectPtr<UNiagaraSystem> BurstEffect;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    EAnimeSoundCategory SoundCategory;
+
+    // Kept loaded for every character and theme (movement and pickups)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    bool bAlwaysLoaded;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
     float Duration;
@@ -55,18 +131,137 @@ struct FAnimeEffectData
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
     FName AttachSocketName;
 
+    // Components created at BeginPlay so the first plays of this effect do not allocate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect", meta = (ClampMin = "0"))
+    int32 PrewarmCount;
+
+    // Instances of this effect that may play at once (particle and sound voices)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Concurrency", meta = (ClampMin = "1"))
+    int32 MaxInstances;
+
+    // When the global budget is full, an effect may only take the place of one with equal or lower priority
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Concurrency")
+    int32 Priority;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Concurrency")
+    EEffectStealPolicy StealPolicy;
+
     FAnimeEffectData()
     {
-        ParticleEffect = nullptr;
-        SoundEffect = nullptr;
+        SoundCategory = EAnimeSoundCategory::Default;
+        bAlwaysLoaded = false;
         Duration = 1.0f;
         Scale = FVector(1.0f, 1.0f, 1.0f);
         Color = FLinearColor::White;
         bAttachToActor = true;
         AttachSocketName = NAME_None;
+        PrewarmCount = 0;
+        MaxInstances = 1;
+        Priority = 0;
+        StealPolicy = EEffectStealPolicy::Oldest;
+    }
+};
+
+// One play of an effect; either component may be missing when the effect has no asset for it
+USTRUCT()
+struct FActiveEffectInstance
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UParticleSystemComponent* ParticleComponent;
+
+    UPROPERTY()
+    UAudioComponent* AudioComponent;
+
+    uint32 InstanceId;
+    float StartTime;
+    int32 Priority;
+
+    // World time at which each part is released; 0 keeps it until stopped
+    float ParticleEndTime;
+    float AudioEndTime;
+
+    EEffectSignificance Significance;
+
+    // Looping sound out of range or without a free voice; started again by UpdateSoundVoices
+    bool bSoundVirtual;
+
+    FActiveEffectInstance()
+    {
+        ParticleComponent = nullptr;
+        AudioComponent = nullptr;
+        InstanceId = 0;
+        StartTime = 0.0f;
+        Priority = 0;
+        ParticleEndTime = 0.0f;
+        AudioEndTime = 0.0f;
+        Significance = EEffectSignificance::Full;
+        bSoundVirtual = false;
+    }
+};
+
+// Entry in the expiry heap; stale entries for instances that were already stopped are skipped
+struct FEffectExpiry
+{
+    float ExpiryTime;
+    EAnimeEffectType EffectType;
+    uint32 InstanceId;
+
+    bool operator<(const FEffectExpiry& Other) const { return ExpiryTime < Other.ExpiryTime; }
+};
+
+USTRUCT()
+struct FActiveEffectInstanceList
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FActiveEffectInstance> Instances;
+};
+
+USTRUCT(BlueprintType)
+struct FAnimeEffectTypeSet
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    TArray<EAnimeEffectType> EffectTypes;
+};
+
+// Spawn requests for one burst effect, emitted together by its persistent system once per frame
+USTRUCT()
+struct FAnimeBurstBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UNiagaraComponent* Component;
+
+    // Preallocated to MaxBurstSpawnsPerFrame and reset, never shrunk, after each flush
+    TArray<FVector> Positions;
+    TArray<FLinearColor> Colors;
+
+    // The arrays still hold the last frame's spawns and must be cleared once
+    bool bNeedsClear;
+
+    FAnimeBurstBatch()
+    {
+        Component = nullptr;
+        bNeedsClear = false;
     }
 };
 
+// Inactive particle components of one effect type waiting to be played again
+USTRUCT()
+struct FAnimeEffectComponentPool
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<UParticleSystemComponent*> FreeParticleComponents;
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class ANIMEWORLDRUNNER_API UAnimeEffectsManager : public UActorComponent
 {
@@ -88,6 +283,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Anime Effects")
     void PlayEffectAtLocation(EAnimeEffectType EffectType, FVector Location, FRotator Rotation = FRotator::ZeroRotator);
 
+    // PlayEffect with a per-call color; effects with a burst system queue it on the shared system
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void PlayBurstEffect(EAnimeEffectType EffectType, FVector Location, FLinearColor Color);
+
     UFUNCTION(BlueprintCallable, Category = "Anime Effects")
     void PlayEffectAttached(EAnimeEffectType EffectType, USceneComponent* AttachComponent, FName SocketName = NAME_None);
 
@@ -97,6 +296,18 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Anime Effects")
     void StopAllEffects();
 
+    // Continuous effects (Duration < 0) only start and stop on a state change; safe to call every tick
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetContinuousEffect(EAnimeEffectType EffectType, bool bActive, USceneComponent* AttachComponent = nullptr);
+
+    // True only while an instance of the effect is playing
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    bool IsContinuousEffectActive(EAnimeEffectType EffectType) const { return ActiveContinuousEffects.Contains(EffectType); }
+
+    // Replaces the data of one effect type, for Blueprint overrides after BeginPlay
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetEffectData(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData);
+
     // Specialized anime-style effects
     UFUNCTION(BlueprintCallable, Category = "Anime Effects")
     void PlayDashTrail(FVector StartLocation, FVector EndLocation);
@@ -117,17 +328,93 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Anime Effects")
     void PlayCameraShake(float Intensity = 1.0f, float Duration = 0.5f);
 
+    // Called by the performance governor
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetEffectBudget(int32 MaxConcurrent, float EffectScale);
+
+    // Called with the quality level; scales the significance distances (1 = high quality)
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetSignificanceScale(float DistanceScale);
+
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    int32 GetActiveEffectCount() const;
+
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    int32 GetActiveInstanceCount(EAnimeEffectType EffectType) const;
+
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    int32 GetActiveParticleCount() const;
+
+    // Creates the PrewarmCount components of every effect type up front
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void PrewarmEffectPools();
+
+    // Preload set: always-loaded effects, the effects of the character's abilities and those of the current theme
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetCharacterEffects(const TArray<EAnimeEffectType>& EffectTypes);
+
+    UFUNCTION(BlueprintCallable, Category = "Anime Effects")
+    void SetEffectTheme(EEnvironmentTheme Theme);
+
+    // False while the assets are still streaming in; playing the effect then skips the missing parts
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    bool IsEffectLoaded(EAnimeEffectType EffectType) const;
+
+    // Sound voices currently playing in a category
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    int32 GetActiveVoiceCount(EAnimeSoundCategory Category) const;
+
+    UFUNCTION(BlueprintPure, Category = "Anime Effects")
+    int32 GetNumAudioVoicesCreated() const { return NumAudioVoicesCreated; }
+
+    // Components allocated since BeginPlay; stays flat once the pools are warm
+    int32 GetNumComponentsCreated() const { return NumComponentsCreated; }
+
+    // True once the effect type's BurstEffect has loaded and its persistent component exists
+    bool HasBurstBatch(EAnimeEffectType EffectType) const { return BurstBatches.Contains(EffectType); }
+
+    // Burst spawns queued for the next flush
+    int32 GetNumQueuedBurstSpawns(EAnimeEffectType EffectType) const;
+    int32 GetMaxBurstSpawnsPerFrame() const { return MaxBurstSpawnsPerFrame; }
+
+    // One-shot spawns skipped because the effect would have started suppressed
+    int32 GetNumSpawnsSkipped() const { return NumSpawnsSkipped; }
+
+    // Burst requests dropped because the frame's buffer was full
+    int32 GetNumBurstSpawnsDropped() const { return NumBurstSpawnsDropped; }
+
+    // Sounds that took no voice: retriggered too soon, out of range, or the category was full of newer voices
+    int32 GetNumSoundsRateLimited() const { return NumSoundsRateLimited; }
+    int32 GetNumSoundsVirtualized() const { return NumSoundsVirtualized; }
+    int32 GetNumVoicesStolen() const { return NumVoicesStolen; }
+
+    // Particle components activated by PlayEffectAttached since BeginPlay, pooled or not
+    int32 GetNumAttachedPlays() const { return NumAttachedPlays; }
+
+    // Exclusive memory of the effect components this manager owns (bytes)
+    int64 GetEffectMemoryBytes() const;
+
 protected:
     // Effect data mapping
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect Data")
     TMap<EAnimeEffectType, FAnimeEffectData> EffectDataMap;
 
-    // Active effect components
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Active Effects")
-    TMap<EAnimeEffectType, UParticleSystemComponent*> ActiveParticleEffects;
+    // Effects preloaded while the player is in a theme
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect Data")
+    TMap<EEnvironmentTheme, FAnimeEffectTypeSet> ThemeEffects;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Effect Data")
+    TArray<EAnimeEffectType> CharacterEffectTypes;
 
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Active Effects")
-    TMap<EAnimeEffectType, UAudioComponent*> ActiveAudioEffects;
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Effect Data")
+    EEnvironmentTheme CurrentTheme;
+
+    // Streaming handles keep the assets of each loaded effect type resident
+    TMap<EAnimeEffectType, TSharedPtr<FStreamableHandle>> EffectLoadHandles;
+
+    // Playing instances per effect type
+    UPROPERTY(Transient)
+    TMap<EAnimeEffectType, FActiveEffectInstanceList> ActiveEffects;
 
     // Persistent effects
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Persistent Effects")
@@ -149,15 +436,122 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
     bool bEnableCameraShake;
 
+    // Particle effects allowed at once across all types; set from the quality profile and the performance governor
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+    int32 MaxConcurrentEffects;
+
+    // Multiplier on GlobalEffectScale owned by the performance governor
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Settings")
+    float EffectBudgetScale;
+
+    // Significance LOD: full fidelity inside the full distance, reduced emitter set out to the
+    // suppress distance, suppressed beyond it, below the minimum screen size or behind the camera
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance")
+    float SignificanceFullDistance;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance")
+    float SignificanceSuppressDistance;
+
+    // Effect bounds radius over the half-width of the view at its distance
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance")
+    float MinEffectScreenSize;
+
+    // Emitters below this significance level are switched off in the reduced tier
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance")
+    EParticleSignificanceLevel ReducedRequiredSignificance;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Significance")
+    float SignificanceDistanceScale;
+
+    // Free components kept per effect type; extra ones are destroyed when they stop
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+    int32 MaxPooledComponentsPerType;
+
+    // Stopped components are returned here instead of being destroyed
+    UPROPERTY(Transient)
+    TMap<EAnimeEffectType, FAnimeEffectComponentPool> ComponentPools;
+
+    // Voice limits per category; categories without an entry use the default settings
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+    TMap<EAnimeSoundCategory, FAnimeSoundCategorySettings> SoundCategories;
+
+    // Audio components are shared by all effect types and categories; SetSound is cheap
+    UPROPERTY(Transient)
+    TArray<UAudioComponent*> FreeAudioVoices;
+
+    int32 NumAudioVoicesCreated;
+
+    // Last start time of each sound asset, so different sounds of one category never block each other
+    TMap<TObjectKey<USoundBase>, float> LastSoundTimes;
+
+    // One persistent system per effect type with a loaded BurstEffect
+    UPROPERTY(Transient)
+    TMap<EAnimeEffectType, FAnimeBurstBatch> BurstBatches;
+
+    // Requests past this many in one frame are dropped rather than growing the buffers
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+    int32 MaxBurstSpawnsPerFrame;
+
+    int32 NumComponentsCreated;
+    int32 NumAttachedPlays;
+    int32 NumSpawnsSkipped;
+    int32 NumBurstSpawnsDropped;
+    int32 NumSoundsRateLimited;
+    int32 NumSoundsVirtualized;
+    int32 NumVoicesStolen;
+    uint32 NextInstanceId;
+
+    // Continuous effects switched on through SetContinuousEffect that have a playing instance
+    TSet<EAnimeEffectType> ActiveContinuousEffects;
+
+    // Continuous effects switched on while their template was still loading; OnEffectLoaded starts them
+    TSet<EAnimeEffectType> PendingContinuousEffects;
+
 private:
     // Helper functions
     void InitializeEffectData();
-    void CleanupExpiredEffects();
+    void UpdatePreloadSet();
+    void RequestEffectLoad(EAnimeEffectType EffectType);
+    void OnEffectLoaded(EAnimeEffectType EffectType);
+    void PrewarmEffectPool(EAnimeEffectType EffectType);
+    void ClearEffectPool(EAnimeEffectType EffectType);
+    void ScheduleExpiry(float ExpiryTime, EAnimeEffectType EffectType, uint32 InstanceId);
+    void ProcessExpiredEffects();
+    void ExpireEffectInstance(EAnimeEffectType EffectType, uint32 InstanceId, float Now);
+    bool HasEffectBudget(EAnimeEffectType EffectType) const;
+    FActiveEffectInstance* AddEffectInstance(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData, const FVector& Location, bool bNeedsParticle, bool& bOutParticleBudget);
+    bool StealEffectInstance(EEffectStealPolicy Policy, int32 MaxPriority, const EAnimeEffectType* OnlyType, bool bNeedsParticle);
+    void StopEffectInstance(EAnimeEffectType EffectType, int32 InstanceIndex);
+    void StopEffectInstanceById(EAnimeEffectType EffectType, uint32 InstanceId);
+    FVector GetViewLocation() const;
+    bool GetViewPoint(FVector& OutLocation, FVector& OutDirection, float& OutTanHalfFOV) const;
+    EEffectSignificance EvaluateSignificance(const FVector& Location, float Radius, const FVector& ViewLocation, const FVector& ViewDirection, float TanHalfFOV) const;
+    void UpdateEffectSignificance();
+    void ApplySignificance(FActiveEffectInstance& Instance, EEffectSignificance Significance) const;
+    void PlayEffectTinted(EAnimeEffectType EffectType, const FVector& Location, const FRotator& Rotation, const FLinearColor* ColorOverride);
+    bool QueueBurstSpawn(EAnimeEffectType EffectType, const FAnimeEffectData& EffectData, const FVector& Location, const FLinearColor& Color);
+    void FlushBurstSpawns();
+    UNiagaraComponent* CreateBurstComponent(UNiagaraSystem* BurstSystem);
     UParticleSystemComponent* CreateParticleComponent(UParticleSystem* ParticleSystem);
     UAudioComponent* CreateAudioComponent(USoundCue* SoundCue);
-
-    // Timer handles for cleanup
-    FTimerHandle EffectCleanupTimer;
+    UParticleSystemComponent* AcquireParticleComponent(EAnimeEffectType EffectType, UParticleSystem* ParticleSystem);
+    UAudioComponent* AcquireAudioVoice(USoundCue* SoundCue);
+    void ReleaseParticleComponent(EAnimeEffectType EffectType, UParticleSystemComponent* ParticleComp);
+    void ReleaseAudioVoice(UAudioComponent* AudioComp);
+    void PrewarmAudioVoices();
+    const FAnimeSoundCategorySettings& GetSoundCategorySettings(EAnimeSoundCategory Category) const;
+    EAnimeSoundCategory GetSoundCategory(EAnimeEffectType EffectType) const;
+    bool IsSoundAudible(EAnimeSoundCategory Category, const FVector& Location, const FVector& ListenerLocation) const;
+    bool ReserveSoundVoice(EAnimeSoundCategory Category);
+    bool StartSoundVoice(FActiveEffectInstance& Instance, EAnimeEffectType EffectType, USoundCue* SoundCue, const FVector& Location);
+    void UpdateSoundVoices();
+
+    // Min-heap on expiry time, drained once per tick instead of one timer per effect
+    TArray<FEffectExpiry> ExpiryHeap;
+    
+    // The dash trail has no instance; it expires through the heap with this id
+    static constexpr uint32 DashTrailInstanceId = 0;
+    float DashTrailEndTime;
     
     // Screen effect materials (to be set in Blueprint)
     UPROPERTY(EditAnywhere, Category = "Screen Effects")
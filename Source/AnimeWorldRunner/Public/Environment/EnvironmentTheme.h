@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentTheme.generated.h"
+
+UENUM(BlueprintType)
+enum class EEnvironmentTheme : uint8
+{
+    Forest          UMETA(DisplayName = "Forest"),
+    Mountain        UMETA(DisplayName = "Mountain"),
+    Beach           UMETA(DisplayName = "Beach"),
+    Village         UMETA(DisplayName = "Village"),
+    Ruins           UMETA(DisplayName = "Ancient Ruins"),
+    Sky             UMETA(DisplayName = "Sky Islands"),
+    Cave            UMETA(DisplayName = "Cave"),
+    Desert          UMETA(DisplayName = "Desert")
+};
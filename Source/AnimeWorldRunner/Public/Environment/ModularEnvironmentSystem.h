@@ -5,6 +5,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Materials/AnimeMaterialManager.h"
+#include "Environment/EnvironmentTheme.h"
 #include "ModularEnvironmentSystem.generated.h"
 
 UENUM(BlueprintType)
@@ -24,17 +25,44 @@ enum class EEnvironmentPieceType : uint8
     Decoration      UMETA(DisplayName = "Decoration")
 };
 
-UENUM(BlueprintType)
-enum class EEnvironmentTheme : uint8
+// Per-instance custom data floats of instanced environment pieces. Environment materials are meant to read these with
+// PerInstanceCustomData nodes, so color variation needs no material instance and keeps one draw per piece type.
+// No material in the project reads them yet; until one does, the values are written but have no visible effect.
+namespace EnvironmentCustomData
+{
+    enum Type : int32
+    {
+        TintR,
+        TintG,
+        TintB,
+        WindPhase,
+        Emission,
+        Count
+    };
+}
+
+// Color variation of a theme, written into the custom data of its pieces
+USTRUCT(BlueprintType)
+struct FEnvironmentThemeVariation
 {
-    Forest          UMETA(DisplayName = "Forest"),
-    Mountain        UMETA(DisplayName = "Mountain"),
-    Beach           UMETA(DisplayName = "Beach"),
-    Village         UMETA(DisplayName = "Village"),
-    Ruins           UMETA(DisplayName = "Ancient Ruins"),
-    Sky             UMETA(DisplayName = "Sky Islands"),
-    Cave            UMETA(DisplayName = "Cave"),
-    Desert          UMETA(DisplayName = "Desert")
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation")
+    FLinearColor Tint;
+
+    // Random brightness change per instance, as a fraction of the tint
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation")
+    float TintVariation;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation")
+    float Emission;
+
+    FEnvironmentThemeVariation()
+    {
+        Tint = FLinearColor::White;
+        TintVariation = 0.1f;
+        Emission = 0.0f;
+    }
 };
 
 USTRUCT(BlueprintType)
@@ -108,6 +136,10 @@ struct FEnvironmentChunkData
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chunk")
     float DifficultyLevel;
 
+    // Instance of each piece in its piece type's instanced component, INDEX_NONE when it is not instanced.
+    // Removed on unload, and shifted down when another chunk's instances are removed below them.
+    TArray<int32> InstanceIndices;
+
     FEnvironmentChunkData()
     {
         ChunkLocation = FVector::ZeroVector;
@@ -145,6 +177,9 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Environment")
     void UpdateEnvironmentAroundPlayer(FVector PlayerLocation, float LoadRadius = 3000.0f);
 
+    UFUNCTION(BlueprintPure, Category = "Environment")
+    EEnvironmentTheme GetThemeForLocation(FVector WorldLocation) const;
+
     // Procedural generation
     UFUNCTION(BlueprintCallable, Category = "Procedural")
     TArray<FTransform> GenerateProceduralLayout(FVector ChunkLocation, EEnvironmentTheme Theme, float DifficultyLevel);
@@ -168,7 +203,7 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Environment Pieces")
     void CreateInstancedMeshes();
 
-    // Material system integration
+    // Material system integration; rewrites the variation custom data of the theme's loaded chunks
     UFUNCTION(BlueprintCallable, Category = "Materials")
     void ApplyThemeMaterials(EEnvironmentTheme Theme);
 
@@ -182,6 +217,17 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Optimization")
     void SetLODDistances(float LOD1Distance, float LOD2Distance, float CullDistance);
 
+    // Called by the performance governor; InstanceScale thins out decorations in newly generated chunks
+    UFUNCTION(BlueprintCallable, Category = "Optimization")
+    void SetPerformanceBudget(float InstanceScale, int32 DrawCallBudget);
+
+    UFUNCTION(BlueprintPure, Category = "Optimization")
+    int32 GetInstanceCount() const;
+
+    // Memory accounting for budgets and soak reports (bytes)
+    int64 GetInstanceMemoryBytes() const;
+    int64 GetChunkDataMemoryBytes() const;
+
 protected:
     // Environment piece registry
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment Data")
@@ -191,6 +237,10 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Themes")
     TMap<EEnvironmentTheme, TArray<EEnvironmentPieceType>> ThemePieceSets;
 
+    // Tint, tint variation and emission per theme, read by the materials through per-instance custom data
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Themes")
+    TMap<EEnvironmentTheme, FEnvironmentThemeVariation> ThemeVariations;
+
     // Instanced mesh components for optimization
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Instancing")
     TMap<EEnvironmentPieceType, UInstancedStaticMeshComponent*> InstancedMeshComponents;
@@ -238,6 +288,9 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
     int32 MaxDrawCalls;
 
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Performance")
+    float InstanceBudgetScale;
+
 private:
     // Helper functions
     void InitializeEnvironmentPieces();
@@ -248,8 +301,21 @@ private:
     EEnvironmentPieceType SelectRandomPieceForTheme(EEnvironmentTheme Theme);
     FTransform GenerateRandomTransform(FVector BaseLocation, EEnvironmentPieceType PieceType);
     void ApplyMobileOptimizations();
+    
+    // Writes tint, wind phase and emission for every instanced piece of the chunk, marking each component dirty once
+    void WriteChunkCustomData(const FEnvironmentChunkData& ChunkData);
+    
+    // Reports instance counts and memory to STATGROUP_AnimeWorldRunner
+    void UpdateStats() const;
+    
+    // Tells the effects managers which theme's effects to preload
+    void NotifyThemeChanged(EEnvironmentTheme Theme);
 
     // Current player location for chunk streaming
     FVector LastPlayerLocation;
     float ChunkUpdateTimer;
+
+    // Theme of the chunk the player is in
+    EEnvironmentTheme PlayerTheme;
+    bool bHasPlayerTheme;
 };
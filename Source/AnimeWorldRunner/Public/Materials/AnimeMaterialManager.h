@@ -4,9 +4,16 @@
 #include "Components/ActorComponent.h"
 #include "Materials/MaterialInterface.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
 #include "Engine/Texture2D.h"
+#include "UObject/ObjectKey.h"
+#include "Materials/MaterialTweenSystem.h"
+#include "Materials/MaterialRegistry.h"
 #include "AnimeMaterialManager.generated.h"
 
+class UMeshComponent;
+
 UENUM(BlueprintType)
 enum class EAnimeMaterialType : uint8
 {
@@ -108,6 +115,87 @@ struct FAnimeMaterialSettings
     }
 };
 
+// Parents cooked for the lower quality tiers. Their static switches drop the outline and rim passes
+// and shorten the shadow ramp; High and Ultra use the base material itself.
+USTRUCT(BlueprintType)
+struct FAnimeMaterialQualityPermutations
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality")
+    UMaterialInterface* Low;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality")
+    UMaterialInterface* Medium;
+
+    FAnimeMaterialQualityPermutations()
+    {
+        Low = nullptr;
+        Medium = nullptr;
+    }
+};
+
+// What a dynamic material needs to be rebuilt for another quality tier
+USTRUCT()
+struct FAnimeMaterialTierState
+{
+    GENERATED_BODY()
+
+    // Material the instance was created from, before picking a quality permutation
+    UPROPERTY()
+    TWeakObjectPtr<UMaterialInterface> BaseMaterial;
+
+    // Settings values before quality scaling, so tier changes never compound
+    float OutlineThickness;
+    float RimIntensity;
+    float ShadowSmoothness;
+
+    // Mesh slots the material was applied to through the manager
+    TArray<TPair<TWeakObjectPtr<UMeshComponent>, int32>, TInlineAllocator<2>> MeshSlots;
+
+    FAnimeMaterialTierState()
+    {
+        OutlineThickness = 0.0f;
+        RimIntensity = 0.0f;
+        ShadowSmoothness = 0.0f;
+    }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAnimeMaterialReplaced, UMaterialInstanceDynamic*, OldMaterial, UMaterialInstanceDynamic*, NewMaterial);
+
+// Everything written into a shared material when it is created; equal keys share one MID.
+// Assets are held as object keys, so a key never keeps a pointer the garbage collector cannot see.
+struct FAnimeMaterialCacheKey
+{
+    EAnimeMaterialType MaterialType = EAnimeMaterialType::Character;
+    TObjectKey<UMaterialInterface> BaseMaterial;
+    TObjectKey<UTexture2D> BaseColorTexture;
+    TObjectKey<UTexture2D> NormalTexture;
+    TObjectKey<UTexture2D> PackedTexture;
+
+    // The settings' values only; the asset pointers are cleared in favour of the keys above
+    FAnimeMaterialSettings Settings;
+    TArray<TPair<FName, float>, TInlineAllocator<4>> ExtraScalars;
+    uint32 Hash = 0;
+
+    FAnimeMaterialCacheKey() = default;
+    FAnimeMaterialCacheKey(EAnimeMaterialType InMaterialType, const FAnimeMaterialSettings& InSettings, TArrayView<const TPair<FName, float>> InExtraScalars);
+
+    bool operator==(const FAnimeMaterialCacheKey& Other) const;
+    friend uint32 GetTypeHash(const FAnimeMaterialCacheKey& Key) { return Key.Hash; }
+};
+
+// Indices of the settings parameters in a dynamic material's parameter arrays. Every instance initializes
+// them in the same order, so the layout resolved for the first instance of a base material fits all of them.
+struct FAnimeMaterialParameterLayout
+{
+    static constexpr int32 NumScalars = 9;
+    static constexpr int32 NumVectors = 5;
+
+    int32 ScalarIndices[NumScalars];
+    int32 VectorIndices[NumVectors];
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class ANIMEWORLDRUNNER_API UAnimeMaterialManager : public UActorComponent
 {
@@ -122,35 +210,71 @@ protected:
 public:
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
-    // Material creation and management
+    // Keeps shared materials alive while they have users
+    static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+    // Material creation and management. Materials with equal settings are shared and reference counted, and
+    // the manager keeps a shared one alive until its last release; unique instances live as long as their user
+    // holds them. Ask for a unique instance to animate or edit one on its own, and release either kind when done.
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateAnimeMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings);
+    UMaterialInstanceDynamic* CreateAnimeMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings, bool bUniqueInstance = false);
 
+    // Records the mesh slot so a quality tier change can put the rebuilt material on it. Slots set with a plain
+    // SetMaterial (character customization items, environment pieces) are not rebound; their owners have to
+    // listen to OnMaterialReplaced or go through here.
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
     void ApplyMaterialToMesh(UMeshComponent* MeshComponent, UMaterialInstanceDynamic* Material, int32 MaterialIndex = 0);
 
+    // Unique instances only; shared ones are left unchanged, since other holders and the cache key depend on them
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
     void UpdateMaterialParameters(UMaterialInstanceDynamic* Material, const FAnimeMaterialSettings& Settings);
 
+    // Writes all settings scalars and vectors of one instance in one call: through its layout when the instance
+    // matches it, otherwise by name, which also records the layout for the base material. Does not check for
+    // shared instances; callers pass unique ones.
+    void WriteSettingsParameters(UMaterialInstanceDynamic* Material, const float* Scalars, const FLinearColor* Vectors);
+
+    // Drops one reference; the material stops receiving global updates and animations once nobody uses it
+    UFUNCTION(BlueprintCallable, Category = "Anime Materials")
+    void ReleaseMaterial(UMaterialInstanceDynamic* Material);
+
+    UFUNCTION(BlueprintPure, Category = "Anime Materials")
+    bool IsSharedMaterial(UMaterialInstanceDynamic* Material) const { return SharedMaterialRefs.Contains(GetCurrentMaterial(Material)); }
+
+    // Quality tier changes rebuild materials on another parent; this maps an instance handed out earlier to the live one
+    UFUNCTION(BlueprintPure, Category = "Anime Materials")
+    UMaterialInstanceDynamic* GetCurrentMaterial(UMaterialInstanceDynamic* Material) const;
+
+    // Broadcast for every material rebuilt by a quality tier change; meshes it was applied to are already updated
+    UPROPERTY(BlueprintAssignable, Category = "Anime Materials")
+    FOnAnimeMaterialReplaced OnMaterialReplaced;
+
     // Preset material configurations
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateCharacterMaterial(FLinearColor MainColor, FLinearColor ShadowColor);
+    UMaterialInstanceDynamic* CreateCharacterMaterial(FLinearColor MainColor, FLinearColor ShadowColor, bool bUniqueInstance = false);
 
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateHairMaterial(FLinearColor HairColor, float Shininess);
+    UMaterialInstanceDynamic* CreateHairMaterial(FLinearColor HairColor, float Shininess, bool bUniqueInstance = false);
 
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateClothingMaterial(FLinearColor ClothColor, UTexture2D* Pattern = nullptr);
+    UMaterialInstanceDynamic* CreateClothingMaterial(FLinearColor ClothColor, UTexture2D* Pattern = nullptr, bool bUniqueInstance = false);
 
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateEnvironmentMaterial(UTexture2D* BaseTexture, float TileScale = 1.0f);
+    UMaterialInstanceDynamic* CreateEnvironmentMaterial(UTexture2D* BaseTexture, float TileScale = 1.0f, bool bUniqueInstance = false);
 
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    UMaterialInstanceDynamic* CreateWaterMaterial(FLinearColor WaterColor, float WaveSpeed = 1.0f);
+    UMaterialInstanceDynamic* CreateWaterMaterial(FLinearColor WaterColor, float WaveSpeed = 1.0f, bool bUniqueInstance = false);
 
-    // Material animation and effects
+    // Material animation and effects; unique instances only, like UpdateMaterialParameters
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
-    void StartMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration);
+    void StartMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration, EMaterialTweenEasing Easing = EMaterialTweenEasing::Linear);
+
+    // Stops one parameter animation, or all of the material's animations when ParameterName is None
+    UFUNCTION(BlueprintCallable, Category = "Anime Materials")
+    void StopMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName = NAME_None);
+
+    UFUNCTION(BlueprintPure, Category = "Anime Materials")
+    int32 GetActiveAnimationCount() const { return MaterialTweens.Num(); }
 
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
     void SetGlobalLightDirection(FVector LightDirection);
@@ -165,11 +289,51 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Anime Materials")
     void SetQualityLevel(int32 QualityLevel);
 
+    // Registers the cheaper parents of a base material; takes effect for materials created or swapped afterwards
+    UFUNCTION(BlueprintCallable, Category = "Anime Materials")
+    void SetQualityPermutations(UMaterialInterface* BaseMaterial, const FAnimeMaterialQualityPermutations& Permutations);
+
+    // Global parameter updates per second, 0 updates every frame (set by the performance governor)
+    UFUNCTION(BlueprintCallable, Category = "Anime Materials")
+    void SetGlobalUpdateRate(float UpdatesPerSecond);
+
+    // Memory of the dynamic material instances this manager created (bytes)
+    int64 GetMaterialMemoryBytes() const;
+
+    // Writes GlobalTime, and the light direction and time of day when they changed; called from tick
+    void UpdateGlobalParameters();
+
+    int32 GetActiveMaterialCount() const { return MaterialRegistry.Num(); }
+    int32 GetQualityLevel() const { return CurrentQualityLevel; }
+    const TMap<UMaterialInterface*, FAnimeMaterialQualityPermutations>& GetQualityPermutations() const { return QualityPermutations; }
+
+    // Holders of all materials; above GetActiveMaterialCount when the cache shares instances
+    int32 GetMaterialUserCount() const;
+
+    int32 GetNumCacheHits() const { return NumCacheHits; }
+    int32 GetNumCacheMisses() const { return NumCacheMisses; }
+    int32 GetSharedMaterialCount() const { return SharedMaterials.Num(); }
+    int32 GetNumPrunedMaterials() const { return NumPrunedMaterials; }
+
+    // Per-material entries besides the registry (tier state, shared references, redirects); back to baseline once materials are gone
+    int32 GetTrackedMaterialCount() const { return MaterialStates.Num() + SharedMaterialRefs.Num() + ReplacedMaterials.Num() + ReplacedMaterialSources.Num(); }
+
+    // Memory of the registry and the per-material bookkeeping (bytes)
+    int64 GetRegistryMemoryBytes() const;
+
+    // Forgets collected materials among the next MaxSlots registry slots; tick prunes a few every frame
+    int32 PruneMaterials(int32 MaxSlots);
+    bool HasParameterCollection() const { return GlobalParameterInstance != nullptr; }
+
 protected:
     // Material templates
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Templates")
     TMap<EAnimeMaterialType, UMaterialInterface*> MaterialTemplates;
 
+    // Low and Medium tier parents per base material; materials without an entry keep their base on every tier
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Templates")
+    TMap<UMaterialInterface*, FAnimeMaterialQualityPermutations> QualityPermutations;
+
     // Global material parameters
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Global Settings")
     FVector GlobalLightDirection;
@@ -183,16 +347,72 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Global Settings")
     int32 CurrentQualityLevel;
 
-    // Active materials for global updates
-    UPROPERTY()
-    TArray<UMaterialInstanceDynamic*> ActiveMaterials;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Global Settings")
+    float GlobalUpdateRate;
 
-    // Animation system
-    UPROPERTY()
-    TMap<UMaterialInstanceDynamic*, FTimerHandle> MaterialAnimationTimers;
+    // Holds GlobalTime, GlobalLightDirection and TimeOfDay for every anime material; without it each MID is written
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Global Settings")
+    UMaterialParameterCollection* GlobalParameterCollection;
+
+    UPROPERTY(Transient)
+    UMaterialParameterCollectionInstance* GlobalParameterInstance;
+
+    // Active materials for global updates. Weak, so materials of destroyed meshes are collected and pruned
+    FMaterialRegistry MaterialRegistry;
+
+    TMap<TObjectKey<UMaterialInstanceDynamic>, FAnimeMaterialTierState> MaterialStates;
+
+    // Instances rebuilt by a tier change and the instance that replaced them
+    TMap<TObjectKey<UMaterialInstanceDynamic>, TWeakObjectPtr<UMaterialInstanceDynamic>> ReplacedMaterials;
+
+    // The old instances redirected to each live one, so its redirects go with it
+    TMap<TObjectKey<UMaterialInstanceDynamic>, TArray<TObjectKey<UMaterialInstanceDynamic>, TInlineAllocator<1>>> ReplacedMaterialSources;
+
+    // Settings parameter indices per base material
+    TMap<TObjectKey<UMaterialInterface>, FAnimeMaterialParameterLayout> ParameterLayouts;
+
+    // Parameter animations, advanced once per tick
+    FMaterialTweenSystem MaterialTweens;
+
+    // Shared materials by creation key, and the key and user count of each shared material. The material is
+    // reported to the garbage collector from AddReferencedObjects until the count drops to zero.
+    struct FSharedMaterialRef
+    {
+        FAnimeMaterialCacheKey Key;
+        UMaterialInstanceDynamic* Material = nullptr;
+        int32 RefCount = 0;
+    };
+
+    TMap<FAnimeMaterialCacheKey, TWeakObjectPtr<UMaterialInstanceDynamic>> SharedMaterials;
+    TMap<TObjectKey<UMaterialInstanceDynamic>, FSharedMaterialRef> SharedMaterialRefs;
+
+    int32 NumCacheHits;
+    int32 NumCacheMisses;
+    int32 NumPrunedMaterials;
 
 private:
+    UMaterialInstanceDynamic* AcquireMaterial(EAnimeMaterialType MaterialType, const FAnimeMaterialSettings& Settings, TArrayView<const TPair<FName, float>> ExtraScalars, bool bUniqueInstance);
     void InitializeMaterialTemplates();
-    void UpdateGlobalParameters();
-    void UpdateMaterialAnimation(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration, float ElapsedTime);
+    void InitializeSettingsParameters(UMaterialInstanceDynamic* Material, const float* Scalars, const FLinearColor* Vectors);
+    const FAnimeMaterialParameterLayout* FindParameterLayout(const UMaterialInstanceDynamic* Material) const;
+    UMaterialInterface* GetQualityParent(UMaterialInterface* BaseMaterial) const;
+    void ScaleForQuality(float (&Scalars)[FAnimeMaterialParameterLayout::NumScalars]) const;
+    void ApplyQualityScalars(UMaterialInstanceDynamic* Material, const FAnimeMaterialTierState& State);
+
+    // Rebuilds every material whose parent does not match the current tier, in one pass
+    void SwapQualityPermutations();
+
+    // Drops the tier state, shared reference and redirect of a material that no longer exists
+    void ForgetMaterial(const TObjectKey<UMaterialInstanceDynamic>& MaterialKey);
+
+    // Drops the redirects of older instances to a material that is going away
+    void ForgetRedirectsTo(const TObjectKey<UMaterialInstanceDynamic>& MaterialKey);
+
+    float GlobalUpdateTimer;
+
+    // Set when the light direction or time of day changed since they were last written
+    bool bGlobalLightingDirty;
+
+    // Path the last update wrote through; the other path holds values from before the switch
+    bool bUsingParameterCollection;
 };
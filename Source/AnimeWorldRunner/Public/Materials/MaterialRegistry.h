@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UMaterialInstanceDynamic;
+
+// Refers to one registry slot; goes stale when the material is removed, pruned or replaced
+struct FMaterialHandle
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    bool IsSet() const { return Index != INDEX_NONE; }
+    bool operator==(const FMaterialHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+};
+
+/**
+ * Weakly referenced set of dynamic materials.
+ *
+ * Materials live in slots that are reused through a free list. Every add gets a new
+ * generation, so a handle to a removed material never resolves to the one reusing its
+ * slot. The registry never keeps a material alive: once nothing else references it,
+ * the garbage collector frees it and Prune reclaims the slot, checking a few slots per
+ * call so the cost is spread over frames. Prune also frees the arrays once the registry
+ * is empty.
+ */
+class ANIMEWORLDRUNNER_API FMaterialRegistry
+{
+public:
+    FMaterialRegistry();
+
+    FMaterialHandle Add(UMaterialInstanceDynamic* Material);
+    bool Remove(FMaterialHandle Handle);
+
+    // Puts another material in the handle's slot and returns its new handle
+    FMaterialHandle Replace(FMaterialHandle Handle, UMaterialInstanceDynamic* NewMaterial);
+
+    UMaterialInstanceDynamic* Get(FMaterialHandle Handle) const;
+    FMaterialHandle Find(const UMaterialInstanceDynamic* Material) const;
+
+    // Frees the slots of collected materials among the next MaxSlots slots and appends their keys to OutPruned
+    int32 Prune(int32 MaxSlots, TArray<TObjectKey<UMaterialInstanceDynamic>>& OutPruned);
+
+    // Calls Func for every registered material that is still alive
+    template<typename FuncType>
+    void ForEach(FuncType Func) const
+    {
+        for (const FSlot& Slot : Slots)
+        {
+            if (Slot.bUsed)
+            {
+                if (UMaterialInstanceDynamic* Material = Slot.Material.Get())
+                {
+                    Func(Material);
+                }
+            }
+        }
+    }
+
+    int32 Num() const { return SlotByMaterial.Num(); }
+    int32 GetCapacity() const { return Slots.Num(); }
+    int64 GetAllocatedSize() const;
+
+private:
+    struct FSlot
+    {
+        TWeakObjectPtr<UMaterialInstanceDynamic> Material;
+        TObjectKey<UMaterialInstanceDynamic> Key;
+        uint32 Generation = 0;
+        bool bUsed = false;
+    };
+
+    void FreeSlot(int32 Index);
+
+    TArray<FSlot> Slots;
+    TArray<int32> FreeSlots;
+    TMap<TObjectKey<UMaterialInstanceDynamic>, int32> SlotByMaterial;
+
+    // Where the next Prune continues
+    int32 PruneCursor;
+
+    // Generation of the last added material, shared by all slots
+    uint32 NextGeneration;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialTweenSystem.generated.h"
+
+class UMaterialInstanceDynamic;
+
+UENUM(BlueprintType)
+enum class EMaterialTweenEasing : uint8
+{
+    Linear          UMETA(DisplayName = "Linear"),
+    EaseIn          UMETA(DisplayName = "Ease In"),
+    EaseOut         UMETA(DisplayName = "Ease Out"),
+    EaseInOut       UMETA(DisplayName = "Ease In Out")
+};
+
+/**
+ * Scalar material parameter animations, stored as parallel arrays.
+ *
+ * Tick advances every tween with the real frame time in one pass over the values,
+ * then writes the results through parameter indices resolved when the tween started.
+ * A value equal to the one last written is not written again, so a finished tween
+ * writes its end value once and a held easing writes nothing. New tweens are appended
+ * and the arrays are sorted by material once per tick when needed, so the writes to
+ * one material are consecutive. One material can animate any number of parameters at
+ * once. Materials are held weakly; tweens of destroyed materials are dropped on the
+ * next tick.
+ */
+class ANIMEWORLDRUNNER_API FMaterialTweenSystem
+{
+public:
+    // Replaces a tween already running on the same material parameter
+    void Start(UMaterialInstanceDynamic* Material, FName ParameterName, float StartValue, float EndValue, float Duration, EMaterialTweenEasing Easing);
+
+    // Stops the tween of one parameter, or every tween of the material with NAME_None
+    void Stop(const UMaterialInstanceDynamic* Material, FName ParameterName = NAME_None);
+    void StopAll();
+
+    // Moves the tweens of a material to the instance that replaced it
+    void Replace(const UMaterialInstanceDynamic* OldMaterial, UMaterialInstanceDynamic* NewMaterial);
+
+    void Tick(float DeltaTime);
+
+    int32 Num() const { return Materials.Num(); }
+    bool IsAnimating(const UMaterialInstanceDynamic* Material, FName ParameterName) const;
+    int64 GetAllocatedSize() const;
+
+    static float Ease(EMaterialTweenEasing Easing, float Alpha);
+
+private:
+    int32 Find(const UMaterialInstanceDynamic* Material, FName ParameterName) const;
+    float Evaluate(int32 Index) const;
+
+    // Groups the tweens of each material together, keeping their start order
+    void SortByMaterial();
+
+    TArray<TWeakObjectPtr<UMaterialInstanceDynamic>> Materials;
+    TArray<FName> ParameterNames;
+    TArray<int32> ParameterIndices;
+    TArray<float> StartValues;
+    TArray<float> EndValues;
+    TArray<float> ElapsedTimes;
+    TArray<float> InverseDurations;
+    TArray<EMaterialTweenEasing> Easings;
+    TArray<float> WrittenValues;
+
+    // Scratch for the values computed in a tick, kept to avoid reallocating
+    TArray<float> CurrentValues;
+    TArray<int32> SortOrder;
+
+    // Set when a tween was appended after another material's tweens
+    bool bNeedsSort = false;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// `stat AnimeWorldRunner` in development builds
+DECLARE_STATS_GROUP(TEXT("AnimeWorldRunner"), STATGROUP_AnimeWorldRunner, STATCAT_Advanced);
+
+// Environment
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Environment Tick"), STAT_AWR_EnvironmentTick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Generate Procedural Layout"), STAT_AWR_GenerateLayout, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Environment Chunk"), STAT_AWR_LoadChunk, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Character and animation
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_AWR_CharacterTick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Anim Instance Update"), STAT_AWR_AnimUpdate, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Effects
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Effects Tick"), STAT_AWR_EffectsTick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Play Effect"), STAT_AWR_PlayEffect, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Materials
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Materials Tick"), STAT_AWR_MaterialsTick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Global Material Parameters"), STAT_AWR_UpdateGlobalParameters, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Anime Material"), STAT_AWR_CreateMaterial, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Gameplay
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UI Tick"), STAT_AWR_UITick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show/Hide UI"), STAT_AWR_ShowHideUI, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Game Mode Tick"), STAT_AWR_GameModeTick, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Inventory"), STAT_AWR_Inventory, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save/Load Game"), STAT_AWR_SaveGame, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Live object counts; each owner adds its current count every tick, so several owners sum up
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("ISM Instances"), STAT_AWR_ISMInstances, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Particle Components"), STAT_AWR_ActiveParticleComponents, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Audio Components"), STAT_AWR_ActiveAudioComponents, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active MIDs"), STAT_AWR_ActiveMIDs, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Material Tweens"), STAT_AWR_MaterialTweens, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pruned MIDs"), STAT_AWR_PrunedMIDs, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Material Registry"), STAT_AWR_MaterialRegistryMemory, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Effects At Full Significance"), STAT_AWR_EffectsFull, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Effects At Reduced Significance"), STAT_AWR_EffectsReduced, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Effects Suppressed"), STAT_AWR_EffectsSuppressed, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Burst Spawns"), STAT_AWR_BurstSpawns, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Virtual Sound Voices"), STAT_AWR_VirtualSoundVoices, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Pools have no tick, so these are kept up to date on create/acquire/release
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Actors"), STAT_AWR_PooledActors, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Actors In Use"), STAT_AWR_PooledActorsInUse, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Effect Components"), STAT_AWR_PooledEffectComponents, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Effect Components Created"), STAT_AWR_EffectComponentsCreated, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Memory
+DECLARE_MEMORY_STAT_EXTERN(TEXT("ISM Instance Data"), STAT_AWR_ISMInstanceMemory, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Chunk Layout Data"), STAT_AWR_ChunkLayoutMemory, STATGROUP_AnimeWorldRunner, ANIMEWORLDRUNNER_API);
+
+// Insights channels; enable with -trace=cpu,AWREnvironment,AWRCharacter,... to see our scopes
+UE_TRACE_CHANNEL_EXTERN(AWREnvironmentChannel, ANIMEWORLDRUNNER_API);
+UE_TRACE_CHANNEL_EXTERN(AWRCharacterChannel, ANIMEWORLDRUNNER_API);
+UE_TRACE_CHANNEL_EXTERN(AWREffectsChannel, ANIMEWORLDRUNNER_API);
+UE_TRACE_CHANNEL_EXTERN(AWRMaterialsChannel, ANIMEWORLDRUNNER_API);
+UE_TRACE_CHANNEL_EXTERN(AWRGameplayChannel, ANIMEWORLDRUNNER_API);
+
+/**
+ * Cycle counter plus a named Insights scope on one of our channels. The stat is
+ * compiled out with STATS=0, the trace scope stays in Test builds for field captures.
+ */
+#define AWR_SCOPE_CYCLE_COUNTER(Stat, Channel, Name) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, Channel)
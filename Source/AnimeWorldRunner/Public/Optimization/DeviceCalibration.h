@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "DeviceCalibration.generated.h"
+
+USTRUCT(BlueprintType)
+struct FDeviceCalibrationResult
+{
+    GENERATED_BODY()
+
+    // Kernel throughput relative to the reference rates in [AnimeWorldRunner.DeviceCalibration] (1.0 = reference device)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    float TransformScore;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    float InstanceBatchScore;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    float AnimationScore;
+
+    // Geometric mean of the kernel scores
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    float CombinedScore;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    float CalibrationTimeMs;
+
+    // App version and kernel revision the result was measured with
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    FString AppVersion;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    int32 KernelVersion;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    bool bIsValid;
+
+    FDeviceCalibrationResult()
+    {
+        TransformScore = 0.0f;
+        InstanceBatchScore = 0.0f;
+        AnimationScore = 0.0f;
+        CombinedScore = 0.0f;
+        CalibrationTimeMs = 0.0f;
+        KernelVersion = 0;
+        bIsValid = false;
+    }
+};
+
+UCLASS()
+class ANIMEWORLDRUNNER_API UDeviceCalibrationSaveGame : public USaveGame
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(VisibleAnywhere, Category = "Calibration")
+    FDeviceCalibrationResult Result;
+};
+
+/**
+ * One calibration measured a slice at a time, so the benchmark can be spread over
+ * frames instead of stalling the game thread for the whole budget.
+ */
+class ANIMEWORLDRUNNER_API FDeviceCalibrationRun
+{
+public:
+    explicit FDeviceCalibrationRun(float BudgetMs = 300.0f);
+    ~FDeviceCalibrationRun();
+
+    // Measures for up to MaxSliceMs; returns true once every kernel has had its share of the budget
+    bool Step(float MaxSliceMs);
+
+    bool IsDone() const { return Result.bIsValid; }
+    const FDeviceCalibrationResult& GetResult() const { return Result; }
+
+private:
+    static const int32 NumKernels = 3;
+
+    struct FKernels;
+    TUniquePtr<FKernels> Kernels;
+
+    // Measuring time per kernel
+    double KernelSeconds;
+
+    int32 CurrentKernel;
+    int32 KernelBatches[NumKernels];
+    double KernelElapsed[NumKernels];
+    double MeasuredSeconds;
+
+    FDeviceCalibrationResult Result;
+};
+
+/**
+ * Short CPU micro-benchmark standing in for the game's hot paths: procedural
+ * transform generation, instanced mesh batch building and animation update math.
+ * Results are cached in their own save slot and re-measured after an app update.
+ */
+class ANIMEWORLDRUNNER_API FDeviceCalibration
+{
+public:
+    // Runs all kernels within roughly BudgetMs, blocking until done; use FDeviceCalibrationRun to spread it over frames
+    static FDeviceCalibrationResult Run(float BudgetMs = 300.0f);
+
+    // Returns the cached result if it matches the current build, running and saving a new one otherwise
+    static FDeviceCalibrationResult GetOrRun(float BudgetMs = 300.0f);
+
+    // Cached result only, never runs the benchmark (invalid if none or out of date)
+    static const FDeviceCalibrationResult& GetCached();
+
+    static bool SaveResult(const FDeviceCalibrationResult& Result);
+
+    // 0 = low, 1 = mid, 2 = high end, -1 when no calibration is available
+    static int32 GetPerformanceTier(const FDeviceCalibrationResult& Result);
+
+    static FString GetCurrentAppVersion();
+
+    static const TCHAR* SaveSlotName;
+
+    // Bump when a kernel changes so old scores are measured again
+    static const int32 CurrentKernelVersion;
+
+private:
+    static FDeviceCalibrationResult& AccessCache();
+    static bool IsUpToDate(const FDeviceCalibrationResult& Result);
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct ANIMEWORLDRUNNER_API FDynamicResolutionControllerSettings
+{
+    // Frame time the controller steers towards (milliseconds)
+    float TargetFrameTimeMs;
+
+    float MinScale;
+    float MaxScale;
+
+    // Time constant of the exponential frame time smoothing (seconds)
+    float SmoothingTimeSeconds;
+
+    // PI gains, in scale units per unit of relative frame time error
+    float ProportionalGain;
+    float IntegralGain;
+
+    // Relative error below which the controller holds its output
+    float Deadband;
+
+    // Maximum change of the continuous scale per second
+    float MaxScaleRatePerSecond;
+
+    // Scale is applied in steps of this size, once the continuous scale is three quarters of a step
+    // away; rounding alone would switch at half a step, so this leaves a quarter step of hysteresis
+    float QuantizationStep;
+
+    // Extrapolate the smoothed frame time trend this far ahead (0 disables prediction)
+    float PredictionHorizonSeconds;
+
+    FDynamicResolutionControllerSettings()
+    {
+        TargetFrameTimeMs = 16.67f;
+        MinScale = 0.5f;
+        MaxScale = 1.0f;
+        SmoothingTimeSeconds = 0.25f;
+        ProportionalGain = 0.4f;
+        IntegralGain = 0.8f;
+        Deadband = 0.05f;
+        MaxScaleRatePerSecond = 0.25f;
+        QuantizationStep = 0.05f;
+        PredictionHorizonSeconds = 0.1f;
+    }
+};
+
+struct ANIMEWORLDRUNNER_API FDynamicResolutionSimulationReport
+{
+    int32 NumFrames = 0;
+    float DurationSeconds = 0.0f;
+
+    // Time after which the smoothed frame time stays within twice the deadband of the target, or
+    // only misses it with the scale pinned at a limit, and the applied scale stops changing
+    float SettlingTimeSeconds = 0.0f;
+    bool bSettled = false;
+
+    // Largest excursion past the target after the first crossing, in percent of the target
+    float OvershootPercent = 0.0f;
+
+    int32 CVarWrites = 0;
+    float FinalScale = 1.0f;
+    float MinAppliedScale = 1.0f;
+    float MaxAppliedScale = 1.0f;
+    float AverageFrameTimeMs = 0.0f;
+};
+
+/**
+ * PI controller driving the screen percentage from smoothed frame time.
+ *
+ * Works purely on numbers so it can be exercised without a renderer; the caller
+ * only writes the CVar when Update() reports that the quantized scale moved.
+ */
+class ANIMEWORLDRUNNER_API FDynamicResolutionController
+{
+public:
+    FDynamicResolutionController();
+
+    void Configure(const FDynamicResolutionControllerSettings& InSettings);
+    const FDynamicResolutionControllerSettings& GetSettings() const { return Settings; }
+
+    void Reset(float InitialScale);
+
+    // Feeds one frame; returns true when the quantized scale changed and must be applied
+    bool Update(float FrameTimeMs, float DeltaSeconds);
+
+    float GetAppliedScale() const { return AppliedScale; }
+    float GetContinuousScale() const { return ContinuousScale; }
+    float GetSmoothedFrameTime() const { return SmoothedFrameTimeMs; }
+    float GetPredictedFrameTime() const { return PredictedFrameTimeMs; }
+
+    /**
+     * Runs the controller against a frame time trace recorded at full resolution.
+     * The simulated frame time scales with pixel count for the GPU bound share of the frame.
+     */
+    static FDynamicResolutionSimulationReport Simulate(const FDynamicResolutionControllerSettings& InSettings, const TArray<float>& FrameTimesMs, float GPUBoundFraction = 0.7f);
+
+private:
+    FDynamicResolutionControllerSettings Settings;
+
+    bool bHasSample;
+    float SmoothedFrameTimeMs;
+    float FrameTimeTrend;
+    float PredictedFrameTimeMs;
+    float PreviousError;
+
+    float ContinuousScale;
+    float AppliedScale;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Sliding window of frame times (in milliseconds).
+ *
+ * Samples live in a fixed ring buffer with a running sum, a streaming histogram
+ * for percentiles and a monotonic queue for the window maximum, so adding a sample
+ * and querying the window both cost the same regardless of history length.
+ */
+class ANIMEWORLDRUNNER_API FFrameTimeStats
+{
+public:
+    // Number of frames kept in the window (~2 seconds at 60 FPS)
+    static constexpr int32 WindowSize = 120;
+
+    // Histogram resolution: 0.25 ms buckets covering 0-64 ms, plus one overflow bucket
+    static constexpr int32 NumBuckets = 256;
+    static constexpr float BucketWidthMs = 0.25f;
+
+    FFrameTimeStats();
+
+    void Reset();
+    void AddSample(float FrameTimeMs);
+
+    // Frames slower than this count as hitches
+    void SetHitchThreshold(float ThresholdMs);
+    float GetHitchThreshold() const { return HitchThresholdMs; }
+
+    int32 Num() const { return Count; }
+    float GetLatest() const;
+    float GetAverage() const;
+    float GetMax() const;
+
+    // Percentile in [0, 1], interpolated inside the histogram bucket
+    float GetPercentile(float Percentile) const;
+
+    // Computes the three percentiles used by FPerformanceMetrics in a single histogram pass
+    void GetPercentiles(float& OutP50, float& OutP95, float& OutP99) const;
+
+    int32 GetWindowHitchCount() const { return WindowHitchCount; }
+    int32 GetTotalHitchCount() const { return TotalHitchCount; }
+
+private:
+    static int32 GetBucketIndex(float FrameTimeMs);
+    float GetBucketValue(int32 BucketIndex, int32 RankInBucket, int32 BucketCount) const;
+
+    float Samples[WindowSize];
+    bool HitchFlags[WindowSize];
+    uint16 Histogram[NumBuckets + 1];
+
+    // Monotonic (decreasing) queue of sample sequence numbers for the window maximum
+    int64 MaxQueue[WindowSize];
+    int32 MaxQueueHead;
+    int32 MaxQueueNum;
+
+    int64 NextSequence;
+    int32 Count;
+    double RunningSum;
+
+    float HitchThresholdMs;
+    int32 WindowHitchCount;
+    int32 TotalHitchCount;
+};
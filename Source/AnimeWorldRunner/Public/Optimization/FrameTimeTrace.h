@@ -0,0 +1,13 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Frame time traces recorded on device, replayed through the dynamic resolution
+ * controller and the performance governor.
+ */
+struct ANIMEWORLDRUNNER_API FFrameTimeTrace
+{
+    // Reads a text file with one frame time (ms) per line or comma separated; relative paths are under Saved/
+    static bool LoadFromFile(const FString& FileName, TArray<float>& OutFrameTimesMs);
+};
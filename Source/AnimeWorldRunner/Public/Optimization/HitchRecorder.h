@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Compiled in everywhere except Shipping; Test builds keep it so field testers can capture hitches
+#ifndef AWR_WITH_HITCH_RECORDER
+#define AWR_WITH_HITCH_RECORDER !UE_BUILD_SHIPPING
+#endif
+
+// Game systems timed per frame; timings are exclusive, so time in a nested scope only counts for the inner one
+enum class EHitchScope : uint8
+{
+    Environment,
+    GameMode,
+    Effects,
+    Materials,
+    UI,
+    Inventory,
+    Save,
+    Count
+};
+
+/**
+ * Keeps the last few frames of per-system timings and writes the spike frame plus
+ * its neighbours to Saved/Profiling/Hitches as CSV when a frame exceeds the threshold.
+ *
+ * Recording is two cycle counter reads per scope into a fixed ring; the CSV is
+ * written on a background thread.
+ */
+class ANIMEWORLDRUNNER_API FHitchRecorder
+{
+public:
+    static FHitchRecorder& Get();
+
+    // Scopes must nest; EndScope records the cycles minus those of scopes that ended inside it
+    void BeginScope();
+    void EndScope(EHitchScope Scope, uint64 Cycles);
+
+    // Closes the current frame; called from FCoreDelegates::OnEndFrame
+    void EndFrame();
+
+    // Unbinds from the core delegates; called from FCoreDelegates::OnPreExit
+    void Shutdown();
+
+    static const TCHAR* GetScopeName(EHitchScope Scope);
+
+private:
+    FHitchRecorder();
+
+    // Frames kept in the ring; must cover FramesBeforeHitch + 1 + FramesAfterHitch
+    static constexpr int32 NumFrames = 32;
+    static constexpr int32 FramesBeforeHitch = 8;
+    static constexpr int32 FramesAfterHitch = 4;
+
+    // Deeper scopes are still timed, but their time is not taken out of their parents
+    static constexpr int32 MaxScopeDepth = 16;
+
+    struct FFrameRecord
+    {
+        uint64 FrameNumber;
+        float FrameTimeMs;
+        uint64 ScopeCycles[(int32)EHitchScope::Count];
+        uint16 ScopeCalls[(int32)EHitchScope::Count];
+    };
+
+    void WriteHitchReport(int32 HitchFrameIndex);
+
+    FFrameRecord Frames[NumFrames];
+    int32 CurrentFrame;
+    int32 RecordedFrames;
+    uint64 LastEndFrameCycles;
+
+    // Cycles of finished child scopes, per open scope
+    uint64 ChildCycles[MaxScopeDepth];
+    int32 ScopeDepth;
+
+    FDelegateHandle EndFrameHandle;
+    FDelegateHandle PreExitHandle;
+
+    // Ring index of a detected hitch waiting for its trailing frames, or INDEX_NONE
+    int32 PendingHitchFrame;
+    int32 FramesUntilReport;
+
+    double LastReportTime;
+    int32 ReportsWritten;
+};
+
+#if AWR_WITH_HITCH_RECORDER
+
+class ANIMEWORLDRUNNER_API FHitchScopeTimer
+{
+public:
+    explicit FHitchScopeTimer(EHitchScope InScope)
+        : Scope(InScope)
+    {
+        FHitchRecorder::Get().BeginScope();
+        StartCycles = FPlatformTime::Cycles64();
+    }
+
+    ~FHitchScopeTimer()
+    {
+        FHitchRecorder::Get().EndScope(Scope, FPlatformTime::Cycles64() - StartCycles);
+    }
+
+private:
+    EHitchScope Scope;
+    uint64 StartCycles;
+};
+
+#define AWR_HITCH_SCOPE(Scope) FHitchScopeTimer ANONYMOUS_VARIABLE(HitchScope_)(EHitchScope::Scope)
+
+#else
+
+#define AWR_HITCH_SCOPE(Scope)
+
+#endif
@@ -4,6 +4,15 @@
 #include "Components/ActorComponent.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Materials/MaterialParameterCollection.h"
+#include "Engine/DataTable.h"
+#include "Optimization/FrameTimeStats.h"
+#include "Optimization/DynamicResolutionController.h"
+#include "Optimization/QualityProfile.h"
+#include "Optimization/PerformanceGovernor.h"
+#include "Optimization/DeviceCalibration.h"
+#include "Optimization/PerformanceMetricsProvider.h"
+#include "Optimization/SubsystemMemoryTracker.h"
+#include "Optimization/TelemetryRecorder.h"
 #include "MobileOptimizationManager.generated.h"
 
 UENUM(BlueprintType)
@@ -92,6 +101,14 @@ struct FMobileOptimizationSettings
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
     bool bEnableInstancing;
 
+    // Particle effects playing at once; the performance governor can lower this further
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+    int32 MaxActiveEffects;
+
+    // Memory Budgets
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    FSubsystemMemoryBudgets MemoryBudgets;
+
     FMobileOptimizationSettings()
     {
         QualityLevel = EMobileQualityLevel::Medium;
@@ -117,6 +134,31 @@ struct FMobileOptimizationSettings
         MaxTriangles = 100000;
         bEnableOcclusion = true;
         bEnableInstancing = true;
+        MaxActiveEffects = 16;
+    }
+};
+
+// Maps a device calibration score to a quality profile
+USTRUCT(BlueprintType)
+struct FMobileCalibrationTierRow : public FTableRowBase
+{
+    GENERATED_BODY()
+
+    // Lowest combined calibration score that selects this row
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    float MinScore;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    EMobileQualityLevel QualityLevel;
+
+    // Optional entry in DeviceProfiles to apply instead of only the quality level
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    FString DeviceProfile;
+
+    FMobileCalibrationTierRow()
+    {
+        MinScore = 0.0f;
+        QualityLevel = EMobileQualityLevel::Medium;
     }
 };
 
@@ -134,6 +176,33 @@ struct FPerformanceMetrics
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
     float FrameTime;
 
+    // Frame time distribution over the sliding window (milliseconds)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float AverageFrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float P50FrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float P95FrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float P99FrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float MaxFrameTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float OnePercentLowFPS;
+
+    // Hitches inside the sliding window and since monitoring started
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    int32 HitchCount;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    int32 TotalHitchCount;
+
+    // Render counters from the active IPerformanceMetricsProvider
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
     int32 DrawCalls;
 
@@ -143,9 +212,16 @@ struct FPerformanceMetrics
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
     float GPUTime;
 
+    // Game thread time (milliseconds)
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
     float CPUTime;
 
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float RenderThreadTime;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    EPerformanceMetricsSource MetricsSource;
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
     float MemoryUsage;
 
@@ -157,10 +233,20 @@ struct FPerformanceMetrics
         CurrentFPS = 60.0f;
         AverageFPS = 60.0f;
         FrameTime = 16.67f;
+        AverageFrameTime = 16.67f;
+        P50FrameTime = 16.67f;
+        P95FrameTime = 16.67f;
+        P99FrameTime = 16.67f;
+        MaxFrameTime = 16.67f;
+        OnePercentLowFPS = 60.0f;
+        HitchCount = 0;
+        TotalHitchCount = 0;
         DrawCalls = 0;
         Triangles = 0;
         GPUTime = 0.0f;
         CPUTime = 0.0f;
+        RenderThreadTime = 0.0f;
+        MetricsSource = EPerformanceMetricsSource::None;
         MemoryUsage = 0.0f;
         CurrentResolutionScale = 1.0f;
     }
@@ -176,6 +262,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -236,6 +323,23 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
     void StopPerformanceMonitoring();
 
+    // Device Calibration: measures again over the next frames and re-detects the quality level when done
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    void RecalibrateDevice();
+
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    FDeviceCalibrationResult GetCalibrationResult() const { return CalibrationResult; }
+
+    // Performance Governor
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    void EnablePerformanceGovernor(bool bEnable);
+
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    int32 GetPerformanceBudgetLevel() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    void ApplyPerformanceBudgets();
+
     // Memory Management
     UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
     void OptimizeMemoryUsage();
@@ -246,6 +350,17 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
     float GetMemoryUsage();
 
+    // Last sampled memory of one subsystem (LLM tag when running with -llm)
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    float GetSubsystemMemoryMB(EMemoryBudgetCategory Category) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    bool IsSubsystemOverMemoryBudget(EMemoryBudgetCategory Category) const;
+
+    // Writes the per-subsystem memory history to Saved/Profiling/MemorySoak
+    UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
+    bool WriteMemorySoakReport();
+
     // Rendering Optimization
     UFUNCTION(BlueprintCallable, Category = "Mobile Optimization")
     void OptimizeRenderingSettings();
@@ -291,16 +406,78 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Dynamic Resolution")
     float CurrentResolutionScale;
 
+    // Maximum change of the resolution scale per second
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Resolution")
     float ResolutionAdjustmentSpeed;
 
+    // Relative frame time error the controller tolerates before reacting
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Resolution")
+    float ResolutionDeadband;
+
+    // Resolution scale is applied in steps of this size
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Resolution")
+    float ResolutionScaleStep;
+
+    // How far ahead the frame time trend is extrapolated (0 disables prediction)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Resolution")
+    float ResolutionPredictionHorizon;
+
+    FDynamicResolutionController ResolutionController;
+
+    // Device Calibration
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    bool bEnableCalibration;
+
+    // Measuring time of the benchmark, spread over frames (milliseconds)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    float CalibrationBudgetMs;
+
+    // Game thread time the benchmark may take per frame while it runs (milliseconds)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    float CalibrationSliceMs;
+
+    // Rows of FMobileCalibrationTierRow; built-in thresholds are used when unset
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration")
+    UDataTable* CalibrationTierTable;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Calibration")
+    FDeviceCalibrationResult CalibrationResult;
+
+    // Set while a calibration is measured from tick
+    TUniquePtr<FDeviceCalibrationRun> PendingCalibration;
+
+    // Quality is detected when the pending calibration finishes: startup on an unknown device, or a recalibration
+    bool bDetectAfterCalibration;
+
+    // The last tick measured a calibration slice, so the frame time it reports is not the game's
+    bool bCalibratedLastFrame;
+
+    // Performance Governor
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance Governor")
+    bool bEnablePerformanceGovernor;
+
+    FPerformanceGovernor PerformanceGovernor;
+
+    // Memory Budgets
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float MemorySampleInterval;
+
+    FSubsystemMemoryTracker MemoryTracker;
+    float MemorySampleTimer;
+
+    // Telemetry: one row per second in Saved/Telemetry, summarized per device with AWR.Telemetry.Summarize
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Telemetry")
+    bool bEnableTelemetry;
+
+    FTelemetryRecorder TelemetryRecorder;
+    float TelemetryTimer;
+
     // Material Parameter Collection for global optimization
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Materials")
     class UMaterialParameterCollection* OptimizationMPC;
 
     // Timers and tracking
-    UPROPERTY()
-    TArray<float> FPSHistory;
+    FFrameTimeStats FrameTimeStats;
 
     UPROPERTY()
     float PerformanceTimer;
@@ -308,15 +485,33 @@ protected:
     UPROPERTY()
     int32 FrameCounter;
 
+    // Resolves console variables once and only writes values that changed
+    FQualityProfileApplier ProfileApplier;
+
 private:
     // Helper functions
     void InitializeDeviceProfiles();
     void UpdatePerformanceMetrics(float DeltaTime);
-    void AdjustDynamicResolution();
-    void ApplyQualitySettings(EMobileQualityLevel QualityLevel);
+    float GetFrameBudgetMs() const;
+    void AdjustDynamicResolution(float DeltaTime);
+    void ConfigureResolutionController();
+    void ConfigurePerformanceGovernor();
+    void UpdateMemoryBudgets(float DeltaTime);
+    void RecordTelemetry(float DeltaTime);
+    static float GetEffectSignificanceScale(EMobileQualityLevel QualityLevel);
+    void ApplyQualitySettings(EMobileQualityLevel QualityLevel, FQualityProfile& Profile);
+    void SelectAutoDetectedSettings(FMobileOptimizationSettings& OutSettings);
+    EMobileQualityLevel ResolveAutoQualityLevel() const;
+    void EnsureDeviceCalibration();
+    // Returns true when a calibration slice was measured this frame
+    bool UpdateDeviceCalibration();
+    FMobileCalibrationTierRow SelectCalibrationTier(float Score) const;
     FString DetectDeviceModel();
-    void SetConsoleVariables();
-    void OptimizeForLowEnd();
-    void OptimizeForMidRange();
-    void OptimizeForHighEnd();
+    void SetConsoleVariables(FQualityProfile& Profile) const;
+    void AddTextureQuality(EMobileTextureQuality Quality, FQualityProfile& Profile) const;
+    void AddLODSettings(float Bias, float Distance, FQualityProfile& Profile) const;
+    void AddDynamicResolutionSettings(bool bEnable, FQualityProfile& Profile) const;
+    void OptimizeForLowEnd(FQualityProfile& Profile);
+    void OptimizeForMidRange(FQualityProfile& Profile);
+    void OptimizeForHighEnd(FQualityProfile& Profile);
 };
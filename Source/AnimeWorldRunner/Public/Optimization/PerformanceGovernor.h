@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Budgets owned by the governor, in the order they are given up when over budget
+enum class EGovernedBudget : uint8
+{
+    MaterialUpdateRate,
+    UIAnimationRate,
+    ConcurrentEffects,
+    EnvironmentInstances,
+    Count
+};
+
+struct ANIMEWORLDRUNNER_API FPerformanceBudgets
+{
+    // Global material parameter updates per second (0 updates every frame)
+    float MaterialUpdateRate = 0.0f;
+
+    // Continuous UI animation updates per second (0 updates every frame)
+    float UIAnimationRate = 0.0f;
+
+    int32 MaxConcurrentEffects = 16;
+    float EffectScale = 1.0f;
+
+    // Fraction of each piece's MaxInstances (and of MaxDrawCalls) the environment may use
+    float EnvironmentInstanceScale = 1.0f;
+};
+
+struct ANIMEWORLDRUNNER_API FPerformanceGovernorSettings
+{
+    float TargetFrameTimeMs = 16.67f;
+
+    // Downshift when p95 exceeds Target * DownshiftRatio, upshift when it drops below Target * UpshiftRatio
+    float DownshiftRatio = 1.05f;
+    float UpshiftRatio = 0.8f;
+
+    // How long the condition must hold before acting (seconds)
+    float DownshiftHoldSeconds = 1.0f;
+    float UpshiftHoldSeconds = 5.0f;
+
+    // Minimum time between two decisions, so each step can show up in the percentiles
+    float CooldownSeconds = 2.0f;
+};
+
+struct ANIMEWORLDRUNNER_API FPerformanceGovernorSimulationReport
+{
+    int32 NumFrames = 0;
+    float DurationSeconds = 0.0f;
+    int32 Downshifts = 0;
+    int32 Upshifts = 0;
+    int32 FinalLevel = 0;
+    int32 MaxLevel = 0;
+
+    // Share of frames over the frame budget, after the governor reacted
+    float OverBudgetPercent = 0.0f;
+};
+
+/**
+ * Scales the game's own budgets (material update rate, UI animation rate, effects,
+ * environment instances) from the p95 frame time, one step at a time.
+ *
+ * Steps are taken round robin over the budgets in priority order, so the first pass
+ * costs a little of everything cheap before anything visible is reduced further.
+ * Upshifting walks the same ladder backwards. Works on numbers only.
+ */
+class ANIMEWORLDRUNNER_API FPerformanceGovernor
+{
+public:
+    FPerformanceGovernor();
+
+    void Configure(const FPerformanceGovernorSettings& InSettings);
+    const FPerformanceGovernorSettings& GetSettings() const { return Settings; }
+
+    void Reset();
+
+    // Feeds the current p95 frame time; returns true when the budgets changed
+    bool Update(float P95FrameTimeMs, float DeltaSeconds);
+
+    // While set, the governor treats frames as over budget and never upshifts
+    void SetMemoryPressure(bool bInMemoryPressure) { bMemoryPressure = bInMemoryPressure; }
+    bool HasMemoryPressure() const { return bMemoryPressure; }
+
+    int32 GetLevel() const { return Level; }
+    int32 GetNumLevels() const { return Ladder.Num(); }
+    int32 GetBudgetLevel(EGovernedBudget Budget) const { return BudgetLevels[(int32)Budget]; }
+    const FPerformanceBudgets& GetBudgets() const { return Budgets; }
+
+    static const TCHAR* GetBudgetName(EGovernedBudget Budget);
+
+    /**
+     * Runs the governor against a frame time trace recorded at full budgets.
+     * Each step taken is modelled as removing StepCostFraction of the frame time.
+     */
+    static FPerformanceGovernorSimulationReport Simulate(const FPerformanceGovernorSettings& InSettings, const TArray<float>& FrameTimesMs, float StepCostFraction = 0.04f);
+
+private:
+    void BuildLadder();
+    void UpdateBudgets();
+    void LogDecision(const TCHAR* Direction, EGovernedBudget Budget, float P95FrameTimeMs) const;
+
+    FPerformanceGovernorSettings Settings;
+
+    // Budget moved by each step, ladder position Level is the next one to take
+    TArray<EGovernedBudget> Ladder;
+    int32 Level;
+    int32 BudgetLevels[(int32)EGovernedBudget::Count];
+
+    float OverBudgetTime;
+    float UnderBudgetTime;
+    float CooldownRemaining;
+    bool bMemoryPressure;
+
+    FPerformanceBudgets Budgets;
+};
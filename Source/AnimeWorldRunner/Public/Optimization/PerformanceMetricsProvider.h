@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerformanceMetricsProvider.generated.h"
+
+class UWorld;
+
+UENUM(BlueprintType)
+enum class EPerformanceMetricsSource : uint8
+{
+    None        UMETA(DisplayName = "None"),
+    RHI         UMETA(DisplayName = "RHI Counters"),
+    Fallback    UMETA(DisplayName = "Game Counters"),
+    Mock        UMETA(DisplayName = "Mock")
+};
+
+// One sample of render side costs; plain values so Blueprint reads it without allocating
+USTRUCT(BlueprintType)
+struct FRenderMetricsSample
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    int32 DrawCalls;
+
+    // Triangles submitted last frame (estimated from mesh LOD0 with the fallback provider)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    int32 PrimitivesDrawn;
+
+    // Milliseconds; GPU time is 0 when the RHI does not report it
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float GPUTimeMs;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float GameThreadMs;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    float RenderThreadMs;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metrics")
+    EPerformanceMetricsSource Source;
+
+    FRenderMetricsSample()
+    {
+        DrawCalls = 0;
+        PrimitivesDrawn = 0;
+        GPUTimeMs = 0.0f;
+        GameThreadMs = 0.0f;
+        RenderThreadMs = 0.0f;
+        Source = EPerformanceMetricsSource::None;
+    }
+};
+
+/**
+ * Source of draw call, primitive and thread timings for the optimization manager
+ * and the HUD. The active provider reads RHI counters, or counts our own visible
+ * components under -nullrhi; tests install a mock with SetOverride.
+ */
+class ANIMEWORLDRUNNER_API IPerformanceMetricsProvider
+{
+public:
+    virtual ~IPerformanceMetricsProvider() {}
+
+    virtual void Sample(const UWorld* World, FRenderMetricsSample& OutSample) = 0;
+
+    virtual const TCHAR* GetName() const = 0;
+
+    // Override if one is installed, otherwise the RHI provider (fallback provider with a null RHI)
+    static IPerformanceMetricsProvider& Get();
+
+    // Pass nullptr to return to the engine providers
+    static void SetOverride(const TSharedPtr<IPerformanceMetricsProvider>& Provider);
+
+    // Samples the active provider at most once per frame; safe to call from Blueprint every tick
+    static const FRenderMetricsSample& GetFrameSample(const UWorld* World);
+
+private:
+    static TSharedPtr<IPerformanceMetricsProvider>& AccessOverride();
+};
+
+// Last frame's RHI counters plus the engine's thread and GPU timings
+class ANIMEWORLDRUNNER_API FRHIMetricsProvider : public IPerformanceMetricsProvider
+{
+public:
+    virtual void Sample(const UWorld* World, FRenderMetricsSample& OutSample) override;
+    virtual const TCHAR* GetName() const override { return TEXT("RHI"); }
+};
+
+// Visible primitive components and submitted ISM instances of one world; used when nothing is rendered
+class ANIMEWORLDRUNNER_API FFallbackMetricsProvider : public IPerformanceMetricsProvider
+{
+public:
+    virtual void Sample(const UWorld* World, FRenderMetricsSample& OutSample) override;
+    virtual const TCHAR* GetName() const override { return TEXT("Fallback"); }
+};
+
+// Replays scripted samples, looping over them; returns an empty sample when none are set
+class ANIMEWORLDRUNNER_API FMockMetricsProvider : public IPerformanceMetricsProvider
+{
+public:
+    FMockMetricsProvider();
+
+    void SetSample(const FRenderMetricsSample& InSample);
+    void AddSample(const FRenderMetricsSample& InSample);
+    void Reset();
+
+    int32 GetSampleCount() const { return NumSampled; }
+
+    virtual void Sample(const UWorld* World, FRenderMetricsSample& OutSample) override;
+    virtual const TCHAR* GetName() const override { return TEXT("Mock"); }
+
+private:
+    TArray<FRenderMetricsSample> Samples;
+    int32 NextSample;
+    int32 NumSampled;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IConsoleVariable;
+
+/**
+ * Desired console variable values for one quality switch.
+ * Setting the same variable twice keeps the last value, matching the order the
+ * old Exec based code applied its commands in.
+ */
+struct ANIMEWORLDRUNNER_API FQualityProfile
+{
+    void Set(const TCHAR* Name, float Value);
+    void Set(const TCHAR* Name, int32 Value) { Set(Name, static_cast<float>(Value)); }
+    void Set(const TCHAR* Name, bool bValue) { Set(Name, bValue ? 1.0f : 0.0f); }
+
+    int32 Num() const { return Values.Num(); }
+    void Reset() { Values.Reset(); }
+
+    TMap<FName, float> Values;
+};
+
+/**
+ * Applies quality profiles through console variable handles resolved once,
+ * writing only the entries whose value differs from the current one.
+ */
+class ANIMEWORLDRUNNER_API FQualityProfileApplier
+{
+public:
+    // Returns the number of variables that actually changed
+    int32 Apply(const FQualityProfile& Profile, const TCHAR* Reason = nullptr);
+
+    // Convenience for single variable writes outside of a profile switch
+    bool ApplySingle(const TCHAR* Name, float Value);
+
+    int32 GetTotalWrites() const { return TotalWrites; }
+
+private:
+    IConsoleVariable* FindHandle(FName Name);
+    static bool NeedsUpdate(IConsoleVariable* Variable, float Value);
+    static void Write(IConsoleVariable* Variable, float Value);
+
+    // Missing variables are cached as nullptr so they are only looked up once
+    TMap<FName, IConsoleVariable*> Handles;
+
+    TArray<TPair<IConsoleVariable*, float>> PendingWrites;
+
+    int32 TotalWrites = 0;
+};
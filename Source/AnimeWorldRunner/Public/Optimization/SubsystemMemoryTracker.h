@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "SubsystemMemoryTracker.generated.h"
+
+class UWorld;
+
+UENUM(BlueprintType)
+enum class EMemoryBudgetCategory : uint8
+{
+    Environment     UMETA(DisplayName = "Environment Instances"),
+    ChunkData       UMETA(DisplayName = "Chunk Data"),
+    Effects         UMETA(DisplayName = "Effect Components"),
+    Materials       UMETA(DisplayName = "Dynamic Materials"),
+    UI              UMETA(DisplayName = "UI Widgets"),
+    Count           UMETA(Hidden)
+};
+
+// LLM tags, children of an AWR parent tag so `-llm` captures and Insights memory traces show them as AWR/<Subsystem>
+LLM_DECLARE_TAG_API(AWR_Environment, ANIMEWORLDRUNNER_API);
+LLM_DECLARE_TAG_API(AWR_ChunkData, ANIMEWORLDRUNNER_API);
+LLM_DECLARE_TAG_API(AWR_Effects, ANIMEWORLDRUNNER_API);
+LLM_DECLARE_TAG_API(AWR_Materials, ANIMEWORLDRUNNER_API);
+LLM_DECLARE_TAG_API(AWR_UI, ANIMEWORLDRUNNER_API);
+
+#define AWR_LLM_SCOPE(Category) LLM_SCOPE_BYTAG(AWR_##Category)
+
+// Memory each subsystem may use on a device profile (megabytes, 0 = unlimited)
+USTRUCT(BlueprintType)
+struct FSubsystemMemoryBudgets
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float EnvironmentMB;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float ChunkDataMB;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float EffectsMB;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float MaterialsMB;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Memory")
+    float UIMB;
+
+    FSubsystemMemoryBudgets()
+    {
+        EnvironmentMB = 48.0f;
+        ChunkDataMB = 8.0f;
+        EffectsMB = 24.0f;
+        MaterialsMB = 16.0f;
+        UIMB = 32.0f;
+    }
+
+    float GetBudgetMB(EMemoryBudgetCategory Category) const;
+};
+
+/**
+ * Samples memory per subsystem and keeps the history for soak reports. Uses the
+ * LLM tag totals when the game runs with -llm, otherwise each subsystem's own
+ * accounting of its instances, components, materials and widgets. Subsystems report
+ * exclusive resource sizes, so templates, textures and parent materials shared by
+ * many instances are not counted once per instance.
+ */
+class ANIMEWORLDRUNNER_API FSubsystemMemoryTracker
+{
+public:
+    FSubsystemMemoryTracker();
+
+    void Sample(const UWorld* World, double TimeSeconds);
+
+    // True while any category is over budget; logs when a category crosses its budget
+    bool CheckBudgets(const FSubsystemMemoryBudgets& Budgets);
+
+    int64 GetBytes(EMemoryBudgetCategory Category) const;
+    bool IsOverBudget(EMemoryBudgetCategory Category) const;
+    bool IsUsingLLM() const { return bUsingLLM; }
+    int32 GetNumSamples() const { return History.Num(); }
+
+    // One row per sample with megabytes per category, followed by the budgets
+    bool WriteSoakReport(const FString& FilePath, const FSubsystemMemoryBudgets& Budgets) const;
+
+    static const TCHAR* GetCategoryName(EMemoryBudgetCategory Category);
+
+private:
+    // Roughly four hours at the default five second sample interval
+    static constexpr int32 MaxHistory = 2880;
+
+    struct FMemorySample
+    {
+        double TimeSeconds;
+        int64 Bytes[(int32)EMemoryBudgetCategory::Count];
+    };
+
+    static bool SampleLLM(FMemorySample& OutSample);
+    static void SampleSubsystems(const UWorld* World, FMemorySample& OutSample);
+
+    const FMemorySample& GetSample(int32 Age) const;
+
+    // Ring of the last MaxHistory samples; NextSample is overwritten once it is full
+    TArray<FMemorySample> History;
+    int32 NextSample;
+    uint32 OverBudgetMask;
+    bool bUsingLLM;
+};
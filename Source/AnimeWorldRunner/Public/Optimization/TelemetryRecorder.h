@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Pipe.h"
+
+// One second of a run as written to Saved/Telemetry
+struct ANIMEWORLDRUNNER_API FTelemetryRow
+{
+    float TimeSeconds = 0.0f;
+    float TargetFrameMs = 0.0f;
+    float AverageFrameMs = 0.0f;
+    float P50FrameMs = 0.0f;
+    float P95FrameMs = 0.0f;
+    float P99FrameMs = 0.0f;
+    float MaxFrameMs = 0.0f;
+    float ResolutionScale = 1.0f;
+    int32 QualityLevel = 0;
+    int32 GovernorLevel = 0;
+    int32 DrawCalls = 0;
+    int32 ISMInstances = 0;
+    int32 ActiveEffects = 0;
+    float MemoryMB = 0.0f;
+    float RunDistance = 0.0f;
+    int32 ActiveMIDs = 0;
+    int32 MaterialUsers = 0;
+};
+
+/**
+ * Collects one telemetry row per second and appends them to a CSV in Saved/Telemetry.
+ * The game thread only copies rows into a buffer; formatting, writing, file rotation
+ * and pruning of old sessions run in order on a background pipe.
+ */
+class ANIMEWORLDRUNNER_API FTelemetryRecorder
+{
+public:
+    FTelemetryRecorder();
+    ~FTelemetryRecorder();
+
+    void BeginSession(const FString& DeviceName);
+    void AddRow(const FTelemetryRow& Row);
+
+    // Hands buffered rows to the writer; called automatically every FlushRowCount rows
+    void Flush();
+
+    // Flushes and waits for the writer
+    void EndSession();
+
+    bool IsRecording() const { return bRecording; }
+
+    static FString GetTelemetryDir();
+    static bool IsEnabled();
+
+private:
+    static constexpr int32 FlushRowCount = 10;
+
+    // Runs on the writer pipe
+    void WriteRows(const TArray<FTelemetryRow>& Rows);
+    FString OpenFile();
+    static void PruneOldFiles();
+
+    UE::Tasks::FPipe WriterPipe;
+    UE::Tasks::FTask LastWrite;
+
+    TArray<FTelemetryRow> PendingRows;
+    bool bRecording;
+
+    // Writer state, only touched on the pipe
+    FString DeviceName;
+    FString SessionName;
+    FString FilePath;
+    int64 FileBytes;
+    int32 FilePart;
+};
+
+/**
+ * Turns telemetry logs into one summary row per device: run time, frame time
+ * percentiles, time over the frame budget, resolution, quality and memory.
+ */
+class ANIMEWORLDRUNNER_API FTelemetrySummarizer
+{
+public:
+    // Summarizes every CSV in Directory (Saved/Telemetry by default) into OutputPath; returns the number of logs read
+    static int32 SummarizeDirectory(const FString& Directory, const FString& OutputPath);
+};
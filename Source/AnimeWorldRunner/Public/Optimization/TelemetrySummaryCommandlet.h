@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TelemetrySummaryCommandlet.generated.h"
+
+/**
+ * Summarizes telemetry logs collected from devices without starting the game:
+ * UnrealEditor-Cmd AnimeWorldRunner -run=TelemetrySummary -Dir=<logs> -Out=<Summary.csv>
+ */
+UCLASS()
+class ANIMEWORLDRUNNER_API UTelemetrySummaryCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UTelemetrySummaryCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -213,6 +213,13 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Anime UI")
     void SetUIScale(float Scale);
 
+    // Continuous UI animation updates per second, 0 updates every frame (set by the performance governor)
+    UFUNCTION(BlueprintCallable, Category = "Anime UI")
+    void SetAnimationUpdateRate(float UpdatesPerSecond);
+
+    // Exclusive memory of the widgets this manager created (bytes)
+    int64 GetWidgetMemoryBytes() const;
+
     // Touch Controls
     UFUNCTION(BlueprintCallable, Category = "Anime UI")
     void ShowVirtualControls(bool bShow);
@@ -270,6 +277,9 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mobile")
     bool bShowVirtualControls;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mobile")
+    float AnimationUpdateRate;
+
     // Virtual Controls
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Virtual Controls")
     UUserWidget* VirtualJoystickWidget;
@@ -309,4 +319,7 @@ private:
     // Notification management
     float NotificationTimer;
     float NotificationSpacing;
+
+    // Time accumulated since the last continuous animation update
+    float AnimationUpdateTimer;
 };
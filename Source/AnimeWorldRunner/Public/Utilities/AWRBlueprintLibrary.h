@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Engine/Engine.h"
+#include "Optimization/PerformanceMetricsProvider.h"
 #include "AWRBlueprintLibrary.generated.h"
 
 UCLASS()
@@ -79,4 +80,8 @@ public:
     
     UFUNCTION(BlueprintPure, Category = "Performance")
     static float GetMemoryUsageMB();
+    
+    // Draw calls, primitives and thread/GPU timings, sampled once per frame
+    UFUNCTION(BlueprintPure, Category = "Performance", meta = (WorldContext = "WorldContextObject"))
+    static FRenderMetricsSample GetRenderMetrics(const UObject* WorldContextObject);
 };